@@ -0,0 +1,255 @@
+#include "BatchOperations.h"
+
+#include "Console.h"
+#include "ResourceOperations.h"
+
+#include "TGXFile.h"
+#include "GM1File.h"
+
+#include <set>
+#include <numeric>
+#include <algorithm>
+#include <sstream>
+#include <latch>
+
+namespace BatchOperations
+{
+  static uintmax_t getFolderFileSize(const std::filesystem::path& folder)
+  {
+    uintmax_t size{ 0 };
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ folder })
+    {
+      if (entry.is_regular_file())
+      {
+        size += entry.file_size();
+      }
+    }
+    return size;
+  }
+
+  std::vector<BatchJob> collectJobs(BatchOperationType type, const std::filesystem::path& sourceFolder,
+    const std::filesystem::path& targetFolder, const TgxCoderInstruction& instructions, const ExtractOptions& extractOptions, TgxTextMode tgxTextMode)
+  {
+    Log(LogLevel::INFO, "Try collecting resources in provided folder.");
+    std::vector<BatchJob> jobs{};
+    std::set<std::filesystem::path> usedTargets{};
+    const auto addJob{ [&](const std::filesystem::path& source, std::filesystem::path&& target, uintmax_t workSize)
+      {
+        if (!target.empty() && !usedTargets.insert(target).second)
+        {
+          Log(LogLevel::WARNING, "Target '{}' is already used by another resource. Skipping '{}'.", target.string(), source.string());
+          return;
+        }
+        jobs.emplace_back(type, source, std::move(target), instructions, extractOptions, tgxTextMode, workSize);
+      }
+    };
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ sourceFolder })
+    {
+      const std::filesystem::path& source{ entry.path() };
+      if (type == BatchOperationType::PACK)
+      {
+        if (!entry.is_directory())
+        {
+          continue;
+        }
+        const ResourceOperations::PathNameType resourceType{ ResourceOperations::determineRawResourceType(source) };
+        if (resourceType == ResourceOperations::PathNameType::UNKNOWN)
+        {
+          continue;
+        }
+        std::filesystem::path target{ targetFolder / std::filesystem::relative(source, sourceFolder) };
+        target += resourceType == ResourceOperations::PathNameType::TGX_FILE ? TGXFile::FILE_EXTENSION : GM1File::FILE_EXTENSION;
+        addJob(source, std::move(target), getFolderFileSize(source));
+        continue;
+      }
+
+      if (!entry.is_regular_file())
+      {
+        continue;
+      }
+      const ResourceOperations::PathNameType resourceType{ ResourceOperations::determinePathNameType(source) };
+      if (resourceType != ResourceOperations::PathNameType::TGX_FILE && resourceType != ResourceOperations::PathNameType::GM1_FILE)
+      {
+        continue;
+      }
+      if (type == BatchOperationType::TEST || type == BatchOperationType::ROUNDTRIP)
+      {
+        addJob(source, {}, entry.file_size());
+        continue;
+      }
+      std::filesystem::path target{ targetFolder / std::filesystem::relative(source, sourceFolder) };
+      target.replace_extension();
+      addJob(source, std::move(target), entry.file_size());
+    }
+
+    // done upfront, since parallel creation of shared parents could collide
+    for (const BatchJob& job : jobs)
+    {
+      if (!job.target.empty())
+      {
+        std::filesystem::create_directories(job.target.parent_path());
+      }
+    }
+
+    Log(LogLevel::INFO, "Collected {} resources.", jobs.size());
+    return jobs;
+  }
+
+  bool executeJob(const BatchJob& job, const ConversionCache::Cache* cache, TgxDetailedAnalysis* detailedAnalysis,
+    ResourceCache::Cache* resourceCache)
+  {
+    switch (job.type)
+    {
+    case BatchOperationType::TEST:
+      return ResourceOperations::testResource(job.source, job.instructions, job.tgxTextMode, detailedAnalysis, resourceCache);
+    case BatchOperationType::EXTRACT:
+      return ResourceOperations::extractResource(job.source, job.target, job.instructions, job.extractOptions, cache, resourceCache);
+    case BatchOperationType::PACK:
+      return ResourceOperations::packResource(job.source, job.target, job.instructions, cache);
+    case BatchOperationType::ROUNDTRIP:
+      return ResourceOperations::roundTripResource(job.source, job.instructions, resourceCache);
+
+    default:
+      Log(LogLevel::ERROR, "Batch job has unknown operation type.");
+      return false;
+    }
+  }
+
+  // redirects the output of the current thread, until it is destroyed, also if the job or its logging throws
+  class ThreadOutRedirectScope
+  {
+  private:
+    std::ostream* previous;
+  public:
+    explicit ThreadOutRedirectScope(std::ostream& out) : previous{ threadOutRedirect }
+    {
+      threadOutRedirect = &out;
+    }
+
+    ~ThreadOutRedirectScope()
+    {
+      threadOutRedirect = previous;
+    }
+
+    ThreadOutRedirectScope(const ThreadOutRedirectScope&) = delete;
+    ThreadOutRedirectScope& operator=(const ThreadOutRedirectScope&) = delete;
+  };
+
+  BatchJobResult runJob(const BatchJob& job, const ConversionCache::Cache* cache, ResourceCache::Cache* resourceCache)
+  {
+    BatchJobResult result{};
+    std::ostringstream output{};
+    {
+      const ThreadOutRedirectScope redirectScope{ output };
+      const auto start{ std::chrono::steady_clock::now() };
+      try
+      {
+        result.success = executeJob(job, cache, &result.detailedAnalysis, resourceCache);
+      }
+      catch (const std::exception& e)
+      {
+        Log(LogLevel::ERROR, "Encountered exception while processing '{}': {}", job.source.string(), e.what());
+        result.success = false;
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Encountered unknown exception while processing '{}'.", job.source.string());
+        result.success = false;
+      }
+      result.duration = std::chrono::steady_clock::now() - start;
+    }
+    result.output = std::move(output).str();
+    return result;
+  }
+
+  // counts the latch down when the task ends, also if it throws, so the waiting batch can not hang
+  class LatchCountDownScope
+  {
+  private:
+    std::latch& latch;
+  public:
+    explicit LatchCountDownScope(std::latch& latch) : latch{ latch }
+    {
+    }
+
+    ~LatchCountDownScope()
+    {
+      latch.count_down();
+    }
+
+    LatchCountDownScope(const LatchCountDownScope&) = delete;
+    LatchCountDownScope& operator=(const LatchCountDownScope&) = delete;
+  };
+
+  std::vector<BatchJobResult> runJobs(TaskPool& pool, std::span<const BatchJob> jobs, const ConversionCache::Cache* cache)
+  {
+    std::vector<BatchJobResult> results(jobs.size());
+
+    std::vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [jobs](size_t a, size_t b) { return jobs[a].workSize > jobs[b].workSize; });
+
+    // own latch, since the pool might be shared with other work
+    std::latch jobsDone{ static_cast<std::ptrdiff_t>(jobs.size()) };
+    std::vector<std::function<void()>> tasks{};
+    tasks.reserve(jobs.size());
+    for (const size_t index : order)
+    {
+      tasks.emplace_back([jobs, cache, &results, &jobsDone, index]()
+        {
+          const LatchCountDownScope countDownScope{ jobsDone };
+          results[index] = runJob(jobs[index], cache);
+        });
+    }
+    pool.submitBatch(std::move(tasks));
+    jobsDone.wait();
+    return results;
+  }
+
+  size_t reportResults(std::span<const BatchJob> jobs, std::span<const BatchJobResult> results)
+  {
+    size_t failedJobs{ 0 };
+    std::chrono::steady_clock::duration summedDuration{ 0 };
+    TgxDetailedAnalysis summedAnalysis{};
+    Out("### Batch results ###\n");
+    for (size_t i{ 0 }; i < jobs.size(); ++i)
+    {
+      const BatchJob& job{ jobs[i] };
+      const BatchJobResult& result{ results[i] };
+      summedDuration += result.duration;
+      if (!result.success)
+      {
+        ++failedJobs;
+      }
+      else if (result.detailedAnalysis.imageCount > 0)
+      {
+        TgxDetailedAnalysis fileAnalysis{ result.detailedAnalysis };
+        fileAnalysis.worstRowSource = std::format("'{}'{}{}", job.source.string(), fileAnalysis.worstRowSource.empty() ? "" : " ",
+          fileAnalysis.worstRowSource);
+        addTgxDetailedAnalysis(summedAnalysis, fileAnalysis);
+      }
+
+      const std::chrono::duration<double, std::milli> milliseconds{ result.duration };
+      if (job.target.empty())
+      {
+        Out("[{}] {:10.3f} ms '{}'\n", result.success ? " OK " : "FAIL", milliseconds.count(), job.source.string());
+      }
+      else
+      {
+        Out("[{}] {:10.3f} ms '{}' -> '{}'\n", result.success ? " OK " : "FAIL", milliseconds.count(), job.source.string(), job.target.string());
+      }
+      if (!result.success && !result.output.empty())
+      {
+        Out("{}\n", result.output);
+      }
+    }
+    const std::chrono::duration<double> seconds{ summedDuration };
+    Out("\nProcessed: {}\nFailed: {}\nSummed job time: {:.3f} s\n", jobs.size(), failedJobs, seconds.count());
+    if (summedAnalysis.imageCount > 0)
+    {
+      Out("\n### Detailed analysis of all tested files ###\n{}\n", summedAnalysis);
+    }
+    return failedJobs;
+  }
+}
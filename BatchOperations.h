@@ -0,0 +1,67 @@
+#pragma once
+
+#include "TGXCoder.h"
+#include "TaskPool.h"
+#include "ConversionCache.h"
+#include "ResourceCache.h"
+#include "ExtractOptions.h"
+
+#include <filesystem>
+#include <vector>
+#include <span>
+#include <string>
+#include <chrono>
+
+// runs many single file operations inside one process on a task pool
+
+namespace BatchOperations
+{
+  enum class BatchOperationType
+  {
+    TEST,
+    EXTRACT,
+    PACK,
+    ROUNDTRIP,
+  };
+
+  struct BatchJob
+  {
+    BatchOperationType type;
+    std::filesystem::path source;
+    std::filesystem::path target; // unused for tests and round trips
+    TgxCoderInstruction instructions;
+    ExtractOptions extractOptions; // only used by extract
+    TgxTextMode tgxTextMode;
+    uintmax_t workSize; // bigger jobs are started first
+  };
+
+  struct BatchJobResult
+  {
+    bool success;
+    std::chrono::steady_clock::duration duration;
+    std::string output; // output the job produced, collected to not mix it with other jobs
+    TgxDetailedAnalysis detailedAnalysis; // only filled by successful tests
+  };
+
+  // walks the source folder recursively and pairs every resource with its target
+  // - test, round trip and extract: every TGX and GM1 file, extract targets mirror the source structure with the file name as folder
+  // - pack: every folder that contains a resource meta file with the same name, the target gets the fitting extension
+  // the parent folders of all targets are created beforehand
+  std::vector<BatchJob> collectJobs(BatchOperationType type, const std::filesystem::path& sourceFolder,
+    const std::filesystem::path& targetFolder, const TgxCoderInstruction& instructions, const ExtractOptions& extractOptions, TgxTextMode tgxTextMode);
+
+  // the cache is optional and only used by extract and pack, the detailed analysis is optional and only filled by tests
+  // the resource cache is optional and used by the operations that load TGX and GM1 files
+  bool executeJob(const BatchJob& job, const ConversionCache::Cache* cache, TgxDetailedAnalysis* detailedAnalysis = nullptr,
+    ResourceCache::Cache* resourceCache = nullptr);
+
+  // executes the job on the current thread and collects its output, errors of the job are logged into the output
+  BatchJobResult runJob(const BatchJob& job, const ConversionCache::Cache* cache, ResourceCache::Cache* resourceCache = nullptr);
+
+  // runs the jobs biggest first on the pool, the results have the order of the given jobs
+  std::vector<BatchJobResult> runJobs(TaskPool& pool, std::span<const BatchJob> jobs, const ConversionCache::Cache* cache);
+
+  // prints a result line per job and the collected output of failed jobs, returns the number of failed jobs
+  // if tests were run, the detailed analysis summed over all tested files follows
+  size_t reportResults(std::span<const BatchJob> jobs, std::span<const BatchJobResult> results);
+}
@@ -0,0 +1,347 @@
+#include "Benchmark.h"
+
+#include "Console.h"
+#include "Gm1Coder.h"
+#include "TGXFile.h"
+#include "GM1File.h"
+#include "ResourceOperations.h"
+
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Benchmark
+{
+  template<typename Func>
+  static std::chrono::nanoseconds measure(Func&& func)
+  {
+    const auto start{ std::chrono::steady_clock::now() };
+    func();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  }
+
+  static void checkTgxResult(const TgxCoderResult result, const TgxCoderResult expected)
+  {
+    if (result != expected)
+    {
+      throw std::runtime_error{ getTgxResultDescription(result) };
+    }
+  }
+
+  static void checkGm1Result(const Gm1CoderResult result, const Gm1CoderResult expected)
+  {
+    if (result != expected)
+    {
+      throw std::runtime_error{ getGm1ResultDescription(result) };
+    }
+  }
+
+  // buffers reused across the images of one resource
+  struct BenchmarkBuffers
+  {
+    std::vector<uint16_t> raw;
+    std::vector<uint8_t> encoded;
+  };
+
+  static void benchmarkTgxData(BenchmarkReport& report, std::string_view category, BenchmarkBuffers& buffers, const TgxColorType colorType,
+    std::span<uint8_t> data, const int32_t width, const int32_t height, const BenchmarkSettings& settings)
+  {
+    const uint64_t pixels{ static_cast<uint64_t>(width) * height };
+    const TgxCoderTgxInfo tgxInfo{
+      .colorType{ colorType },
+      .data{ data.data() },
+      .dataSize{ static_cast<uint32_t>(data.size()) },
+      .tgxWidth{ width },
+      .tgxHeight{ height }
+    };
+    buffers.raw.resize(pixels);
+    const TgxCoderRawInfo rawInfo{
+      .data{ buffers.raw.data() },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 }
+    };
+
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      TgxAnalysis analysis{};
+      TgxCoderResult result{};
+      report.addSample(category, OPERATION::TGX_ANALYZE, measure([&]() { result = analyzeTgxToRaw(&tgxInfo, &analysis); }), data.size(), pixels);
+      checkTgxResult(result, TgxCoderResult::SUCCESS);
+
+      std::fill(buffers.raw.begin(), buffers.raw.end(), settings.instructions.transparentPixelRawColor);
+      TgxCoderRawInfo decodeRawInfo{ rawInfo };
+      report.addSample(category, OPERATION::TGX_DECODE, measure([&]() { result = decodeTgxToRaw(&tgxInfo, &decodeRawInfo, nullptr); }), data.size(), pixels);
+      checkTgxResult(result, TgxCoderResult::SUCCESS);
+
+      // like the file handling, the encoding contains the size run
+      TgxCoderTgxInfo encodeInfo{ .colorType{ colorType }, .data{ nullptr }, .dataSize{ 0 }, .tgxWidth{ width }, .tgxHeight{ height } };
+      TgxCoderResult sizeResult{};
+      const std::chrono::nanoseconds encodeDuration{ measure([&]()
+        {
+          sizeResult = encodeRawToTgx(&rawInfo, &encodeInfo, &settings.instructions);
+          if (sizeResult != TgxCoderResult::FILLED_ENCODING_SIZE)
+          {
+            return;
+          }
+          buffers.encoded.resize(encodeInfo.dataSize);
+          encodeInfo.data = buffers.encoded.data();
+          result = encodeRawToTgx(&rawInfo, &encodeInfo, &settings.instructions);
+        }) };
+      checkTgxResult(sizeResult, TgxCoderResult::FILLED_ENCODING_SIZE);
+      checkTgxResult(result, TgxCoderResult::SUCCESS);
+      report.addSample(category, OPERATION::TGX_ENCODE, encodeDuration, encodeInfo.dataSize, pixels);
+    }
+  }
+
+  static void benchmarkTile(BenchmarkReport& report, std::string_view category, BenchmarkBuffers& buffers,
+    const uint8_t* tile, const BenchmarkSettings& settings)
+  {
+    constexpr uint64_t pixels{ TILE_WIDTH * TILE_HEIGHT };
+    buffers.raw.assign(pixels, settings.instructions.transparentPixelRawColor);
+    buffers.encoded.resize(TILE_BYTE_SIZE);
+    Gm1CoderRawInfo rawInfo{
+      .raw{ buffers.raw.data() },
+      .rawWidth{ TILE_WIDTH },
+      .rawHeight{ TILE_HEIGHT },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      Gm1CoderResult result{};
+      report.addSample(category, OPERATION::TILE_DECODE,
+        measure([&]() { result = decodeTileToRaw(reinterpret_cast<const uint16_t*>(tile), &rawInfo); }), TILE_BYTE_SIZE, pixels);
+      checkGm1Result(result, Gm1CoderResult::SUCCESS);
+
+      report.addSample(category, OPERATION::TILE_ENCODE,
+        measure([&]() { result = encodeRawToTile(&rawInfo, reinterpret_cast<uint16_t*>(buffers.encoded.data())); }), TILE_BYTE_SIZE, pixels);
+      checkGm1Result(result, Gm1CoderResult::SUCCESS);
+    }
+  }
+
+  static void benchmarkUncompressed(BenchmarkReport& report, std::string_view category, BenchmarkBuffers& buffers,
+    std::span<uint8_t> data, const int32_t width, const int32_t height, const BenchmarkSettings& settings)
+  {
+    const uint64_t pixels{ static_cast<uint64_t>(width) * height };
+    const uint16_t transparentColor{ settings.instructions.transparentPixelRawColor };
+    const Gm1CoderDataInfo dataInfo{
+      .data{ data.data() },
+      .dataSize{ static_cast<uint32_t>(data.size()) },
+      .dataWidth{ width },
+      .dataHeight{ height },
+    };
+    buffers.raw.resize(pixels);
+    Gm1CoderRawInfo rawInfo{
+      .raw{ buffers.raw.data() },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      std::fill(buffers.raw.begin(), buffers.raw.end(), transparentColor);
+      Gm1CoderResult result{};
+      report.addSample(category, OPERATION::UNCOMPRESSED_DECODE,
+        measure([&]() { result = copyUncompressedToRaw(&dataInfo, &rawInfo, transparentColor); }), data.size(), pixels);
+      checkGm1Result(result, Gm1CoderResult::SUCCESS);
+
+      Gm1CoderDataInfo encodeInfo{ .data{ nullptr }, .dataSize{ 0 }, .dataWidth{ width }, .dataHeight{ height } };
+      Gm1CoderResult sizeResult{};
+      const std::chrono::nanoseconds encodeDuration{ measure([&]()
+        {
+          sizeResult = copyRawToUncompressed(&rawInfo, &encodeInfo, transparentColor);
+          if (sizeResult != Gm1CoderResult::FILLED_ENCODING_SIZE)
+          {
+            return;
+          }
+          buffers.encoded.resize(encodeInfo.dataSize);
+          encodeInfo.data = buffers.encoded.data();
+          result = copyRawToUncompressed(&rawInfo, &encodeInfo, transparentColor);
+        }) };
+      checkGm1Result(sizeResult, Gm1CoderResult::FILLED_ENCODING_SIZE);
+      checkGm1Result(result, Gm1CoderResult::SUCCESS);
+      report.addSample(category, OPERATION::UNCOMPRESSED_ENCODE, encodeDuration, encodeInfo.dataSize, pixels);
+    }
+  }
+
+  static int getProcessId()
+  {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return getpid();
+#endif
+  }
+
+  // the process id keeps concurrent benchmark runs from saving into the same file
+  static std::filesystem::path getTemporarySavePath(const std::filesystem::path& file)
+  {
+    std::filesystem::path temporaryFile{ std::filesystem::temp_directory_path() / std::format("SHCResourceConverterCLI_bench_{}", getProcessId()) };
+    temporaryFile.replace_extension(file.extension());
+    return temporaryFile;
+  }
+
+  static void benchmarkTgxFile(const std::filesystem::path& file, const BenchmarkSettings& settings, BenchmarkReport& report)
+  {
+    const uint64_t fileSize{ std::filesystem::file_size(file) };
+    TGXFile::UniqueTgxResourcePointer resource{};
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      report.addSample(TGX_FILE_CATEGORY, OPERATION::LOAD, measure([&]() { resource = TGXFile::loadTgxResource(file); }), fileSize, 0);
+      if (!resource)
+      {
+        throw std::runtime_error{ "Failed to load TGX file." };
+      }
+    }
+    const uint64_t pixels{ static_cast<uint64_t>(resource->header->width) * resource->header->height };
+
+    BenchmarkBuffers buffers{};
+    benchmarkTgxData(report, TGX_FILE_CATEGORY, buffers, TgxColorType::DEFAULT, std::span<uint8_t>{ resource->imageData, resource->dataSize },
+      resource->header->width, resource->header->height, settings);
+
+    const std::filesystem::path temporaryFile{ getTemporarySavePath(file) };
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      report.addSample(TGX_FILE_CATEGORY, OPERATION::SAVE, measure([&]() { TGXFile::saveTgxResource(temporaryFile, *resource); }), fileSize, pixels);
+    }
+    std::filesystem::remove(temporaryFile);
+  }
+
+  static void benchmarkGm1File(const std::filesystem::path& file, const BenchmarkSettings& settings, BenchmarkReport& report)
+  {
+    const uint64_t fileSize{ std::filesystem::file_size(file) };
+    GM1File::UniqueGm1ResourcePointer resource{};
+    std::chrono::nanoseconds loadDuration{ 0 };
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      loadDuration = measure([&]() { resource = GM1File::loadGm1Resource(file); });
+      if (!resource)
+      {
+        throw std::runtime_error{ "Failed to load GM1 file." };
+      }
+      // the category is only known after the first load, so this is recorded in the loop
+      report.addSample(std::format("{}", resource->gm1Header->info.gm1Type), OPERATION::LOAD, loadDuration, fileSize, 0);
+    }
+
+    const Gm1Type type{ resource->gm1Header->info.gm1Type };
+    const std::string category{ std::format("{}", type) };
+    uint64_t pixels{ 0 };
+    BenchmarkBuffers buffers{};
+    for (size_t i{ 0 }; i < resource->gm1Header->info.numberOfPicturesInFile; ++i)
+    {
+      const Gm1Image& image{ resource->imageHeaders[i] };
+      const std::span<uint8_t> data{ resource->imageData + resource->imageOffsets[i], resource->imageSizes[i] };
+      pixels += static_cast<uint64_t>(image.imageHeader.width) * image.imageHeader.height;
+
+      switch (type)
+      {
+      case Gm1Type::GM1_TYPE_INTERFACE:
+      case Gm1Type::GM1_TYPE_TGX_CONST_SIZE:
+      case Gm1Type::GM1_TYPE_FONT:
+      case Gm1Type::GM1_TYPE_ANIMATIONS:
+        benchmarkTgxData(report, category, buffers, type == Gm1Type::GM1_TYPE_ANIMATIONS ? TgxColorType::INDEXED : TgxColorType::DEFAULT,
+          data, image.imageHeader.width, image.imageHeader.height, settings);
+        break;
+      case Gm1Type::GM1_TYPE_TILES_OBJECT:
+      {
+        if (data.size() < TILE_BYTE_SIZE)
+        {
+          throw std::runtime_error{ "Tile object image is smaller than a tile." };
+        }
+        benchmarkTile(report, category, buffers, data.data(), settings);
+        const Gm1TileObjectImageInfo& tileObjectInfo{ image.imageInfo.tileObjectImageInfo };
+        if (tileObjectInfo.imagePosition != Gm1TileObjectImagePosition::NONE)
+        {
+          benchmarkTgxData(report, category, buffers, TgxColorType::DEFAULT, data.subspan(TILE_BYTE_SIZE),
+            tileObjectInfo.imageWidth, tileObjectInfo.tileOffset + GM1File::TILE_IMAGE_HEIGHT_OFFSET, settings);
+        }
+        break;
+      }
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_1:
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_2:
+        benchmarkUncompressed(report, category, buffers, data, image.imageHeader.width, image.imageHeader.height, settings);
+        break;
+
+      default:
+        throw std::runtime_error{ "Resource has unknown type." };
+      }
+    }
+
+    const std::filesystem::path temporaryFile{ getTemporarySavePath(file) };
+    for (int i{ 0 }; i < settings.iterations; ++i)
+    {
+      report.addSample(category, OPERATION::SAVE, measure([&]() { GM1File::saveGm1Resource(temporaryFile, *resource); }), fileSize, pixels);
+    }
+    std::filesystem::remove(temporaryFile);
+  }
+
+  bool benchmarkFile(const std::filesystem::path& file, const BenchmarkSettings& settings, BenchmarkReport& report)
+  {
+    Log(LogLevel::INFO, "Benchmarking '{}'.", file.string());
+    switch (ResourceOperations::determinePathNameType(file))
+    {
+    case ResourceOperations::PathNameType::TGX_FILE:
+      benchmarkTgxFile(file, settings, report);
+      return true;
+    case ResourceOperations::PathNameType::GM1_FILE:
+      benchmarkGm1File(file, settings, report);
+      return true;
+    default:
+      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
+      return false;
+    }
+  }
+
+
+  void BenchmarkReport::addSample(std::string_view category, std::string_view operation, std::chrono::nanoseconds duration, uint64_t bytes, uint64_t pixels)
+  {
+    OperationStats& operationStats{ stats[{ std::string{ category }, std::string{ operation } }] };
+    operationStats.samples.push_back(duration);
+    operationStats.bytes += bytes;
+    operationStats.pixels += pixels;
+  }
+
+  // nearest rank on sorted samples
+  static double getPercentileMicroseconds(std::span<const std::chrono::nanoseconds> sortedSamples, const int percentile)
+  {
+    const size_t rank{ (sortedSamples.size() * percentile + 99) / 100 };
+    const size_t index{ rank == 0 ? 0 : rank - 1 };
+    return std::chrono::duration<double, std::micro>{ sortedSamples[index] }.count();
+  }
+
+  void BenchmarkReport::print() const
+  {
+    Out("### Benchmark results ###\n");
+    Out("{:<18} {:<20} {:>8} {:>10} {:>12} {:>10} {:>10} {:>10} {:>10}\n",
+      "Category", "Operation", "Samples", "MB/s", "MPixel/s", "p50 us", "p90 us", "p99 us", "max us");
+    for (const auto& [key, operationStats] : stats)
+    {
+      std::vector<std::chrono::nanoseconds> sortedSamples{ operationStats.samples };
+      std::sort(sortedSamples.begin(), sortedSamples.end());
+      std::chrono::nanoseconds total{ 0 };
+      for (const std::chrono::nanoseconds sample : sortedSamples)
+      {
+        total += sample;
+      }
+      const double seconds{ std::chrono::duration<double>{ total }.count() };
+      const double megabytesPerSecond{ seconds > 0.0 ? operationStats.bytes / seconds / (1024.0 * 1024.0) : 0.0 };
+      const double megapixelsPerSecond{ seconds > 0.0 ? operationStats.pixels / seconds / 1'000'000.0 : 0.0 };
+
+      Out("{:<18} {:<20} {:>8} {:>10.2f} {:>12.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}\n",
+        key.first, key.second, sortedSamples.size(), megabytesPerSecond, megapixelsPerSecond,
+        getPercentileMicroseconds(sortedSamples, 50), getPercentileMicroseconds(sortedSamples, 90),
+        getPercentileMicroseconds(sortedSamples, 99), std::chrono::duration<double, std::micro>{ sortedSamples.back() }.count());
+    }
+  }
+}
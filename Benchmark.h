@@ -0,0 +1,60 @@
+#pragma once
+
+#include "TGXCoder.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <chrono>
+
+// measures the coders and the file handling on real resources
+// every image is run through all coder operations of its type for the given number of iterations
+// the categories are the Gm1Types, TGX files use their own category
+
+namespace Benchmark
+{
+  inline constexpr std::string_view TGX_FILE_CATEGORY{ "TGX_FILE" };
+
+  namespace OPERATION
+  {
+    inline constexpr std::string_view LOAD{ "load" };
+    inline constexpr std::string_view SAVE{ "save" };
+    inline constexpr std::string_view TGX_ANALYZE{ "tgx analyze" };
+    inline constexpr std::string_view TGX_DECODE{ "tgx decode" };
+    inline constexpr std::string_view TGX_ENCODE{ "tgx encode" };
+    inline constexpr std::string_view TILE_DECODE{ "tile decode" };
+    inline constexpr std::string_view TILE_ENCODE{ "tile encode" };
+    inline constexpr std::string_view UNCOMPRESSED_DECODE{ "uncompressed decode" };
+    inline constexpr std::string_view UNCOMPRESSED_ENCODE{ "uncompressed encode" };
+  }
+
+  struct BenchmarkSettings
+  {
+    int iterations;
+    TgxCoderInstruction instructions;
+  };
+
+  struct OperationStats
+  {
+    std::vector<std::chrono::nanoseconds> samples;
+    uint64_t bytes{ 0 };
+    uint64_t pixels{ 0 };
+  };
+
+  class BenchmarkReport
+  {
+  private:
+    // category and operation
+    std::map<std::pair<std::string, std::string>, OperationStats> stats;
+  public:
+    void addSample(std::string_view category, std::string_view operation, std::chrono::nanoseconds duration, uint64_t bytes, uint64_t pixels);
+
+    // prints one line per category and operation with MB/s, pixels/s and the latency percentiles of single samples
+    void print() const;
+  };
+
+  // returns false if the file type is not supported, load, save and coder errors are thrown
+  bool benchmarkFile(const std::filesystem::path& file, const BenchmarkSettings& settings, BenchmarkReport& report);
+}
@@ -0,0 +1,174 @@
+#include "CanvasHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace CanvasHash
+{
+  static constexpr uint64_t PRIME_1{ 11400714785074694791ull };
+  static constexpr uint64_t PRIME_2{ 14029467366897019727ull };
+  static constexpr uint64_t PRIME_3{ 1609587929392839161ull };
+  static constexpr uint64_t PRIME_4{ 9650029242287828579ull };
+  static constexpr uint64_t PRIME_5{ 2870177450012600261ull };
+
+  // the canvas files are little endian, so the values are read as such on the supported platforms
+  static uint64_t read64(const uint8_t* data)
+  {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  static uint32_t read32(const uint8_t* data)
+  {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  static uint64_t roundLane(uint64_t lane, const uint64_t input)
+  {
+    lane += input * PRIME_2;
+    lane = std::rotl(lane, 31);
+    return lane * PRIME_1;
+  }
+
+  static uint64_t mergeRound(uint64_t hash, const uint64_t lane)
+  {
+    hash ^= roundLane(0, lane);
+    return hash * PRIME_1 + PRIME_4;
+  }
+
+  Hasher::Hasher() : lanes{ PRIME_1 + PRIME_2, PRIME_2, 0, 0ull - PRIME_1 }, pending{}, pendingSize{ 0 }, totalSize{ 0 }
+  {
+  }
+
+  void Hasher::add(std::span<const uint8_t> data)
+  {
+    if (data.empty())
+    {
+      return;
+    }
+    totalSize += data.size();
+    if (pendingSize > 0)
+    {
+      const size_t fillSize{ std::min(STRIPE_SIZE - pendingSize, data.size()) };
+      memcpy(pending + pendingSize, data.data(), fillSize);
+      pendingSize += fillSize;
+      data = data.subspan(fillSize);
+      if (pendingSize < STRIPE_SIZE)
+      {
+        return;
+      }
+      for (int i{ 0 }; i < 4; ++i)
+      {
+        lanes[i] = roundLane(lanes[i], read64(pending + i * 8));
+      }
+      pendingSize = 0;
+    }
+
+    // the four lanes are independent, so the multiplications of one stripe overlap
+    uint64_t lane0{ lanes[0] };
+    uint64_t lane1{ lanes[1] };
+    uint64_t lane2{ lanes[2] };
+    uint64_t lane3{ lanes[3] };
+    const uint8_t* current{ data.data() };
+    const uint8_t* const stripeEnd{ current + data.size() / STRIPE_SIZE * STRIPE_SIZE };
+    for (; current < stripeEnd; current += STRIPE_SIZE)
+    {
+      lane0 = roundLane(lane0, read64(current));
+      lane1 = roundLane(lane1, read64(current + 8));
+      lane2 = roundLane(lane2, read64(current + 16));
+      lane3 = roundLane(lane3, read64(current + 24));
+    }
+    lanes[0] = lane0;
+    lanes[1] = lane1;
+    lanes[2] = lane2;
+    lanes[3] = lane3;
+
+    pendingSize = data.size() % STRIPE_SIZE;
+    memcpy(pending, current, pendingSize);
+  }
+
+  void Hasher::addPixels(const std::span<const uint16_t> pixels)
+  {
+    add({ reinterpret_cast<const uint8_t*>(pixels.data()), pixels.size_bytes() });
+  }
+
+  uint64_t Hasher::getHash() const
+  {
+    uint64_t hash;
+    if (totalSize >= STRIPE_SIZE)
+    {
+      hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+      for (const uint64_t lane : lanes)
+      {
+        hash = mergeRound(hash, lane);
+      }
+    }
+    else
+    {
+      hash = lanes[2] + PRIME_5; // the lane still holds the seed
+    }
+    hash += totalSize;
+
+    const uint8_t* current{ pending };
+    const uint8_t* const end{ pending + pendingSize };
+    for (; current + 8 <= end; current += 8)
+    {
+      hash ^= roundLane(0, read64(current));
+      hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+    }
+    if (current + 4 <= end)
+    {
+      hash ^= read32(current) * PRIME_1;
+      hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+      current += 4;
+    }
+    for (; current < end; ++current)
+    {
+      hash ^= *current * PRIME_5;
+      hash = std::rotl(hash, 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+  }
+
+  uint64_t hashCanvasRegion(const uint16_t* canvas, const int canvasWidth, const int x, const int y, const int width, const int height)
+  {
+    Hasher hasher{};
+    for (int row{ y }; row < y + height; ++row)
+    {
+      hasher.addPixels({ canvas + static_cast<size_t>(row) * canvasWidth + x, static_cast<size_t>(width) });
+    }
+    return hasher.getHash();
+  }
+
+  uint64_t hashIndexedCanvasRegion(const uint8_t* indices, const uint8_t* mask, const int canvasWidth, const int x, const int y,
+    const int width, const int height)
+  {
+    Hasher hasher{};
+    std::vector<uint8_t> rowMask(width);
+    for (int row{ y }; row < y + height; ++row)
+    {
+      const size_t rowStart{ static_cast<size_t>(row) * canvasWidth + x };
+      hasher.add({ indices + rowStart, static_cast<size_t>(width) });
+
+      // the mask bits of a row do not start at a byte, so they are hashed as one byte per pixel
+      for (int i{ 0 }; i < width; ++i)
+      {
+        const size_t pixelIndex{ rowStart + i };
+        rowMask[i] = (mask[pixelIndex >> 3] >> (pixelIndex & 7)) & 1;
+      }
+      hasher.add(rowMask);
+    }
+    return hasher.getHash();
+  }
+}
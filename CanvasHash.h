@@ -0,0 +1,39 @@
+#pragma once
+
+#include <span>
+
+#include <stdint.h>
+
+/*
+  Fast 64 bit hash of canvas regions, used to find the images that did not change between extract and pack.
+  The hasher is also used for the keys of the conversion cache, which hash whole input files.
+  Follows the XXH64 algorithm, so the result does not depend on how the data is split into blocks.
+  It only detects edits, it is not meant to resist collisions that are crafted on purpose.
+*/
+
+namespace CanvasHash
+{
+  class Hasher
+  {
+  private:
+    static constexpr size_t STRIPE_SIZE{ 32 };
+
+    uint64_t lanes[4];
+    uint8_t pending[STRIPE_SIZE];
+    size_t pendingSize;
+    uint64_t totalSize;
+
+  public:
+    Hasher();
+
+    void add(std::span<const uint8_t> data);
+    void addPixels(std::span<const uint16_t> pixels);
+    uint64_t getHash() const;
+  };
+
+  // hashes the rows of a region of an argb1555 canvas, the region needs to be inside the canvas
+  uint64_t hashCanvasRegion(const uint16_t* canvas, int canvasWidth, int x, int y, int width, int height);
+
+  // hashes the rows of a region of an indexed canvas together with the bits of its mask, which use the canvas pixel index
+  uint64_t hashIndexedCanvasRegion(const uint8_t* indices, const uint8_t* mask, int canvasWidth, int x, int y, int width, int height);
+}
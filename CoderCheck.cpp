@@ -0,0 +1,610 @@
+#include "CoderCheck.h"
+
+#include "Console.h"
+#include "TGXCoder.h"
+#include "CorpusGenerator.h"
+#include "RawCompression.h"
+
+#include <format>
+#include <string_view>
+#include <functional>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace CoderCheck
+{
+  using CorpusGenerator::SplitMix64;
+
+  // same as the alpha the TGX coder uses for indexed colors, the lower byte is the palette index
+  static constexpr uint16_t INDEXED_COLOR_ALPHA{ 0xff00 };
+  static constexpr uint16_t OPAQUE_ALPHA_BIT{ 0x8000 };
+  static constexpr int MAX_PIXEL_PER_MARKER{ TGX_MARKER_HISTOGRAM_SIZE };
+
+  static constexpr int MAX_RANDOM_WIDTH{ 90 };
+  static constexpr int MAX_RANDOM_HEIGHT{ 30 };
+  static constexpr int MAX_LOOKAHEAD_CHECK_WIDTH{ 2 * MAX_PIXEL_PER_MARKER + 1 };
+  static constexpr int LOOKAHEAD_CHECK_HEIGHT{ 4 };
+  static constexpr size_t MAX_SMALL_DATA_SIZE{ 64 * 1024 };
+  static constexpr uint32_t MAX_DATA_RUN_LENGTH{ 512 };
+
+  struct CheckImage
+  {
+    int width;
+    int height;
+    TgxColorType colorType;
+    TgxCoderInstruction instructions;
+    std::vector<uint16_t> raw;
+  };
+
+  // the image inside a bigger canvas, so that the coders have to use the offsets and line jumps
+  struct CheckCanvas
+  {
+    int width;
+    int height;
+    int imageX;
+    int imageY;
+    std::vector<uint16_t> raw;
+  };
+
+  // a case returns the description of its failure, or an empty string if it passed
+  using CheckCase = std::function<std::string(SplitMix64&)>;
+
+  static uint16_t createColor(const uint32_t index, const TgxColorType colorType)
+  {
+    if (colorType == TgxColorType::INDEXED)
+    {
+      return INDEXED_COLOR_ALPHA | static_cast<uint16_t>(index % 256);
+    }
+    return OPAQUE_ALPHA_BIT | static_cast<uint16_t>((index * 7919) % OPAQUE_ALPHA_BIT);
+  }
+
+  // few colors, so repeats, transparency and runs over line ends are common
+  // the threshold also uses values outside of the marker range
+  static CheckImage createRandomImage(SplitMix64& random, const TgxColorType colorType)
+  {
+    CheckImage image{
+      .width{ 1 + static_cast<int>(random.nextBelow(random.nextBelow(3) == 0 ? 4 : MAX_RANDOM_WIDTH)) },
+      .height{ 1 + static_cast<int>(random.nextBelow(MAX_RANDOM_HEIGHT)) },
+      .colorType{ colorType },
+      .instructions{ TGX_FILE_DEFAULT_INSTRUCTION },
+      .raw{}
+    };
+    image.instructions.pixelRepeatThreshold = static_cast<int>(random.nextBelow(MAX_PIXEL_PER_MARKER + 8)) - 2;
+    image.raw.resize(static_cast<size_t>(image.width) * image.height);
+    const uint32_t colorCount{ 1 + random.nextBelow(4) };
+    for (uint16_t& pixel : image.raw)
+    {
+      const uint32_t kind{ random.nextBelow(colorCount + 2) };
+      if (kind == 0)
+      {
+        pixel = image.instructions.transparentPixelRawColor;
+      }
+      else
+      {
+        pixel = createColor(kind == 1 ? random.nextBelow(256) + colorCount : kind, image.colorType);
+      }
+    }
+    return image;
+  }
+
+  static CheckCanvas placeOnCanvas(const CheckImage& image, SplitMix64& random)
+  {
+    CheckCanvas canvas{
+      .width{ image.width + static_cast<int>(random.nextBelow(9)) },
+      .height{ image.height + static_cast<int>(random.nextBelow(4)) },
+      .imageX{ 0 },
+      .imageY{ 0 },
+      .raw{}
+    };
+    canvas.imageX = static_cast<int>(random.nextBelow(canvas.width - image.width + 1));
+    canvas.imageY = static_cast<int>(random.nextBelow(canvas.height - image.height + 1));
+    canvas.raw.assign(static_cast<size_t>(canvas.width) * canvas.height, image.instructions.transparentPixelRawColor);
+    for (int y{ 0 }; y < image.height; ++y)
+    {
+      std::copy_n(image.raw.begin() + static_cast<size_t>(y) * image.width, image.width,
+        canvas.raw.begin() + static_cast<size_t>(y + canvas.imageY) * canvas.width + canvas.imageX);
+    }
+    return canvas;
+  }
+
+  static TgxCoderRawInfo getRawInfo(CheckCanvas& canvas)
+  {
+    return TgxCoderRawInfo{
+      .data{ canvas.raw.data() },
+      .rawWidth{ canvas.width },
+      .rawHeight{ canvas.height },
+      .rawX{ canvas.imageX },
+      .rawY{ canvas.imageY }
+    };
+  }
+
+  static TgxCoderTgxInfo getTgxInfo(const CheckImage& image)
+  {
+    return TgxCoderTgxInfo{
+      .colorType{ image.colorType },
+      .data{ nullptr },
+      .dataSize{ 0 },
+      .tgxWidth{ image.width },
+      .tgxHeight{ image.height }
+    };
+  }
+
+  // asks the encoder for the size first and then encodes into a buffer of that size, like the file functions
+  template<typename RawInfo>
+  static std::vector<uint8_t> encodeTgx(TgxCoderResult(*encoder)(const RawInfo*, TgxCoderTgxInfo*, const TgxCoderInstruction*),
+    const RawInfo& rawInfo, const CheckImage& image)
+  {
+    TgxCoderTgxInfo tgxInfo{ getTgxInfo(image) };
+    const TgxCoderResult sizeResult{ encoder(&rawInfo, &tgxInfo, &image.instructions) };
+    if (sizeResult != TgxCoderResult::FILLED_ENCODING_SIZE)
+    {
+      throw std::runtime_error{ getTgxResultDescription(sizeResult) };
+    }
+    std::vector<uint8_t> encoded(tgxInfo.dataSize);
+    tgxInfo.data = encoded.data();
+    const TgxCoderResult result{ encoder(&rawInfo, &tgxInfo, &image.instructions) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      throw std::runtime_error{ getTgxResultDescription(result) };
+    }
+    encoded.resize(tgxInfo.dataSize);
+    return encoded;
+  }
+
+  static std::vector<uint8_t> encodeTgx(const CheckImage& image)
+  {
+    const TgxCoderRawInfo rawInfo{
+      .data{ const_cast<uint16_t*>(image.raw.data()) },
+      .rawWidth{ image.width },
+      .rawHeight{ image.height },
+      .rawX{ 0 },
+      .rawY{ 0 }
+    };
+    return encodeTgx(encodeRawToTgx, rawInfo, image);
+  }
+
+  static std::string describeImage(const CheckImage& image)
+  {
+    return std::format("{}x{} {} image with threshold {}", image.width, image.height,
+      image.colorType == TgxColorType::INDEXED ? "indexed" : "default", image.instructions.pixelRepeatThreshold);
+  }
+
+  // the 8 bit canvas of an indexed 16 bit canvas, opaque pixels keep their palette index and set their mask bit
+  static void splitIndexedCanvas(const CheckCanvas& canvas, const uint16_t transparentColor, std::vector<uint8_t>& outIndices,
+    std::vector<uint8_t>& outMask)
+  {
+    outIndices.assign(canvas.raw.size(), 0);
+    outMask.assign((canvas.raw.size() + 7) / 8, 0);
+    for (size_t i{ 0 }; i < canvas.raw.size(); ++i)
+    {
+      if (canvas.raw[i] != transparentColor)
+      {
+        outIndices[i] = static_cast<uint8_t>(canvas.raw[i]);
+        outMask[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+      }
+    }
+  }
+
+  // long runs of zeros and two byte patterns like in canvases, a quarter of the cases is random and stays uncompressed
+  static std::vector<uint8_t> createRandomData(SplitMix64& random)
+  {
+    const size_t size{ random.nextBelow(8) == 0 ? random.nextBelow(3 * RawCompression::BLOCK_SIZE) : random.nextBelow(MAX_SMALL_DATA_SIZE) };
+    const bool incompressible{ random.nextBelow(4) == 0 };
+    std::vector<uint8_t> data(size);
+    for (size_t i{ 0 }; i < data.size();)
+    {
+      const size_t runEnd{ i + std::min<size_t>(data.size() - i, 1 + random.nextBelow(MAX_DATA_RUN_LENGTH)) };
+      const uint32_t runKind{ incompressible ? 2 : random.nextBelow(3) };
+      const uint8_t pattern[]{ static_cast<uint8_t>(random.next()), static_cast<uint8_t>(random.next()) };
+      for (; i < runEnd; ++i)
+      {
+        data[i] = runKind == 0 ? 0 : runKind == 1 ? pattern[i % 2] : static_cast<uint8_t>(random.next());
+      }
+    }
+    return data;
+  }
+
+  static std::string compressData(const std::span<const uint8_t> data)
+  {
+    std::ostringstream out{ std::ios::out | std::ios::binary };
+    const uint64_t writtenBytes{ RawCompression::writeCompressed(out, data) };
+    std::string compressed{ std::move(out).str() };
+    if (writtenBytes != compressed.size())
+    {
+      throw std::runtime_error{ "Written byte count does not match the compressed stream." };
+    }
+    return compressed;
+  }
+
+  // throws like the reader used by pack
+  static std::vector<uint8_t> decompressData(const std::string& compressed, const uint64_t expectedSize)
+  {
+    std::istringstream in{ compressed, std::ios::in | std::ios::binary };
+    std::vector<uint8_t> data{};
+    RawCompression::readCompressedBlocks(in, expectedSize, [&data](const std::span<const uint8_t> block)
+      {
+        data.insert(data.end(), block.begin(), block.end());
+        return true;
+      });
+    return data;
+  }
+
+  static void write32(std::string& stream, const size_t position, const uint32_t value)
+  {
+    for (size_t i{ 0 }; i < sizeof(value); ++i)
+    {
+      stream[position + i] = static_cast<char>(value >> (8 * i));
+    }
+  }
+
+  // chunk sizes of zero or more lines, or whole lines if maxChunkPixelCount is zero
+  // half of the cases write to caller memory that only grows as much as required, so every write has to grow it
+  static std::string encodeTgxStream(const CheckImage& image, SplitMix64& random, const size_t maxChunkPixelCount,
+    const std::vector<uint8_t>& expected)
+  {
+    TgxStreamEncoder encoder{ getTgxInfo(image), image.instructions };
+    std::vector<uint8_t> encoded{};
+    const bool growingOutput{ random.nextBelow(2) == 0 };
+    std::vector<uint8_t> memory(random.nextBelow(16));
+    TgxStreamOutput output{
+      .data{ memory.data() },
+      .capacity{ static_cast<uint32_t>(memory.size()) },
+      .size{ 0 },
+      .grow{ [&memory](TgxStreamOutput& grownOutput, const uint32_t requiredCapacity)
+        {
+          memory.resize(requiredCapacity);
+          grownOutput.data = memory.data();
+          grownOutput.capacity = requiredCapacity;
+        }
+      }
+    };
+    for (size_t index{ 0 }; index < image.raw.size();)
+    {
+      const size_t chunkPixelCount{ std::min(image.raw.size() - index,
+        maxChunkPixelCount == 0 ? static_cast<size_t>(image.width) : random.nextBelow(static_cast<uint32_t>(maxChunkPixelCount) + 1)) };
+      const std::span<const uint16_t> chunk{ image.raw.data() + index, chunkPixelCount };
+      const TgxCoderResult result{ growingOutput ? encoder.push(chunk, output) : encoder.push(chunk, encoded) };
+      if (result != TgxCoderResult::SUCCESS)
+      {
+        return std::format("push failed: {}", getTgxResultDescription(result));
+      }
+      index += chunkPixelCount;
+    }
+    const TgxCoderResult result{ growingOutput ? encoder.finish(output) : encoder.finish(encoded) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      return std::format("finish failed: {}", getTgxResultDescription(result));
+    }
+    if (growingOutput)
+    {
+      encoded.assign(memory.begin(), memory.begin() + output.size);
+    }
+    if (encoded != expected || encoder.getEncodedSize() != expected.size())
+    {
+      return std::format("{} streams {} bytes instead of {}", describeImage(image), encoded.size(), expected.size());
+    }
+    return {};
+  }
+
+  static void runCase(CheckResult& result, const int caseIndex, SplitMix64& random, const CheckCase& checkCase)
+  {
+    std::string failure{};
+    try
+    {
+      failure = checkCase(random);
+    }
+    catch (const std::exception& e)
+    {
+      failure = std::format("exception: {}", e.what());
+    }
+    ++result.cases;
+    if (failure.empty())
+    {
+      return;
+    }
+    if (result.failures == 0)
+    {
+      result.firstFailure = std::format("case {}: {}", caseIndex, failure);
+    }
+    ++result.failures;
+  }
+
+  static CheckResult runRandomCheck(const std::string_view name, const CheckSettings& settings, const uint64_t checkIndex,
+    const CheckCase& checkCase)
+  {
+    CheckResult result{ .name{ std::string{ name } }, .cases{ 0 }, .failures{ 0 }, .firstFailure{} };
+    SplitMix64 random{ settings.seed + checkIndex };
+    for (int caseIndex{ 0 }; caseIndex < settings.cases; ++caseIndex)
+    {
+      runCase(result, caseIndex, random, checkCase);
+    }
+    return result;
+  }
+
+
+  /* CHECKS */
+
+  static std::string checkStreamEncoder(SplitMix64& random)
+  {
+    const CheckImage image{ createRandomImage(random, random.nextBelow(2) == 0 ? TgxColorType::DEFAULT : TgxColorType::INDEXED) };
+    const size_t maxChunkPixelCount{ random.nextBelow(4) == 0 ? 0 : static_cast<size_t>(3 * image.width + 1) };
+    return encodeTgxStream(image, random, maxChunkPixelCount, encodeTgx(image));
+  }
+
+  // single color images, where the repeat lookahead runs the furthest into the following lines
+  // whole lines are pushed, so the encoder only has the lines it requested, like width 31 with threshold 31
+  static CheckResult checkStreamLookahead()
+  {
+    CheckResult result{ .name{ "stream encoder lookahead" }, .cases{ 0 }, .failures{ 0 }, .firstFailure{} };
+    SplitMix64 random{ 0 }; // unused, whole lines are pushed
+    int caseIndex{ 0 };
+    for (int width{ 1 }; width <= MAX_LOOKAHEAD_CHECK_WIDTH; ++width)
+    {
+      for (int threshold{ 0 }; threshold < MAX_PIXEL_PER_MARKER; ++threshold)
+      {
+        CheckImage image{
+          .width{ width },
+          .height{ LOOKAHEAD_CHECK_HEIGHT },
+          .colorType{ TgxColorType::DEFAULT },
+          .instructions{ TGX_FILE_DEFAULT_INSTRUCTION },
+          .raw{}
+        };
+        image.instructions.pixelRepeatThreshold = threshold;
+        image.raw.assign(static_cast<size_t>(width) * LOOKAHEAD_CHECK_HEIGHT, createColor(1, image.colorType));
+        runCase(result, caseIndex++, random, [&image](SplitMix64& caseRandom)
+          {
+            const int lookaheadLines{ TgxStreamEncoder{ getTgxInfo(image), image.instructions }.getLookaheadLines() };
+            // a full marker can start on the last pixel of a line and reset on the first of the next
+            if (lookaheadLines < image.height - 1 && lookaheadLines * image.width < image.instructions.pixelRepeatThreshold + 1)
+            {
+              return std::format("{} lookahead lines for width {} and threshold {}", lookaheadLines, image.width,
+                image.instructions.pixelRepeatThreshold);
+            }
+            return encodeTgxStream(image, caseRandom, 0, encodeTgx(image));
+          });
+      }
+    }
+    return result;
+  }
+
+  // the image is placed in a bigger canvas and sometimes padded, since both change the size
+  static std::string checkSizePredictor(SplitMix64& random, const TgxColorType colorType)
+  {
+    CheckImage image{ createRandomImage(random, colorType) };
+    if (random.nextBelow(5) == 0)
+    {
+      image.instructions.paddingAlignment = 1 + static_cast<int>(random.nextBelow(8));
+    }
+    CheckCanvas canvas{ placeOnCanvas(image, random) };
+    const TgxCoderRawInfo rawInfo{ getRawInfo(canvas) };
+    const std::vector<uint8_t> encoded{ encodeTgx(encodeRawToTgx, rawInfo, image) };
+    TgxCoderTgxInfo tgxInfo{ getTgxInfo(image) };
+    const TgxCoderResult result{ predictRawToTgxSize(&rawInfo, &tgxInfo, &image.instructions) };
+    if (result != TgxCoderResult::FILLED_ENCODING_SIZE)
+    {
+      return std::format("prediction failed: {}", getTgxResultDescription(result));
+    }
+    if (tgxInfo.dataSize != encoded.size())
+    {
+      return std::format("{} is predicted with {} bytes instead of {}", describeImage(image), tgxInfo.dataSize, encoded.size());
+    }
+    return {};
+  }
+
+  static std::string checkIndexedEncoder(SplitMix64& random)
+  {
+    const CheckImage image{ createRandomImage(random, TgxColorType::INDEXED) };
+    CheckCanvas canvas{ placeOnCanvas(image, random) };
+    std::vector<uint8_t> indices{};
+    std::vector<uint8_t> mask{};
+    splitIndexedCanvas(canvas, image.instructions.transparentPixelRawColor, indices, mask);
+    const TgxCoderIndexedRawInfo indexedInfo{
+      .data{ indices.data() },
+      .mask{ mask.data() },
+      .rawWidth{ canvas.width },
+      .rawHeight{ canvas.height },
+      .rawX{ canvas.imageX },
+      .rawY{ canvas.imageY }
+    };
+    const std::vector<uint8_t> expected{ encodeTgx(encodeRawToTgx, getRawInfo(canvas), image) };
+    const std::vector<uint8_t> encoded{ encodeTgx(encodeIndexedRawToTgx, indexedInfo, image) };
+    if (encoded != expected)
+    {
+      return std::format("{} encodes to {} bytes from the 8 bit canvas instead of {}", describeImage(image), encoded.size(), expected.size());
+    }
+    return {};
+  }
+
+  // both decoders leave transparent pixels untouched, so both have to restore the canvas of the encoded image
+  static std::string checkIndexedDecoder(SplitMix64& random)
+  {
+    const CheckImage image{ createRandomImage(random, TgxColorType::INDEXED) };
+    std::vector<uint8_t> encoded{ encodeTgx(image) };
+    TgxCoderTgxInfo tgxInfo{ getTgxInfo(image) };
+    tgxInfo.data = encoded.data();
+    tgxInfo.dataSize = static_cast<uint32_t>(encoded.size());
+
+    const CheckCanvas expected{ placeOnCanvas(image, random) };
+    CheckCanvas decoded{ expected };
+    std::fill(decoded.raw.begin(), decoded.raw.end(), image.instructions.transparentPixelRawColor);
+    TgxCoderRawInfo rawInfo{ getRawInfo(decoded) };
+    const TgxCoderResult rawResult{ decodeTgxToRaw(&tgxInfo, &rawInfo, nullptr) };
+    if (rawResult != TgxCoderResult::SUCCESS)
+    {
+      return std::format("16 bit decode failed: {}", getTgxResultDescription(rawResult));
+    }
+    std::vector<uint8_t> indices(expected.raw.size(), 0);
+    std::vector<uint8_t> mask((expected.raw.size() + 7) / 8, 0);
+    TgxCoderIndexedRawInfo indexedInfo{
+      .data{ indices.data() },
+      .mask{ mask.data() },
+      .rawWidth{ expected.width },
+      .rawHeight{ expected.height },
+      .rawX{ expected.imageX },
+      .rawY{ expected.imageY }
+    };
+    const TgxCoderResult indexedResult{ decodeIndexedTgxToIndexedRaw(&tgxInfo, &indexedInfo) };
+    if (indexedResult != TgxCoderResult::SUCCESS)
+    {
+      return std::format("8 bit decode failed: {}", getTgxResultDescription(indexedResult));
+    }
+
+    if (decoded.raw != expected.raw)
+    {
+      return std::format("{} does not decode to its 16 bit canvas", describeImage(image));
+    }
+    std::vector<uint8_t> expectedIndices{};
+    std::vector<uint8_t> expectedMask{};
+    splitIndexedCanvas(expected, image.instructions.transparentPixelRawColor, expectedIndices, expectedMask);
+    if (indices != expectedIndices || mask != expectedMask)
+    {
+      return std::format("{} does not decode to its 8 bit canvas", describeImage(image));
+    }
+    return {};
+  }
+
+  static std::string checkCompressionRoundTrip(SplitMix64& random)
+  {
+    const std::vector<uint8_t> data{ createRandomData(random) };
+    if (decompressData(compressData(data), data.size()) != data)
+    {
+      return std::format("{} bytes do not survive the round trip", data.size());
+    }
+    return {};
+  }
+
+  // without a checksum, changed literals can not be detected, but the reader has to throw or fill exactly the expected size
+  static std::string checkCompressionCorruption(SplitMix64& random)
+  {
+    const std::vector<uint8_t> data{ createRandomData(random) };
+    std::string compressed{ compressData(data) };
+    const uint32_t corruption{ random.nextBelow(3) };
+    if (corruption == 0)
+    {
+      compressed.resize(random.nextBelow(static_cast<uint32_t>(compressed.size())));
+    }
+    else
+    {
+      const size_t byteCount{ 1 + random.nextBelow(corruption == 1 ? 1 : 16) };
+      for (size_t i{ 0 }; i < byteCount; ++i)
+      {
+        compressed[random.nextBelow(static_cast<uint32_t>(compressed.size()))] ^= static_cast<char>(1 + random.nextBelow(255));
+      }
+    }
+
+    try
+    {
+      const std::vector<uint8_t> decompressed{ decompressData(compressed, data.size()) };
+      if (decompressed.size() != data.size())
+      {
+        return std::format("corrupted stream of {} bytes decompresses to {} bytes", data.size(), decompressed.size());
+      }
+    }
+    catch (const std::exception&)
+    {
+      // rejected
+    }
+    return {};
+  }
+
+  // headers with valid magic and version, but a table the reader can not trust, have to be rejected
+  // a bigger block size with a matching block count used to overflow the conversion buffer of pack
+  static CheckResult checkCompressionHeaders(const CheckSettings& settings)
+  {
+    // header layout: magic, version, block size, uncompressed size low and high, block count, then the block table
+    constexpr size_t VERSION_POSITION{ 4 };
+    constexpr size_t BLOCK_SIZE_POSITION{ 8 };
+    constexpr size_t UNCOMPRESSED_SIZE_POSITION{ 12 };
+    constexpr size_t BLOCK_COUNT_POSITION{ 20 };
+    constexpr size_t TABLE_POSITION{ 24 };
+    constexpr uint32_t STORED_FLAG{ 0x80000000u };
+
+    SplitMix64 random{ settings.seed };
+    std::vector<uint8_t> data(RawCompression::BLOCK_SIZE * 5 / 2);
+    for (uint8_t& value : data)
+    {
+      value = random.nextBelow(4) == 0 ? static_cast<uint8_t>(random.next()) : 0;
+    }
+    const std::string valid{ compressData(data) };
+    const uint32_t biggerBlockSize{ 4 * RawCompression::BLOCK_SIZE };
+
+    const std::vector<std::pair<std::string_view, std::function<void(std::string&)>>> corruptions{
+      { "magic", [](std::string& stream) { stream[0] ^= 0x20; } },
+      { "version", [&](std::string& stream) { write32(stream, VERSION_POSITION, 2); } },
+      { "bigger block size", [&](std::string& stream)
+        {
+          write32(stream, BLOCK_SIZE_POSITION, biggerBlockSize);
+          write32(stream, BLOCK_COUNT_POSITION, static_cast<uint32_t>((data.size() + biggerBlockSize - 1) / biggerBlockSize));
+        } },
+      { "smaller block size", [&](std::string& stream) { write32(stream, BLOCK_SIZE_POSITION, RawCompression::BLOCK_SIZE / 2); } },
+      { "zero block size", [&](std::string& stream) { write32(stream, BLOCK_SIZE_POSITION, 0); } },
+      { "uncompressed size", [&](std::string& stream) { write32(stream, UNCOMPRESSED_SIZE_POSITION, static_cast<uint32_t>(data.size() + 1)); } },
+      { "block count", [&](std::string& stream) { write32(stream, BLOCK_COUNT_POSITION, 4); } },
+      { "compressed block size", [&](std::string& stream) { write32(stream, TABLE_POSITION, RawCompression::BLOCK_SIZE + 1); } },
+      { "stored block size", [&](std::string& stream) { write32(stream, TABLE_POSITION, STORED_FLAG | (RawCompression::BLOCK_SIZE - 1)); } },
+      { "end in header", [&](std::string& stream) { stream.resize(BLOCK_SIZE_POSITION + 2); } },
+      { "end in table", [&](std::string& stream) { stream.resize(TABLE_POSITION + 2); } },
+      { "empty", [](std::string& stream) { stream.clear(); } },
+    };
+
+    CheckResult result{ .name{ "compression corrupt headers" }, .cases{ 0 }, .failures{ 0 }, .firstFailure{} };
+    int caseIndex{ 0 };
+    for (const auto& [corruptionName, corrupt] : corruptions)
+    {
+      runCase(result, caseIndex++, random, [&](SplitMix64&)
+        {
+          std::string compressed{ valid };
+          corrupt(compressed);
+          try
+          {
+            decompressData(compressed, data.size());
+          }
+          catch (const std::exception&)
+          {
+            return std::string{};
+          }
+          return std::format("corrupted {} is not rejected", corruptionName);
+        });
+    }
+    return result;
+  }
+
+
+  std::vector<CheckResult> runChecks(const CheckSettings& settings)
+  {
+    std::vector<CheckResult> results{};
+    Log(LogLevel::DEBUG, "Running TGX encoder checks.");
+    results.push_back(runRandomCheck("stream encoder vs encoder", settings, 0, checkStreamEncoder));
+    results.push_back(checkStreamLookahead());
+    results.push_back(runRandomCheck("size predictor vs encoder, default", settings, 1,
+      [](SplitMix64& random) { return checkSizePredictor(random, TgxColorType::DEFAULT); }));
+    results.push_back(runRandomCheck("size predictor vs encoder, indexed", settings, 2,
+      [](SplitMix64& random) { return checkSizePredictor(random, TgxColorType::INDEXED); }));
+    results.push_back(runRandomCheck("8 bit vs 16 bit indexed encoder", settings, 3, checkIndexedEncoder));
+    results.push_back(runRandomCheck("8 bit vs 16 bit indexed decoder", settings, 4, checkIndexedDecoder));
+
+    Log(LogLevel::DEBUG, "Running raw data compression checks.");
+    results.push_back(runRandomCheck("compression round trip", settings, 5, checkCompressionRoundTrip));
+    results.push_back(runRandomCheck("compression corrupt data", settings, 6, checkCompressionCorruption));
+    results.push_back(checkCompressionHeaders(settings));
+    return results;
+  }
+
+  bool printResults(const std::vector<CheckResult>& results)
+  {
+    bool passed{ true };
+    Out("### Coder check results ###\n");
+    Out("{:<40} {:>8} {:>8}\n", "Check", "cases", "failed");
+    for (const CheckResult& result : results)
+    {
+      Out("{:<40} {:>8} {:>8}\n", result.name, result.cases, result.failures);
+      if (result.failures > 0)
+      {
+        Out("  first failure: {}\n", result.firstFailure);
+        passed = false;
+      }
+    }
+    return passed;
+  }
+}
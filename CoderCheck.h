@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// randomized checks of the coders against each other, independent of any game file
+// every check compares two ways to get the same result, the same seed always creates the same cases
+// covers the TGX stream encoder, size predictor and 8 bit indexed coders, and the raw data compression with corrupted input
+
+namespace CoderCheck
+{
+  struct CheckSettings
+  {
+    uint64_t seed;
+    int cases; // random cases per check, fixed regression cases are always run
+  };
+
+  inline constexpr CheckSettings DEFAULT_SETTINGS{
+    .seed{ 1 },
+    .cases{ 1000 }
+  };
+
+  struct CheckResult
+  {
+    std::string name;
+    int cases;
+    int failures;
+    std::string firstFailure; // empty if no case failed
+  };
+
+  std::vector<CheckResult> runChecks(const CheckSettings& settings);
+
+  // prints one line per check and the first failure of failed checks, returns false if a check failed
+  bool printResults(const std::vector<CheckResult>& results);
+}
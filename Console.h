@@ -2,7 +2,11 @@
 
 #include <iostream>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <format>
+#include <iterator>
+#include <string>
 #include <unordered_map>
 
 enum class LogLevel : int
@@ -25,22 +29,59 @@ inline const std::unordered_map<LogLevel, const char*> LOG_LEVEL_MAP{
 inline std::ostream& LOG_OUT{ std::clog };
 inline std::ostream& STD_OUT{ std::cout };
 
-inline LogLevel currentLogLevel{ LogLevel::INFO };
+inline std::atomic<LogLevel> currentLogLevel{ LogLevel::INFO };
+
+/*
+  Log messages are formatted on the calling thread into a ring buffer owned by that thread.
+  A background thread drains the buffers, adds the time in the cached local zone and writes to LOG_OUT.
+  Implemented in Logger.cpp.
+*/
+
+struct LogRecord
+{
+  std::chrono::system_clock::time_point time;
+  LogLevel level;
+  std::string message; // keeps its capacity, so that reused records do not allocate
+};
+
+// returns the next free record of the ring buffer of the current thread, waits if the buffer is full
+LogRecord& beginLogRecord();
+
+// hands the record returned by beginLogRecord to the background thread
+void commitLogRecord();
+
+// returns after all records committed so far are written
+void flushLog();
 
 template<class... Args>
 void Log(const LogLevel level, const std::format_string<Args...> fmt, Args&&... args)
 {
-  if (level < currentLogLevel)
+  if (level < currentLogLevel.load(std::memory_order_relaxed))
   {
     return;
   }
-  const std::chrono::zoned_time currentTime{ std::chrono::current_zone(), std::chrono::system_clock::now() };
-  std::print(LOG_OUT, "{:%Y-%m-%d %T %Z} : {} : ", currentTime, LOG_LEVEL_MAP.at(level));
-  std::println(LOG_OUT, fmt, std::forward<Args>(args)...);
+  LogRecord& record{ beginLogRecord() };
+  record.time = std::chrono::system_clock::now();
+  record.level = level;
+  record.message.clear();
+  std::format_to(std::back_inserter(record.message), fmt, std::forward<Args>(args)...);
+  commitLogRecord();
+}
+
+// allows to collect the output of a thread, so that the output of parallel work does not mix
+inline thread_local std::ostream* threadOutRedirect{ nullptr };
+
+inline std::ostream& getOutStream()
+{
+  return threadOutRedirect ? *threadOutRedirect : STD_OUT;
 }
 
 template<class... Args>
 void Out(const std::format_string<Args...> fmt, Args&&... args)
 {
-  std::print(STD_OUT, fmt, std::forward<Args>(args)...);
+  if (!threadOutRedirect)
+  {
+    flushLog(); // keeps the order of log and output on the console
+  }
+  std::print(getOutStream(), fmt, std::forward<Args>(args)...);
 }
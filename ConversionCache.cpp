@@ -0,0 +1,220 @@
+#include "ConversionCache.h"
+
+#include "Console.h"
+
+#include <fstream>
+#include <format>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <functional>
+
+namespace ConversionCache
+{
+  static constexpr size_t FILE_READ_CHUNK_SIZE{ 64 * 1024 };
+
+  ContentHasher::ContentHasher() : hasher{}
+  {
+  }
+
+  void ContentHasher::add(const void* data, size_t size)
+  {
+    hasher.add({ static_cast<const uint8_t*>(data), size });
+  }
+
+  void ContentHasher::add(std::string_view str)
+  {
+    add(str.data(), str.size());
+    const char terminator{ '\0' };
+    add(&terminator, sizeof(terminator));
+  }
+
+  void ContentHasher::addInteger(uint64_t value)
+  {
+    uint8_t bytes[sizeof(uint64_t)];
+    for (size_t i{ 0 }; i < sizeof(uint64_t); ++i)
+    {
+      bytes[i] = static_cast<uint8_t>(value >> (i * 8)); // fixed order, independent of the platform
+    }
+    add(bytes, sizeof(bytes));
+  }
+
+  void ContentHasher::addFile(const std::filesystem::path& file)
+  {
+    std::ifstream in;
+    in.exceptions(std::ifstream::badbit);
+    in.open(file, std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+      throw std::ios::failure{ std::format("Unable to open '{}' for hashing.", file.string()) };
+    }
+
+    std::vector<char> buffer(FILE_READ_CHUNK_SIZE);
+    uint64_t totalSize{ 0 };
+    while (in)
+    {
+      in.read(buffer.data(), buffer.size());
+      const size_t readSize{ static_cast<size_t>(in.gcount()) };
+      add(buffer.data(), readSize);
+      totalSize += readSize;
+    }
+    addInteger(totalSize);
+  }
+
+  uint64_t ContentHasher::getHash() const
+  {
+    return hasher.getHash();
+  }
+
+
+  static void addInstructions(ContentHasher& hasher, const TgxCoderInstruction& instructions)
+  {
+    hasher.addInteger(instructions.transparentPixelTgxColor);
+    hasher.addInteger(instructions.transparentPixelRawColor);
+    hasher.addInteger(static_cast<uint64_t>(instructions.pixelRepeatThreshold));
+    hasher.addInteger(static_cast<uint64_t>(instructions.paddingAlignment));
+  }
+
+  static std::string keyFromHasher(const ContentHasher& hasher)
+  {
+    return std::format("{:016x}", hasher.getHash());
+  }
+
+  Cache::Cache(const std::filesystem::path& folder) : folder{ folder }
+  {
+    std::filesystem::create_directories(folder);
+  }
+
+  const std::filesystem::path& Cache::getFolder() const
+  {
+    return folder;
+  }
+
+  std::filesystem::path Cache::getEntryPath(std::string_view key) const
+  {
+    return folder / key;
+  }
+
+  std::string Cache::createExtractKey(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions) const
+  {
+    ContentHasher hasher{};
+    hasher.addInteger(TOOL_VERSION);
+    hasher.add("extract");
+    addInstructions(hasher, instructions);
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.pngFormat));
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.rawPixelFormat));
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.pngPalette));
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.dataCompression));
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.tunePixelRepeatThreshold));
+    hasher.addInteger(static_cast<uint64_t>(extractOptions.keepOriginalEncoding));
+    hasher.add(source.extension().string());
+    hasher.add(target.filename().string());
+    hasher.addFile(source);
+    return keyFromHasher(hasher);
+  }
+
+  std::string Cache::createPackKey(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions) const
+  {
+    ContentHasher hasher{};
+    hasher.addInteger(TOOL_VERSION);
+    hasher.add("pack");
+    addInstructions(hasher, instructions);
+    hasher.add(target.extension().string());
+
+    // sorted, since the iteration order is not defined
+    std::vector<std::filesystem::path> files{};
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ source })
+    {
+      if (entry.is_regular_file())
+      {
+        files.emplace_back(std::filesystem::relative(entry.path(), source));
+      }
+    }
+    std::sort(files.begin(), files.end());
+    for (const std::filesystem::path& file : files)
+    {
+      hasher.add(file.generic_string());
+      hasher.addFile(source / file);
+    }
+    return keyFromHasher(hasher);
+  }
+
+  bool Cache::tryRestoreExtract(std::string_view key, const std::filesystem::path& target) const
+  {
+    const std::filesystem::path entry{ getEntryPath(key) };
+    std::error_code errorCode{};
+    if (!std::filesystem::is_directory(entry, errorCode))
+    {
+      return false;
+    }
+
+    std::filesystem::create_directories(target, errorCode);
+    std::filesystem::copy(entry, target, std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, errorCode);
+    if (errorCode)
+    {
+      Log(LogLevel::WARNING, "Failed to restore cache entry '{}': {}", key, errorCode.message());
+      return false;
+    }
+    return true;
+  }
+
+  bool Cache::tryRestorePack(std::string_view key, const std::filesystem::path& target) const
+  {
+    const std::filesystem::path entry{ getEntryPath(key) };
+    std::error_code errorCode{};
+    if (!std::filesystem::is_regular_file(entry, errorCode))
+    {
+      return false;
+    }
+
+    if (std::filesystem::equivalent(entry, target, errorCode))
+    {
+      Log(LogLevel::DEBUG, "Target is already linked to cache entry '{}'.", key);
+      return true;
+    }
+
+    std::filesystem::create_directories(target.parent_path(), errorCode);
+    std::filesystem::remove(target, errorCode);
+    errorCode.clear();
+    std::filesystem::create_hard_link(entry, target, errorCode);
+    if (errorCode)
+    {
+      Log(LogLevel::DEBUG, "Failed to link cache entry '{}', copying it instead: {}", key, errorCode.message());
+      errorCode.clear();
+      std::filesystem::copy_file(entry, target, std::filesystem::copy_options::overwrite_existing, errorCode);
+    }
+    if (errorCode)
+    {
+      Log(LogLevel::WARNING, "Failed to restore cache entry '{}': {}", key, errorCode.message());
+      return false;
+    }
+    return true;
+  }
+
+  void Cache::store(std::string_view key, const std::filesystem::path& target) const
+  {
+    const std::filesystem::path entry{ getEntryPath(key) };
+    // written to a temporary path first, so that concurrent runs never see a partial entry
+    const std::filesystem::path temporaryEntry{ folder / std::format("{}.{}.tmp", key, std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+
+    std::error_code errorCode{};
+    std::filesystem::remove_all(temporaryEntry, errorCode);
+    std::filesystem::copy(target, temporaryEntry, std::filesystem::copy_options::recursive, errorCode);
+    if (!errorCode)
+    {
+      std::filesystem::rename(temporaryEntry, entry, errorCode);
+    }
+    if (errorCode)
+    {
+      std::error_code cleanupErrorCode{};
+      std::filesystem::remove_all(temporaryEntry, cleanupErrorCode);
+      if (!std::filesystem::exists(entry, cleanupErrorCode))
+      {
+        Log(LogLevel::WARNING, "Failed to store cache entry '{}': {}", key, errorCode.message());
+      }
+      return;
+    }
+    Log(LogLevel::DEBUG, "Stored cache entry '{}'.", key);
+  }
+}
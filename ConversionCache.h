@@ -0,0 +1,68 @@
+#pragma once
+
+#include "TGXCoder.h"
+#include "ExtractOptions.h"
+#include "CanvasHash.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/*
+  Persistent cache for the outputs of extract and pack.
+  Every entry is stored in the cache folder under a key, that is the hash of:
+  - the tool version, the operation and the coder instructions
+  - the name of the target, since it names the produced files
+  - the content of the input, for folders including the relative file names
+  Entries are never invalidated, a changed input simply produces a new key. The folder can be deleted at any time.
+  The folder is given by the user, for example ".shccache" next to the build outputs.
+*/
+
+namespace ConversionCache
+{
+  // increase if the produced outputs change, so that old entries are no longer used
+  inline constexpr int TOOL_VERSION{ 2 };
+
+  // uses the block hasher of CanvasHash, so the key hash and the canvas hash share one implementation
+  class ContentHasher
+  {
+  private:
+    CanvasHash::Hasher hasher;
+  public:
+    ContentHasher();
+
+    void add(const void* data, size_t size);
+    void add(std::string_view str); // includes a terminator, so that following values can not merge with the string
+    void addInteger(uint64_t value);
+    void addFile(const std::filesystem::path& file);
+
+    uint64_t getHash() const;
+  };
+
+  class Cache
+  {
+  private:
+    std::filesystem::path folder;
+
+    std::filesystem::path getEntryPath(std::string_view key) const;
+  public:
+    explicit Cache(const std::filesystem::path& folder);
+
+    const std::filesystem::path& getFolder() const;
+
+    std::string createExtractKey(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+      const ExtractOptions& extractOptions) const;
+    std::string createPackKey(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions) const;
+
+    // restores the cached extract folder by copying it, since extracted files are intended to be edited
+    // returns false if no entry exists or restoring failed
+    bool tryRestoreExtract(std::string_view key, const std::filesystem::path& target) const;
+
+    // restores the cached packed file as a hard link, falls back to a copy if linking is not possible
+    // returns false if no entry exists or restoring failed
+    bool tryRestorePack(std::string_view key, const std::filesystem::path& target) const;
+
+    // stores the produced target, failures are only logged, since the cache is optional
+    void store(std::string_view key, const std::filesystem::path& target) const;
+  };
+}
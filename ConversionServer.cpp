@@ -0,0 +1,109 @@
+#include "ConversionServer.h"
+
+#include "Console.h"
+#include "JobFile.h"
+#include "ResourceMetaFormat.h"
+
+#include <mutex>
+#include <atomic>
+#include <format>
+#include <print>
+
+namespace ConversionServer
+{
+  static void writeResponse(std::ostream& out, std::mutex& outMutex, size_t requestIndex, const BatchOperations::BatchJobResult& result)
+  {
+    const std::lock_guard lock{ outMutex };
+    std::print(out, "RESULT {} {} {}\n", requestIndex, result.success ? "OK" : "FAIL", result.output.size());
+    out.write(result.output.data(), result.output.size());
+    out << std::flush; // the client waits for the answer
+  }
+
+  static void writeInvalidRequestResponse(std::ostream& out, std::mutex& outMutex, size_t requestIndex, const std::exception& error)
+  {
+    writeResponse(out, outMutex, requestIndex, BatchOperations::BatchJobResult{
+      .success{ false },
+      .duration{},
+      .output{ std::format("Invalid request: {}\n", error.what()) }
+    });
+  }
+
+  size_t serve(std::istream& in, std::ostream& out, TaskPool& pool, const ConversionCache::Cache* cache, ResourceCache::Cache* resourceCache,
+    const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions, TgxTextMode defaultTgxTextMode)
+  {
+    Log(LogLevel::INFO, "Waiting for request header.");
+    auto reader{ ResourceMetaFormat::ResourceMetaFileStreamReader::startFrom(in) };
+    Log(LogLevel::INFO, "Serving requests with {} threads.", pool.getThreadCount());
+
+    const std::filesystem::path baseFolder{ std::filesystem::current_path() };
+    std::mutex outMutex{};
+    std::atomic<size_t> failedRequests{ 0 };
+    size_t requestIndex{ 0 };
+    try
+    {
+      while (true)
+      {
+        std::optional<ResourceMetaFormat::ResourceMetaObjectReader> request{};
+        try
+        {
+          request = reader.next();
+        }
+        catch (const std::exception& e)
+        {
+          // a malformed object is answered like an invalid job, the server only stops if the input itself failed
+          const size_t currentIndex{ requestIndex++ };
+          ++failedRequests;
+          writeInvalidRequestResponse(out, outMutex, currentIndex, e);
+          if (!reader.skipMalformedObject())
+          {
+            Log(LogLevel::ERROR, "Request input failed after request {}: {}", currentIndex, e.what());
+            break;
+          }
+          continue;
+        }
+        if (!request)
+        {
+          break;
+        }
+
+        const size_t currentIndex{ requestIndex++ };
+        BatchOperations::BatchJob job;
+        try
+        {
+          job = JobFile::parseJob(*request, currentIndex, baseFolder, defaultInstructions, defaultExtractOptions, defaultTgxTextMode);
+          if (!job.target.empty())
+          {
+            std::filesystem::create_directories(job.target.parent_path());
+          }
+        }
+        catch (const std::exception& e)
+        {
+          ++failedRequests;
+          writeInvalidRequestResponse(out, outMutex, currentIndex, e);
+          continue;
+        }
+
+        Log(LogLevel::DEBUG, "Received request {} for '{}'.", currentIndex, job.source.string());
+        pool.submit([job{ std::move(job) }, cache, resourceCache, currentIndex, &out, &outMutex, &failedRequests]()
+          {
+            const BatchOperations::BatchJobResult result{ BatchOperations::runJob(job, cache, resourceCache) };
+            if (!result.success)
+            {
+              ++failedRequests;
+            }
+            writeResponse(out, outMutex, currentIndex, result);
+          });
+      }
+    }
+    catch (...)
+    {
+      // running requests still reference the local state
+      pool.waitForAll();
+      throw;
+    }
+    pool.waitForAll();
+
+    Log(LogLevel::INFO, "Input ended. Served {} requests.", requestIndex);
+    return failedRequests;
+  }
+}
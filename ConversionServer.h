@@ -0,0 +1,37 @@
+#pragma once
+
+#include "TGXCoder.h"
+#include "TaskPool.h"
+#include "ConversionCache.h"
+#include "ResourceCache.h"
+#include "ExtractOptions.h"
+
+#include <istream>
+#include <ostream>
+
+/*
+  Persistent conversion server, that keeps the worker threads and the caches of one process across many requests.
+  With a resource cache, loaded TGX and GM1 files stay in memory for following requests, until the file changes.
+
+  Requests are read from the input stream as resource meta file:
+  - The client first sends the RESOURCE_META_HEADER object.
+  - Every following Job object (see JobFile.h) is one request. It is started as soon as its terminating empty line is read.
+  - Relative paths are resolved against the working directory of the server.
+  - The server stops once the input ends and all requests are answered.
+
+  Every request is answered on the output stream, in order of completion:
+  """
+    RESULT <request index> <OK|FAIL> <output byte count>
+    <output bytes>
+  """
+  The request index counts the received Job objects, starting at 0. Logs are not part of the answer.
+  An object that can not be parsed is answered with FAIL and skipped until its terminating empty line.
+  If the input stream itself fails, the server logs the error and stops like at the end of the input.
+*/
+
+namespace ConversionServer
+{
+  // returns the number of failed requests, throws if the input does not start with a valid header
+  size_t serve(std::istream& in, std::ostream& out, TaskPool& pool, const ConversionCache::Cache* cache, ResourceCache::Cache* resourceCache,
+    const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions, TgxTextMode defaultTgxTextMode);
+}
@@ -0,0 +1,335 @@
+#include "CorpusGenerator.h"
+
+#include "Console.h"
+#include "Utility.h"
+#include "Gm1Coder.h"
+#include "TGXFile.h"
+#include "GM1File.h"
+
+#include <vector>
+#include <string>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace CorpusGenerator
+{
+  // same as the alpha the TGX coder uses for indexed colors, the lower byte is the palette index
+  static constexpr uint16_t INDEXED_COLOR_ALPHA{ 0xff00 };
+  static constexpr uint16_t OPAQUE_ALPHA_BIT{ 0x8000 };
+
+  enum class PixelKind
+  {
+    DEFAULT,
+    INDEXED,
+    OPAQUE, // no transparency, for uncompressed data and tiles
+  };
+
+  static uint16_t createColor(SplitMix64& random, const PixelKind kind, const TgxCoderInstruction& instructions)
+  {
+    if (kind == PixelKind::INDEXED)
+    {
+      return INDEXED_COLOR_ALPHA | static_cast<uint16_t>(random.nextBelow(256));
+    }
+    uint16_t color{ static_cast<uint16_t>(OPAQUE_ALPHA_BIT | random.nextBelow(OPAQUE_ALPHA_BIT)) };
+    if (color == instructions.transparentPixelRawColor || color == instructions.transparentPixelTgxColor)
+    {
+      color ^= 1; // keep special colors out of the data
+    }
+    return color;
+  }
+
+  static std::vector<uint16_t> generateRaw(SplitMix64& random, const int width, const int height, const PixelKind kind, const GeneratorSettings& settings)
+  {
+    const TgxCoderInstruction& instructions{ settings.instructions };
+    std::vector<uint16_t> raw(static_cast<size_t>(width) * height);
+    size_t index{ 0 };
+    for (int y{ 0 }; y < height; ++y)
+    {
+      for (int x{ 0 }; x < width;)
+      {
+        const int runLength{ std::min(width - x, 1 + static_cast<int>(random.nextBelow(settings.maxRunLength))) };
+        const uint32_t runKind{ random.nextBelow(100) };
+        if (kind != PixelKind::OPAQUE && runKind < static_cast<uint32_t>(settings.transparencyPercent))
+        {
+          std::fill_n(raw.begin() + index, runLength, instructions.transparentPixelRawColor);
+        }
+        else if (random.nextBelow(100) < static_cast<uint32_t>(settings.repeatPercent))
+        {
+          std::fill_n(raw.begin() + index, runLength, createColor(random, kind, instructions));
+        }
+        else
+        {
+          for (int i{ 0 }; i < runLength; ++i)
+          {
+            raw[index + i] = createColor(random, kind, instructions);
+          }
+        }
+        index += runLength;
+        x += runLength;
+      }
+    }
+    return raw;
+  }
+
+  static void appendTgx(std::vector<uint8_t>& outData, std::vector<uint16_t>& raw, const int width, const int height,
+    const TgxColorType colorType, const TgxCoderInstruction& instructions)
+  {
+    const TgxCoderRawInfo rawInfo{
+      .data{ raw.data() },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 }
+    };
+    TgxCoderTgxInfo tgxInfo{
+      .colorType{ colorType },
+      .data{ nullptr },
+      .dataSize{ 0 },
+      .tgxWidth{ width },
+      .tgxHeight{ height }
+    };
+    const TgxCoderResult sizeResult{ encodeRawToTgx(&rawInfo, &tgxInfo, &instructions) };
+    if (sizeResult != TgxCoderResult::FILLED_ENCODING_SIZE)
+    {
+      throw std::runtime_error{ getTgxResultDescription(sizeResult) };
+    }
+    const size_t start{ outData.size() };
+    outData.resize(start + tgxInfo.dataSize);
+    tgxInfo.data = outData.data() + start;
+    const TgxCoderResult result{ encodeRawToTgx(&rawInfo, &tgxInfo, &instructions) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      throw std::runtime_error{ getTgxResultDescription(result) };
+    }
+    outData.resize(start + tgxInfo.dataSize);
+  }
+
+  static void appendTile(std::vector<uint8_t>& outData, std::vector<uint16_t>& raw)
+  {
+    const Gm1CoderRawInfo rawInfo{
+      .raw{ raw.data() },
+      .rawWidth{ TILE_WIDTH },
+      .rawHeight{ TILE_HEIGHT },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+    const size_t start{ outData.size() };
+    outData.resize(start + TILE_BYTE_SIZE);
+    const Gm1CoderResult result{ encodeRawToTile(&rawInfo, reinterpret_cast<uint16_t*>(outData.data() + start)) };
+    if (result != Gm1CoderResult::SUCCESS)
+    {
+      throw std::runtime_error{ getGm1ResultDescription(result) };
+    }
+  }
+
+  static void appendUncompressed(std::vector<uint8_t>& outData, std::vector<uint16_t>& raw, const int width, const int height,
+    const TgxCoderInstruction& instructions)
+  {
+    const Gm1CoderRawInfo rawInfo{
+      .raw{ raw.data() },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+    Gm1CoderDataInfo dataInfo{
+      .data{ nullptr },
+      .dataSize{ 0 },
+      .dataWidth{ width },
+      .dataHeight{ height },
+    };
+    const Gm1CoderResult sizeResult{ copyRawToUncompressed(&rawInfo, &dataInfo, instructions.transparentPixelRawColor) };
+    if (sizeResult != Gm1CoderResult::FILLED_ENCODING_SIZE)
+    {
+      throw std::runtime_error{ getGm1ResultDescription(sizeResult) };
+    }
+    const size_t start{ outData.size() };
+    outData.resize(start + dataInfo.dataSize);
+    dataInfo.data = outData.data() + start;
+    const Gm1CoderResult result{ copyRawToUncompressed(&rawInfo, &dataInfo, instructions.transparentPixelRawColor) };
+    if (result != Gm1CoderResult::SUCCESS)
+    {
+      throw std::runtime_error{ getGm1ResultDescription(result) };
+    }
+  }
+
+  static void generateTgxFile(const std::filesystem::path& file, SplitMix64& random, const GeneratorSettings& settings)
+  {
+    std::vector<uint16_t> raw{ generateRaw(random, settings.width, settings.height, PixelKind::DEFAULT, settings) };
+    std::vector<uint8_t> data{};
+    appendTgx(data, raw, settings.width, settings.height, TgxColorType::DEFAULT, settings.instructions);
+
+    const uint32_t resourceSize{ static_cast<uint32_t>(sizeof(TgxHeader) + data.size()) };
+    TGXFile::UniqueTgxResourcePointer resource{ createWithAdditionalMemory<TgxResource>(resourceSize) };
+    resource->base.type = SHCResourceType::SHC_RESOURCE_TGX;
+    resource->base.resourceSize = resourceSize;
+    resource->base.colorFormat = PixeColorFormat::ARGB_1555;
+    resource->dataSize = static_cast<uint32_t>(data.size());
+    resource->header = reinterpret_cast<TgxHeader*>(reinterpret_cast<uint8_t*>(resource.get()) + sizeof(TgxResource));
+    resource->imageData = reinterpret_cast<uint8_t*>(resource->header) + sizeof(TgxHeader);
+    resource->header->width = settings.width;
+    resource->header->height = settings.height;
+    std::memcpy(resource->imageData, data.data(), data.size());
+
+    TGXFile::saveTgxResource(file, *resource);
+  }
+
+  static void generateGm1File(const std::filesystem::path& file, const Gm1Type type, SplitMix64& random, const GeneratorSettings& settings)
+  {
+    const uint32_t imageCount{ static_cast<uint32_t>(settings.imageCount) };
+    std::vector<Gm1Image> images(imageCount);
+    std::vector<uint32_t> offsets(imageCount);
+    std::vector<uint32_t> sizes(imageCount);
+    std::vector<uint8_t> data{};
+
+    for (uint32_t i{ 0 }; i < imageCount; ++i)
+    {
+      Gm1Image& image{ images[i] };
+      image = Gm1Image{};
+      offsets[i] = static_cast<uint32_t>(data.size());
+
+      switch (type)
+      {
+      case Gm1Type::GM1_TYPE_INTERFACE:
+      case Gm1Type::GM1_TYPE_TGX_CONST_SIZE:
+      case Gm1Type::GM1_TYPE_FONT:
+      case Gm1Type::GM1_TYPE_ANIMATIONS:
+      {
+        const bool indexed{ type == Gm1Type::GM1_TYPE_ANIMATIONS };
+        std::vector<uint16_t> raw{ generateRaw(random, settings.width, settings.height, indexed ? PixelKind::INDEXED : PixelKind::DEFAULT, settings) };
+        appendTgx(data, raw, settings.width, settings.height, indexed ? TgxColorType::INDEXED : TgxColorType::DEFAULT, settings.instructions);
+        image.imageHeader.width = static_cast<uint16_t>(settings.width);
+        image.imageHeader.height = static_cast<uint16_t>(settings.height);
+        break;
+      }
+      case Gm1Type::GM1_TYPE_TILES_OBJECT:
+      {
+        // every image is a single part object with an image part on top of the tile
+        std::vector<uint16_t> tileRaw{ generateRaw(random, TILE_WIDTH, TILE_HEIGHT, PixelKind::OPAQUE, settings) };
+        appendTile(data, tileRaw);
+
+        const int imageWidth{ std::min(settings.width, TILE_WIDTH) };
+        const int imageHeight{ settings.height };
+        std::vector<uint16_t> imageRaw{ generateRaw(random, imageWidth, imageHeight, PixelKind::DEFAULT, settings) };
+        appendTgx(data, imageRaw, imageWidth, imageHeight, TgxColorType::DEFAULT, settings.instructions);
+
+        image.imageHeader.width = static_cast<uint16_t>(TILE_WIDTH);
+        image.imageHeader.height = static_cast<uint16_t>(imageHeight - GM1File::TILE_IMAGE_HEIGHT_OFFSET + TILE_HEIGHT);
+        Gm1TileObjectImageInfo& tileObjectInfo{ image.imageInfo.tileObjectImageInfo };
+        tileObjectInfo.imagePart = 0;
+        tileObjectInfo.subParts = 1;
+        tileObjectInfo.tileOffset = static_cast<uint16_t>(imageHeight - GM1File::TILE_IMAGE_HEIGHT_OFFSET);
+        tileObjectInfo.imagePosition = Gm1TileObjectImagePosition::TOP;
+        tileObjectInfo.imageOffsetX = 0;
+        tileObjectInfo.imageWidth = static_cast<uint8_t>(imageWidth);
+        break;
+      }
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_1:
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_2:
+      {
+        // the uncompressed format only allows transparency in whole lines at the end
+        std::vector<uint16_t> raw{ generateRaw(random, settings.width, settings.height, PixelKind::OPAQUE, settings) };
+        appendUncompressed(data, raw, settings.width, settings.height, settings.instructions);
+        image.imageHeader.width = static_cast<uint16_t>(settings.width);
+        image.imageHeader.height = static_cast<uint16_t>(settings.height);
+        break;
+      }
+
+      default:
+        throw std::runtime_error{ "Resource has unknown type." };
+      }
+      // placed next to each other, so that an extracted canvas shows all images
+      image.imageHeader.offsetX = static_cast<uint16_t>(i * image.imageHeader.width);
+      sizes[i] = static_cast<uint32_t>(data.size()) - offsets[i];
+    }
+
+    const uint32_t resourceSize{ static_cast<uint32_t>(sizeof(Gm1Header) + (2 * sizeof(uint32_t) + sizeof(Gm1Image)) * imageCount + data.size()) };
+    GM1File::UniqueGm1ResourcePointer resource{ createWithAdditionalMemory<Gm1Resource>(resourceSize) };
+    resource->base.type = SHCResourceType::SHC_RESOURCE_GM1;
+    resource->base.resourceSize = resourceSize;
+    resource->base.colorFormat = PixeColorFormat::ARGB_1555;
+    resource->gm1Header = reinterpret_cast<Gm1Header*>(reinterpret_cast<uint8_t*>(resource.get()) + sizeof(Gm1Resource));
+    resource->imageOffsets = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(resource->gm1Header) + sizeof(Gm1Header));
+    resource->imageSizes = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(resource->imageOffsets) + sizeof(uint32_t) * imageCount);
+    resource->imageHeaders = reinterpret_cast<Gm1Image*>(reinterpret_cast<uint8_t*>(resource->imageSizes) + sizeof(uint32_t) * imageCount);
+    resource->imageData = reinterpret_cast<uint8_t*>(resource->imageHeaders) + sizeof(Gm1Image) * imageCount;
+
+    Gm1Header& header{ *resource->gm1Header };
+    header = Gm1Header{};
+    header.info.numberOfPicturesInFile = imageCount;
+    header.info.gm1Type = type;
+    header.info.width = images.empty() ? 0 : images.front().imageHeader.width;
+    header.info.height = images.empty() ? 0 : images.front().imageHeader.height;
+    header.info.dataSize = static_cast<uint32_t>(data.size());
+    if (type == Gm1Type::GM1_TYPE_ANIMATIONS)
+    {
+      for (auto& palette : header.colorPalette)
+      {
+        for (uint16_t& color : palette)
+        {
+          color = createColor(random, PixelKind::DEFAULT, settings.instructions);
+        }
+      }
+    }
+
+    std::copy(offsets.begin(), offsets.end(), resource->imageOffsets);
+    std::copy(sizes.begin(), sizes.end(), resource->imageSizes);
+    std::copy(images.begin(), images.end(), resource->imageHeaders);
+    std::memcpy(resource->imageData, data.data(), data.size());
+
+    GM1File::saveGm1Resource(file, *resource);
+  }
+
+  int generateCorpus(const std::filesystem::path& folder, const GeneratorSettings& settings)
+  {
+    if (settings.width < 1 || settings.height < 1 || settings.imageCount < 1 || settings.maxRunLength < 1)
+    {
+      throw std::invalid_argument{ "Size, image count and run length need to be at least 1." };
+    }
+    if (settings.height <= GM1File::TILE_IMAGE_HEIGHT_OFFSET)
+    {
+      throw std::invalid_argument{ std::format("Height needs to be bigger than {} for tile objects.", GM1File::TILE_IMAGE_HEIGHT_OFFSET) };
+    }
+    // the images of a GM1 file are placed next to each other and their 16 bit x offsets need to reach the last one
+    const uint64_t rowWidth{ static_cast<uint64_t>(settings.imageCount) * std::max(settings.width, TILE_WIDTH) };
+    if (rowWidth > std::numeric_limits<uint16_t>::max())
+    {
+      throw std::invalid_argument{ std::format("Image count times width ({}) needs to be at most {}.", rowWidth, std::numeric_limits<uint16_t>::max()) };
+    }
+    std::filesystem::create_directories(folder);
+
+    constexpr Gm1Type GM1_TYPES[]{
+      Gm1Type::GM1_TYPE_INTERFACE,
+      Gm1Type::GM1_TYPE_ANIMATIONS,
+      Gm1Type::GM1_TYPE_TILES_OBJECT,
+      Gm1Type::GM1_TYPE_FONT,
+      Gm1Type::GM1_TYPE_NO_COMPRESSION_1,
+      Gm1Type::GM1_TYPE_TGX_CONST_SIZE,
+      Gm1Type::GM1_TYPE_NO_COMPRESSION_2,
+    };
+
+    // every file has its own stream, so that single files stay the same if others change
+    int fileCount{ 0 };
+    {
+      SplitMix64 random{ settings.seed };
+      std::filesystem::path file{ folder / "synthetic" };
+      file.replace_extension(TGXFile::FILE_EXTENSION);
+      Log(LogLevel::INFO, "Generating '{}'.", file.string());
+      generateTgxFile(file, random, settings);
+      ++fileCount;
+    }
+    for (const Gm1Type type : GM1_TYPES)
+    {
+      SplitMix64 random{ settings.seed ^ (static_cast<uint64_t>(type) << 32) };
+      std::filesystem::path file{ folder / std::format("synthetic_{}", type) };
+      file.replace_extension(GM1File::FILE_EXTENSION);
+      Log(LogLevel::INFO, "Generating '{}'.", file.string());
+      generateGm1File(file, type, random, settings);
+      ++fileCount;
+    }
+    return fileCount;
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TGXCoder.h"
+
+#include <filesystem>
+
+// creates deterministic synthetic TGX and GM1 files with the existing encoders
+// intended for benchmarks and regression tests, since the game assets can not be shared
+// the same settings and seed always produce the same files, independent of the platform
+
+namespace CorpusGenerator
+{
+  // splitmix64, used instead of the std engines and distributions, since their results are not defined across platforms
+  class SplitMix64
+  {
+  private:
+    uint64_t state;
+  public:
+    explicit SplitMix64(uint64_t seed) : state{ seed }
+    {
+    }
+
+    uint64_t next()
+    {
+      uint64_t value{ state += 0x9e3779b97f4a7c15ull };
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+      return value ^ (value >> 31);
+    }
+
+    // slightly biased for big bounds, which does not matter here
+    uint32_t nextBelow(uint32_t bound)
+    {
+      return static_cast<uint32_t>(next() % bound);
+    }
+  };
+
+  struct GeneratorSettings
+  {
+    uint64_t seed;
+    int width; // size of the images, tile objects use it for the width and height of their image part
+    int height;
+    int imageCount; // images per GM1 file
+    int transparencyPercent; // chance that a pixel run is transparent
+    int repeatPercent; // chance that a not transparent pixel run repeats one color
+    int maxRunLength; // runs have a length between 1 and this value
+    TgxCoderInstruction instructions;
+  };
+
+  inline constexpr GeneratorSettings DEFAULT_SETTINGS{
+    .seed{ 1 },
+    .width{ 64 },
+    .height{ 64 },
+    .imageCount{ 16 },
+    .transparencyPercent{ 30 },
+    .repeatPercent{ 30 },
+    .maxRunLength{ 16 },
+    .instructions{ TGX_FILE_DEFAULT_INSTRUCTION }
+  };
+
+  // creates one TGX file and one GM1 file per Gm1Type in the folder
+  // the image count times the width, or the tile width if it is bigger, needs to fit the 16 bit image offsets
+  // returns the number of created files, throws if the settings are invalid or encoding or writing fails
+  int generateCorpus(const std::filesystem::path& folder, const GeneratorSettings& settings);
+}
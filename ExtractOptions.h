@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PixelConversion.h"
+#include "PngFile.h"
+#include "RawCompression.h"
+
+// options that only change the files written by extract, everything needed to pack again is recorded in the resource meta file
+
+// value of pngPalette that writes one PNG per palette
+inline constexpr int PNG_ALL_PALETTES{ -1 };
+
+struct ExtractOptions
+{
+  PngFile::PngFormat pngFormat; // writes the canvas additionally as PNG next to the raw data
+  PixelConversion::RawPixelFormat rawPixelFormat; // pixel format of the raw data file, recorded in the resource meta
+  int pngPalette; // palette that resolves the indices of animations in the PNG, or PNG_ALL_PALETTES
+  RawCompression::Compression dataCompression; // compression of the raw data file, recorded in the resource meta
+  bool tunePixelRepeatThreshold; // searches the pixel repeat threshold with the smallest TGX per image, recorded in the resource meta
+  bool keepOriginalEncoding; // keeps the encoded data and records a hash per image region, so pack copies the images that did not change
+};
+
+inline constexpr ExtractOptions DEFAULT_EXTRACT_OPTIONS{
+  .pngFormat{ PngFile::PngFormat::NONE },
+  .rawPixelFormat{ PixelConversion::RawPixelFormat::ARGB_1555 },
+  .pngPalette{ 0 },
+  .dataCompression{ RawCompression::Compression::NONE },
+  .tunePixelRepeatThreshold{ false },
+  .keepOriginalEncoding{ false },
+};
@@ -2,11 +2,16 @@
 
 #include "Gm1Coder.h"
 
+#include "CanvasHash.h"
 #include "Console.h"
 #include "ResourceMetaFormat.h"
+#include "Timings.h"
 
+#include <array>
 #include <fstream>
+#include <optional>
 #include <span>
+#include <vector>
 
 // TODO: the tile coder might actually need to be precise and not write transparency, assuming the images are
 // placed on the canvas. Should it turn out that this is the case, either the coder needs to be different, or
@@ -75,7 +80,19 @@ namespace GM1File
     return true;
   }
 
-  static bool validateGm1TgxResource(const Gm1Resource& resource, bool tgxAsText)
+  // adds the image to the summed analysis, the worst row is labeled with the image index
+  static void addGm1ImageDetailedAnalysis(TgxDetailedAnalysis& detailedAnalysis, const TgxCoderTgxInfo& tgxInfo, const size_t imageIndex)
+  {
+    TgxDetailedAnalysis imageAnalysis{};
+    if (analyzeTgxDetailed(tgxInfo, imageAnalysis) != TgxCoderResult::SUCCESS)
+    {
+      return; // only called after the structure was validated
+    }
+    imageAnalysis.worstRowSource = std::format("image {}", imageIndex);
+    addTgxDetailedAnalysis(detailedAnalysis, imageAnalysis);
+  }
+
+  static bool validateGm1TgxResource(const Gm1Resource& resource, TgxTextMode tgxTextMode, TgxDetailedAnalysis& detailedAnalysis)
   {
     for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
     {
@@ -110,12 +127,13 @@ namespace GM1File
         return false;
       }
       Out("# Structure Meta Data #\n{}\n\n", tgxAnalysis);
-      if (!tgxAsText)
+      addGm1ImageDetailedAnalysis(detailedAnalysis, tgxInfo, i);
+      if (tgxTextMode == TgxTextMode::NONE)
       {
         continue;
       }
       Log(LogLevel::INFO, "Printing TGX as text to stdout.");
-      const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, STD_OUT) };
+      const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, getOutStream(), tgxTextMode) };
       if (toTextResult != TgxCoderResult::SUCCESS)
       {
         Out("{}\n", std::string_view{ getTgxResultDescription(toTextResult) });
@@ -128,7 +146,7 @@ namespace GM1File
     return true;
   }
 
-  static bool validateGm1TileObjectResource(const Gm1Resource& resource, bool tgxAsText)
+  static bool validateGm1TileObjectResource(const Gm1Resource& resource, TgxTextMode tgxTextMode, TgxDetailedAnalysis& detailedAnalysis)
   {
     for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
     {
@@ -175,12 +193,13 @@ namespace GM1File
         return false;
       }
       Out("# Structure Meta Data #\n{}\n\n", tgxAnalysis);
-      if (!tgxAsText)
+      addGm1ImageDetailedAnalysis(detailedAnalysis, tgxInfo, i);
+      if (tgxTextMode == TgxTextMode::NONE)
       {
         continue;
       }
       Log(LogLevel::INFO, "Printing TGX as text to stdout.");
-      const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, STD_OUT) };
+      const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, getOutStream(), tgxTextMode) };
       if (toTextResult != TgxCoderResult::SUCCESS)
       {
         Out("{}\n", std::string_view{ getTgxResultDescription(toTextResult) });
@@ -193,9 +212,11 @@ namespace GM1File
     return true;
   }
 
-  void validateGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions, bool tgxAsText)
+  bool validateGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions, TgxTextMode tgxTextMode,
+    TgxDetailedAnalysis* detailedAnalysis)
   {
     Log(LogLevel::INFO, "Try validating given resource.");
+    const Timings::PhaseTimer validationTimer{ Timings::Phase::VALIDATION, resource.gm1Header->info.dataSize };
 
     Out("### General GM1 info ###\nType: {}\nNumber of pictures: {}\nImage data size: {}\n\n",
       resource.gm1Header->info.gm1Type, resource.gm1Header->info.numberOfPicturesInFile, resource.gm1Header->info.dataSize);
@@ -203,16 +224,17 @@ namespace GM1File
     Out("### GM1 Header ###\n{}\n\n", *resource.gm1Header);
 
     bool validationSuccessful{ false };
+    TgxDetailedAnalysis gm1DetailedAnalysis{};
     switch (resource.gm1Header->info.gm1Type)
     {
     case Gm1Type::GM1_TYPE_INTERFACE:
     case Gm1Type::GM1_TYPE_TGX_CONST_SIZE:
     case Gm1Type::GM1_TYPE_FONT:
     case Gm1Type::GM1_TYPE_ANIMATIONS:
-      validationSuccessful = validateGm1TgxResource(resource, tgxAsText);
+      validationSuccessful = validateGm1TgxResource(resource, tgxTextMode, gm1DetailedAnalysis);
       break;
     case Gm1Type::GM1_TYPE_TILES_OBJECT:
-      validationSuccessful = validateGm1TileObjectResource(resource, tgxAsText);
+      validationSuccessful = validateGm1TileObjectResource(resource, tgxTextMode, gm1DetailedAnalysis);
       break;
     case Gm1Type::GM1_TYPE_NO_COMPRESSION_1:
     case Gm1Type::GM1_TYPE_NO_COMPRESSION_2:
@@ -226,6 +248,14 @@ namespace GM1File
 
     if (validationSuccessful)
     {
+      if (gm1DetailedAnalysis.imageCount > 0)
+      {
+        Out("### Detailed analysis of all TGX images ###\n{}\n\n", gm1DetailedAnalysis);
+      }
+      if (detailedAnalysis)
+      {
+        *detailedAnalysis = std::move(gm1DetailedAnalysis);
+      }
       Out("### GM1 seems valid ###\n");
       Log(LogLevel::INFO, "Validation completed successfully.");
     }
@@ -234,11 +264,13 @@ namespace GM1File
       Out("\n### GM1 seems invalid. Remaining checks are skipped. ###\n");
       Log(LogLevel::ERROR, "Validation completed. TGX is invalid.");
     }
+    return validationSuccessful;
   }
 
   UniqueGm1ResourcePointer loadGm1Resource(const std::filesystem::path& file)
   {
     Log(LogLevel::INFO, "Try loading GM1 file.");
+    Timings::PhaseTimer statTimer{ Timings::Phase::FILE_STAT };
     if (!std::filesystem::is_regular_file(file))
     {
       Log(LogLevel::ERROR, "Provided GM1 file is not a regular file.");
@@ -256,7 +288,9 @@ namespace GM1File
       return {};
     }
     const uint32_t size{ static_cast<uint32_t>(fileSize) };
+    statTimer.stop();
 
+    Timings::PhaseTimer headerLoadTimer{ Timings::Phase::LOAD, sizeof(Gm1Header) };
     std::ifstream in;
     in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     in.open(file, std::ios::in | std::ios::binary);
@@ -269,7 +303,9 @@ namespace GM1File
     Log(LogLevel::DEBUG, "Loading GM1 header.");
     in.read(reinterpret_cast<char*>(resource.get()) + sizeof(Gm1Resource), sizeof(Gm1Header));
     resource->gm1Header = reinterpret_cast<Gm1Header*>(reinterpret_cast<uint8_t*>(resource.get()) + sizeof(Gm1Resource));
+    headerLoadTimer.stop();
 
+    Timings::PhaseTimer headerValidationTimer{ Timings::Phase::HEADER_VALIDATION, sizeof(Gm1Header) };
     const uint32_t numberOfImages{ resource->gm1Header->info.numberOfPicturesInFile };
     const uint32_t gm1BodySize{ size - sizeof(Gm1Header) };
 
@@ -285,13 +321,17 @@ namespace GM1File
       Log(LogLevel::ERROR, "Provided GM1 header does not specify known GM1 type.");
       return {};
     }
+    headerValidationTimer.stop();
+    Timings::setCurrentType(std::format("{}", resource->gm1Header->info.gm1Type));
 
     Log(LogLevel::DEBUG, "Loading GM1 body.");
+    Timings::PhaseTimer bodyLoadTimer{ Timings::Phase::LOAD, gm1BodySize };
     in.read(reinterpret_cast<char*>(resource.get()) + sizeof(Gm1Resource) + sizeof(Gm1Header), gm1BodySize);
     resource->imageOffsets = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(resource->gm1Header) + sizeof(Gm1Header));
     resource->imageSizes = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(resource->imageOffsets) + sizeof(uint32_t) * numberOfImages);
     resource->imageHeaders = reinterpret_cast<Gm1Image*>(reinterpret_cast<uint8_t*>(resource->imageSizes) + sizeof(uint32_t) * numberOfImages);
     resource->imageData = reinterpret_cast<uint8_t*>(resource->imageHeaders) + sizeof(Gm1Image) * numberOfImages;
+    bodyLoadTimer.stop();
 
     // individual images are not checked without explicit validation
 
@@ -306,8 +346,12 @@ namespace GM1File
     std::filesystem::create_directories(file.parent_path());
     Log(LogLevel::DEBUG, "Created directories.");
 
+    // removed instead of truncated, so that hard linked copies of the old file stay untouched
+    std::filesystem::remove(file);
+
     // inner block, to wrap file action
     {
+      const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, resource.base.resourceSize };
       std::ofstream out;
       out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
       out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
@@ -441,7 +485,7 @@ namespace GM1File
   }
 
   static bool readGm1ImageHeaderFromResourceMetaObject(const ResourceMetaFormat::ResourceMetaObjectReader& metaObject,
-    uint32_t& outOffset, uint32_t& outSize, Gm1ImageHeader& outImageHeader)
+    uint32_t& outOffset, uint32_t& outSize, Gm1ImageHeader& outImageHeader, std::optional<uint64_t>& outCanvasHash)
   {
     Log(LogLevel::DEBUG, "Read Gm1ImageHeader object from meta file.");
     if (!isExpectedMetaObject(metaObject.getIdentifier(), Gm1ImageHeaderMeta::RESOURCE_IDENTIFIER, metaObject.getVersion(), Gm1ImageHeaderMeta::SUPPORTED_VERSIONS))
@@ -449,10 +493,14 @@ namespace GM1File
       return false;
     }
     // version currently ignored, since only one available
-    if (!hasExpectedEntryNumber(metaObject, Gm1ImageHeaderMeta::MAP_ENTRIES, Gm1ImageHeaderMeta::LIST_ENTRIES))
+    const auto& mapEntries{ metaObject.getMapEntries() };
+    const auto canvasHashEntry{ mapEntries.find(Gm1ImageHeaderMeta::CANVAS_HASH_KEY) };
+    const bool hasCanvasHash{ canvasHashEntry != mapEntries.end() };
+    if (!hasExpectedEntryNumber(metaObject, Gm1ImageHeaderMeta::MAP_ENTRIES + (hasCanvasHash ? 1 : 0), Gm1ImageHeaderMeta::LIST_ENTRIES))
     {
       return false;
     }
+    outCanvasHash = hasCanvasHash ? std::optional{ uintFromStr<uint64_t>(canvasHashEntry->second) } : std::nullopt;
 
     const auto& imageOffset{ getResourceObjectMapEntry(metaObject, Gm1ImageHeaderMeta::RESOURCE_IDENTIFIER, Gm1ImageHeaderMeta::OFFSET_KEY) };
     if (!imageOffset)
@@ -540,6 +588,7 @@ namespace GM1File
       const Gm1Image& image{ resource.imageHeaders[i] };
       const uint32_t offset{ resource.imageOffsets[i] };
       const uint32_t size{ resource.imageSizes[i] };
+      const Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, size };
 
       const Gm1CoderDataInfo dataInfo{
         .data{ resource.imageData + offset },
@@ -569,6 +618,7 @@ namespace GM1File
       const Gm1Image& image{ resource.imageHeaders[i] };
       const uint32_t offset{ resource.imageOffsets[i] };
       const uint32_t size{ resource.imageSizes[i] };
+      const Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, size };
 
       const TgxCoderTgxInfo tgxInfo{
         .colorType{ resource.gm1Header->info.gm1Type == Gm1Type::GM1_TYPE_ANIMATIONS ? TgxColorType::INDEXED : TgxColorType::DEFAULT },
@@ -592,6 +642,99 @@ namespace GM1File
     }
   }
 
+  // values decodeTgxToRaw writes for indexed pixels, so the indexed canvas can be one of the targets of the palette decoder
+  static constexpr std::array<uint16_t, 256> INDEXED_RAW_PALETTE{ []
+    {
+      std::array<uint16_t, 256> palette{};
+      for (size_t i{ 0 }; i < palette.size(); ++i)
+      {
+        palette[i] = static_cast<uint16_t>(0xff00 | i);
+      }
+      return palette;
+    }() };
+
+  // decodes the indexed canvas and the canvases resolved through the selected palettes in one pass over every image
+  // without outData, only the palette canvases are decoded
+  static void decodeGm1AnimationResource(const Gm1Resource& resource, const int rawWidth, const int rawHeight, uint16_t* outData,
+    std::span<const int> palettes, std::span<const std::unique_ptr<uint16_t[]>> outPaletteData)
+  {
+    std::vector<uint16_t*> canvases;
+    std::vector<const uint16_t*> colorTables;
+    if (outData)
+    {
+      canvases.push_back(outData);
+      colorTables.push_back(INDEXED_RAW_PALETTE.data());
+    }
+    for (size_t i{ 0 }; i < palettes.size(); ++i)
+    {
+      canvases.push_back(outPaletteData[i].get());
+      colorTables.push_back(resource.gm1Header->colorPalette[palettes[i]]);
+    }
+
+    for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
+    {
+      const Gm1Image& image{ resource.imageHeaders[i] };
+      const uint32_t offset{ resource.imageOffsets[i] };
+      const uint32_t size{ resource.imageSizes[i] };
+      const Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, size };
+
+      const TgxCoderTgxInfo tgxInfo{
+        .colorType{ TgxColorType::INDEXED },
+        .data{ resource.imageData + offset },
+        .dataSize{ size },
+        .tgxWidth{ image.imageHeader.width },
+        .tgxHeight{ image.imageHeader.height }
+      };
+      const TgxCoderPaletteRawInfo rawInfo{
+        .data{ canvases.data() },
+        .palettes{ colorTables.data() },
+        .paletteCount{ static_cast<int>(canvases.size()) },
+        .rawWidth{ rawWidth },
+        .rawHeight{ rawHeight },
+        .rawX{ image.imageHeader.offsetX },
+        .rawY{ image.imageHeader.offsetY },
+      };
+      const TgxCoderResult result{ decodeIndexedTgxToPaletteRaw(&tgxInfo, &rawInfo) };
+      if (result != TgxCoderResult::SUCCESS)
+      {
+        throw std::exception{ getTgxResultDescription(result) };
+      }
+    }
+  }
+
+  static void decodeGm1IndexedAnimationResource(const Gm1Resource& resource, const int rawWidth, const int rawHeight, uint8_t* outData,
+    uint8_t* outMask)
+  {
+    for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
+    {
+      const Gm1Image& image{ resource.imageHeaders[i] };
+      const uint32_t offset{ resource.imageOffsets[i] };
+      const uint32_t size{ resource.imageSizes[i] };
+      const Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, size };
+
+      const TgxCoderTgxInfo tgxInfo{
+        .colorType{ TgxColorType::INDEXED },
+        .data{ resource.imageData + offset },
+        .dataSize{ size },
+        .tgxWidth{ image.imageHeader.width },
+        .tgxHeight{ image.imageHeader.height }
+      };
+      TgxCoderIndexedRawInfo rawInfo{
+        .data{ outData },
+        .mask{ outMask },
+        .rawWidth{ rawWidth },
+        .rawHeight{ rawHeight },
+        .rawX{ image.imageHeader.offsetX },
+        .rawY{ image.imageHeader.offsetY },
+      };
+      const TgxCoderResult result{ decodeIndexedTgxToIndexedRaw(&tgxInfo, &rawInfo) };
+      if (result != TgxCoderResult::SUCCESS)
+      {
+        throw std::exception{ getTgxResultDescription(result) };
+      }
+    }
+  }
+
   static void decodeGm1TileObjectResource(const Gm1Resource& resource, const int rawWidth, const int rawHeight, uint16_t* outData)
   {
     for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
@@ -599,6 +742,7 @@ namespace GM1File
       const Gm1Image& image{ resource.imageHeaders[i] };
       const uint32_t offset{ resource.imageOffsets[i] };
       const uint32_t size{ resource.imageSizes[i] };
+      const Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, size };
 
       // the size contains the tile, so this should work
       Gm1CoderRawInfo rawTileInfo{
@@ -645,33 +789,34 @@ namespace GM1File
   {
     Log(LogLevel::DEBUG, "Write Gm1Header info object to meta file.");
     metaWriter.startObject(Gm1HeaderMeta::RESOURCE_IDENTIFIER, Gm1HeaderMeta::CURRENT_VERSION)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x0), Gm1HeaderMeta::COMMENT_UNKNOWN_0x0)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x4), Gm1HeaderMeta::COMMENT_UNKNOWN_0x4)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x8), Gm1HeaderMeta::COMMENT_UNKNOWN_0x8)
-      .writeListEntry(std::to_string(headerInfo.numberOfPicturesInFile), Gm1HeaderMeta::COMMENT_NUMBER_OF_PICTURES_IN_FILE)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x10), Gm1HeaderMeta::COMMENT_UNKNOWN_0x10)
-      .writeListEntry(std::to_string(static_cast<int32_t>(headerInfo.gm1Type)), Gm1HeaderMeta::COMMENT_GM1_TYPE)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x18), Gm1HeaderMeta::COMMENT_UNKNOWN_0x18)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x1C), Gm1HeaderMeta::COMMENT_UNKNOWN_0x1C)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x20), Gm1HeaderMeta::COMMENT_UNKNOWN_0x20)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x24), Gm1HeaderMeta::COMMENT_UNKNOWN_0x24)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x28), Gm1HeaderMeta::COMMENT_UNKNOWN_0x28)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x2C), Gm1HeaderMeta::COMMENT_UNKNOWN_0x2C)
-      .writeListEntry(std::to_string(headerInfo.width), Gm1HeaderMeta::COMMENT_WIDTH)
-      .writeListEntry(std::to_string(headerInfo.height), Gm1HeaderMeta::COMMENT_HEIGHT)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x38), Gm1HeaderMeta::COMMENT_UNKNOWN_0x38)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x3C), Gm1HeaderMeta::COMMENT_UNKNOWN_0x3C)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x40), Gm1HeaderMeta::COMMENT_UNKNOWN_0x40)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x44), Gm1HeaderMeta::COMMENT_UNKNOWN_0x44)
-      .writeListEntry(std::to_string(headerInfo.originX), Gm1HeaderMeta::COMMENT_ORIGIN_X)
-      .writeListEntry(std::to_string(headerInfo.originY), Gm1HeaderMeta::COMMENT_ORIGIN_Y)
-      .writeListEntry(std::to_string(headerInfo.dataSize), Gm1HeaderMeta::COMMENT_DATA_SIZE)
-      .writeListEntry(std::to_string(headerInfo.unknown_0x54), Gm1HeaderMeta::COMMENT_UNKNOWN_0x54)
+      .writeListEntry(headerInfo.unknown_0x0, Gm1HeaderMeta::COMMENT_UNKNOWN_0x0)
+      .writeListEntry(headerInfo.unknown_0x4, Gm1HeaderMeta::COMMENT_UNKNOWN_0x4)
+      .writeListEntry(headerInfo.unknown_0x8, Gm1HeaderMeta::COMMENT_UNKNOWN_0x8)
+      .writeListEntry(headerInfo.numberOfPicturesInFile, Gm1HeaderMeta::COMMENT_NUMBER_OF_PICTURES_IN_FILE)
+      .writeListEntry(headerInfo.unknown_0x10, Gm1HeaderMeta::COMMENT_UNKNOWN_0x10)
+      .writeListEntry(static_cast<int32_t>(headerInfo.gm1Type), Gm1HeaderMeta::COMMENT_GM1_TYPE)
+      .writeListEntry(headerInfo.unknown_0x18, Gm1HeaderMeta::COMMENT_UNKNOWN_0x18)
+      .writeListEntry(headerInfo.unknown_0x1C, Gm1HeaderMeta::COMMENT_UNKNOWN_0x1C)
+      .writeListEntry(headerInfo.unknown_0x20, Gm1HeaderMeta::COMMENT_UNKNOWN_0x20)
+      .writeListEntry(headerInfo.unknown_0x24, Gm1HeaderMeta::COMMENT_UNKNOWN_0x24)
+      .writeListEntry(headerInfo.unknown_0x28, Gm1HeaderMeta::COMMENT_UNKNOWN_0x28)
+      .writeListEntry(headerInfo.unknown_0x2C, Gm1HeaderMeta::COMMENT_UNKNOWN_0x2C)
+      .writeListEntry(headerInfo.width, Gm1HeaderMeta::COMMENT_WIDTH)
+      .writeListEntry(headerInfo.height, Gm1HeaderMeta::COMMENT_HEIGHT)
+      .writeListEntry(headerInfo.unknown_0x38, Gm1HeaderMeta::COMMENT_UNKNOWN_0x38)
+      .writeListEntry(headerInfo.unknown_0x3C, Gm1HeaderMeta::COMMENT_UNKNOWN_0x3C)
+      .writeListEntry(headerInfo.unknown_0x40, Gm1HeaderMeta::COMMENT_UNKNOWN_0x40)
+      .writeListEntry(headerInfo.unknown_0x44, Gm1HeaderMeta::COMMENT_UNKNOWN_0x44)
+      .writeListEntry(headerInfo.originX, Gm1HeaderMeta::COMMENT_ORIGIN_X)
+      .writeListEntry(headerInfo.originY, Gm1HeaderMeta::COMMENT_ORIGIN_Y)
+      .writeListEntry(headerInfo.dataSize, Gm1HeaderMeta::COMMENT_DATA_SIZE)
+      .writeListEntry(headerInfo.unknown_0x54, Gm1HeaderMeta::COMMENT_UNKNOWN_0x54)
       .endObject();
   }
 
   static void savePaletteToFile(const std::filesystem::path& palettePath, std::span<const uint16_t> palette)
   {
+    const Timings::PhaseTimer writeTimer{ Timings::Phase::PALETTE_WRITE, palette.size_bytes() };
     std::ofstream out;
     out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
     out.open(palettePath, std::ios::out | std::ios::trunc | std::ios::binary);
@@ -679,16 +824,20 @@ namespace GM1File
   }
 
   static void writeGm1ImageHeaderToResourceMetaObject(const uint32_t offset, const uint32_t size, const Gm1ImageHeader& imageHeader,
-    ResourceMetaFormat::ResourceMetaFileWriter& metaWriter)
+    const std::optional<uint64_t> canvasHash, ResourceMetaFormat::ResourceMetaFileWriter& metaWriter)
   {
     Log(LogLevel::DEBUG, "Write Gm1ImageHeader object to meta file.");
-    metaWriter.startObject(Gm1ImageHeaderMeta::RESOURCE_IDENTIFIER, Gm1ImageHeaderMeta::CURRENT_VERSION)
-      .writeMapEntry(Gm1ImageHeaderMeta::OFFSET_KEY, std::to_string(offset))
-      .writeMapEntry(Gm1ImageHeaderMeta::SIZE_KEY, std::to_string(size))
-      .writeListEntry(std::to_string(imageHeader.width), Gm1ImageHeaderMeta::COMMENT_WIDTH)
-      .writeListEntry(std::to_string(imageHeader.height), Gm1ImageHeaderMeta::COMMENT_HEIGHT)
-      .writeListEntry(std::to_string(imageHeader.offsetX), Gm1ImageHeaderMeta::COMMENT_OFFSET_X)
-      .writeListEntry(std::to_string(imageHeader.offsetY), Gm1ImageHeaderMeta::COMMENT_OFFSET_Y)
+    auto& imageHeaderWriter{ metaWriter.startObject(Gm1ImageHeaderMeta::RESOURCE_IDENTIFIER, Gm1ImageHeaderMeta::CURRENT_VERSION)
+      .writeMapEntry(Gm1ImageHeaderMeta::OFFSET_KEY, offset)
+      .writeMapEntry(Gm1ImageHeaderMeta::SIZE_KEY, size) };
+    if (canvasHash)
+    {
+      imageHeaderWriter.writeMapEntry(Gm1ImageHeaderMeta::CANVAS_HASH_KEY, *canvasHash, ResourceMetaFormat::INTEGER_FORMAT::HEX_QWORD);
+    }
+    imageHeaderWriter.writeListEntry(imageHeader.width, Gm1ImageHeaderMeta::COMMENT_WIDTH)
+      .writeListEntry(imageHeader.height, Gm1ImageHeaderMeta::COMMENT_HEIGHT)
+      .writeListEntry(imageHeader.offsetX, Gm1ImageHeaderMeta::COMMENT_OFFSET_X)
+      .writeListEntry(imageHeader.offsetY, Gm1ImageHeaderMeta::COMMENT_OFFSET_Y)
       .endObject();
   }
 
@@ -697,13 +846,13 @@ namespace GM1File
   {
     Log(LogLevel::DEBUG, "Write Gm1TileObjectImageInfo object to meta file.");
     metaWriter.startObject(Gm1TileObjectImageInfoMeta::RESOURCE_IDENTIFIER, Gm1TileObjectImageInfoMeta::CURRENT_VERSION)
-      .writeListEntry(std::to_string(gm1TileObjectImageInfo.imagePart), Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_PART)
-      .writeListEntry(std::to_string(gm1TileObjectImageInfo.subParts), Gm1TileObjectImageInfoMeta::COMMENT_SUB_PARTS)
-      .writeListEntry(std::to_string(gm1TileObjectImageInfo.tileOffset), Gm1TileObjectImageInfoMeta::COMMENT_TILE_OFFSET)
-      .writeListEntry(std::to_string(static_cast<int8_t>(gm1TileObjectImageInfo.imagePosition)), Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_POSITION)
-      .writeListEntry(std::to_string(gm1TileObjectImageInfo.imageOffsetX), Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_OFFSET_X)
-      .writeListEntry(std::to_string(gm1TileObjectImageInfo.imageWidth), Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_WIDTH)
-      .writeListEntry(std::format("{:08b}", gm1TileObjectImageInfo.flags), Gm1TileObjectImageInfoMeta::COMMENT_FLAGS)
+      .writeListEntry(gm1TileObjectImageInfo.imagePart, Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_PART)
+      .writeListEntry(gm1TileObjectImageInfo.subParts, Gm1TileObjectImageInfoMeta::COMMENT_SUB_PARTS)
+      .writeListEntry(gm1TileObjectImageInfo.tileOffset, Gm1TileObjectImageInfoMeta::COMMENT_TILE_OFFSET)
+      .writeListEntry(static_cast<int8_t>(gm1TileObjectImageInfo.imagePosition), Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_POSITION)
+      .writeListEntry(gm1TileObjectImageInfo.imageOffsetX, Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_OFFSET_X)
+      .writeListEntry(gm1TileObjectImageInfo.imageWidth, Gm1TileObjectImageInfoMeta::COMMENT_IMAGE_WIDTH)
+      .writeListEntry(gm1TileObjectImageInfo.flags, ResourceMetaFormat::INTEGER_FORMAT::BINARY_BYTE, Gm1TileObjectImageInfoMeta::COMMENT_FLAGS)
       .endObject();
   }
 
@@ -712,17 +861,18 @@ namespace GM1File
   {
     Log(LogLevel::DEBUG, "Write Gm1GeneralImageInfo object to meta file.");
     metaWriter.startObject(Gm1GeneralImageInfoMeta::RESOURCE_IDENTIFIER, Gm1GeneralImageInfoMeta::CURRENT_VERSION)
-      .writeListEntry(std::to_string(gm1GeneralImageInfo.relativeDataPos), Gm1GeneralImageInfoMeta::COMMENT_RELATIVE_DATA_POS)
-      .writeListEntry(std::to_string(gm1GeneralImageInfo.fontRelatedSize), Gm1GeneralImageInfoMeta::COMMENT_FONT_RELATED_SIZE)
-      .writeListEntry(std::to_string(gm1GeneralImageInfo.unknown_0x4), Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x4)
-      .writeListEntry(std::to_string(gm1GeneralImageInfo.unknown_0x5), Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x5)
-      .writeListEntry(std::to_string(gm1GeneralImageInfo.unknown_0x6), Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x6)
-      .writeListEntry(std::format("{:08b}", gm1GeneralImageInfo.flags), Gm1GeneralImageInfoMeta::COMMENT_FLAGS)
+      .writeListEntry(gm1GeneralImageInfo.relativeDataPos, Gm1GeneralImageInfoMeta::COMMENT_RELATIVE_DATA_POS)
+      .writeListEntry(gm1GeneralImageInfo.fontRelatedSize, Gm1GeneralImageInfoMeta::COMMENT_FONT_RELATED_SIZE)
+      .writeListEntry(gm1GeneralImageInfo.unknown_0x4, Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x4)
+      .writeListEntry(gm1GeneralImageInfo.unknown_0x5, Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x5)
+      .writeListEntry(gm1GeneralImageInfo.unknown_0x6, Gm1GeneralImageInfoMeta::COMMENT_UNKNOWN_0x6)
+      .writeListEntry(gm1GeneralImageInfo.flags, ResourceMetaFormat::INTEGER_FORMAT::BINARY_BYTE, Gm1GeneralImageInfoMeta::COMMENT_FLAGS)
       .endObject();
   }
 
   // currently loops three times through images, but this is ok for now
-  void saveGm1ResourceAsRaw(const std::filesystem::path& folder, const Gm1Resource& resource, const TgxCoderInstruction& instructions)
+  void saveGm1ResourceAsRaw(const std::filesystem::path& folder, const Gm1Resource& resource, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions)
   {
     Log(LogLevel::INFO, "Try saving GM1 resource as raw data.");
 
@@ -730,6 +880,7 @@ namespace GM1File
     Log(LogLevel::DEBUG, "Created directory.");
 
     // determine needed canvas size
+    Timings::PhaseTimer allocationTimer{ Timings::Phase::CANVAS_ALLOCATION };
     int canvasWidth{ 0 };
     int canvasHeight{ 0 };
     for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
@@ -740,16 +891,72 @@ namespace GM1File
       canvasWidth = std::max(canvasWidth, possibleWidth);
       canvasHeight = std::max(canvasHeight, possibleHeight);
     }
-    auto rawData{ createMemoryForRaw(canvasWidth, canvasHeight, instructions.transparentPixelRawColor) };
+    const size_t rawDataPixelSize{ static_cast<size_t>(canvasWidth) * canvasHeight };
+
+    const bool isAnimation{ resource.gm1Header->info.gm1Type == Gm1Type::GM1_TYPE_ANIMATIONS };
+    PixelConversion::RawPixelFormat rawPixelFormat{ extractOptions.rawPixelFormat };
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888 && isAnimation)
+    {
+      Log(LogLevel::WARNING, "Canvas of animations contains palette indices. Raw data is kept as argb1555.");
+      rawPixelFormat = PixelConversion::RawPixelFormat::ARGB_1555;
+    }
+    else if (rawPixelFormat == PixelConversion::RawPixelFormat::INDEXED_8 && !isAnimation)
+    {
+      Log(LogLevel::WARNING, "Only animations have an indexed canvas. Raw data is kept as argb1555.");
+      rawPixelFormat = PixelConversion::RawPixelFormat::ARGB_1555;
+    }
+
+    // the indexed canvas replaces the 16 bit canvas, transparent pixels are the unset bits of the mask
+    std::unique_ptr<uint16_t[]> rawData;
+    std::unique_ptr<uint8_t[]> indexData;
+    std::unique_ptr<uint8_t[]> maskData;
+    const size_t maskSize{ (rawDataPixelSize + 7) / 8 };
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::INDEXED_8)
+    {
+      indexData = std::make_unique<uint8_t[]>(rawDataPixelSize);
+      maskData = std::make_unique<uint8_t[]>(maskSize);
+      allocationTimer.addBytes(rawDataPixelSize + maskSize);
+    }
+    else
+    {
+      rawData = createMemoryForRaw(canvasWidth, canvasHeight, instructions.transparentPixelRawColor);
+      allocationTimer.addBytes(rawDataPixelSize * sizeof(uint16_t));
+    }
+
+    // animations are shown with their palettes applied, which are resolved during the decode
+    std::vector<int> pngPalettes;
+    std::vector<std::unique_ptr<uint16_t[]>> pngPaletteData;
+    if (isAnimation && extractOptions.pngFormat != PngFile::PngFormat::NONE)
+    {
+      for (int i{ 0 }; i < PALETTE_COUNT; ++i)
+      {
+        if (extractOptions.pngPalette == PNG_ALL_PALETTES || extractOptions.pngPalette == i)
+        {
+          pngPalettes.push_back(i);
+          pngPaletteData.push_back(createMemoryForRaw(canvasWidth, canvasHeight, instructions.transparentPixelRawColor));
+          allocationTimer.addBytes(rawDataPixelSize * sizeof(uint16_t));
+        }
+      }
+    }
+    allocationTimer.stop();
 
     switch (resource.gm1Header->info.gm1Type)
     {
     case Gm1Type::GM1_TYPE_INTERFACE:
     case Gm1Type::GM1_TYPE_TGX_CONST_SIZE:
     case Gm1Type::GM1_TYPE_FONT:
-    case Gm1Type::GM1_TYPE_ANIMATIONS:
       decodeGm1TgxResource(resource, canvasWidth, canvasHeight, rawData.get());
       break;
+    case Gm1Type::GM1_TYPE_ANIMATIONS:
+      if (indexData)
+      {
+        decodeGm1IndexedAnimationResource(resource, canvasWidth, canvasHeight, indexData.get(), maskData.get());
+      }
+      if (rawData || !pngPalettes.empty())
+      {
+        decodeGm1AnimationResource(resource, canvasWidth, canvasHeight, rawData.get(), pngPalettes, pngPaletteData);
+      }
+      break;
     case Gm1Type::GM1_TYPE_TILES_OBJECT:
       decodeGm1TileObjectResource(resource, canvasWidth, canvasHeight, rawData.get());
       break;
@@ -763,13 +970,43 @@ namespace GM1File
     }
     Log(LogLevel::DEBUG, "Decoded GM1 to raw data.");
 
+    // hashes the region of every image in the canvas that is written to the raw data, pack converts the data back to this canvas
+    std::vector<uint64_t> canvasHashes;
+    if (extractOptions.keepOriginalEncoding)
+    {
+      const Timings::PhaseTimer hashTimer{ Timings::Phase::CANVAS_HASH };
+      for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
+      {
+        const Gm1ImageHeader& imageHeader{ resource.imageHeaders[i].imageHeader };
+        canvasHashes.push_back(indexData
+          ? CanvasHash::hashIndexedCanvasRegion(indexData.get(), maskData.get(), canvasWidth, imageHeader.offsetX, imageHeader.offsetY,
+            imageHeader.width, imageHeader.height)
+          : CanvasHash::hashCanvasRegion(rawData.get(), canvasWidth, imageHeader.offsetX, imageHeader.offsetY, imageHeader.width, imageHeader.height));
+      }
+    }
+
     const std::string resourceName{ folder.filename().string() };
     Log(LogLevel::DEBUG, "Using folder name '{}' as resource name.", resourceName);
 
     std::filesystem::path relativeDataPath{ resourceName };
     relativeDataPath.replace_extension(RAW_DATA_FILE_EXTENSION);
 
-    const size_t rawDataSize{ static_cast<size_t>(canvasWidth) * canvasHeight * sizeof(uint16_t) };
+    std::filesystem::path relativeMaskPath{ resourceName };
+    relativeMaskPath.replace_extension(MASK_FILE_EXTENSION);
+
+    std::filesystem::path relativeOriginalDataPath{ resourceName };
+    relativeOriginalDataPath.replace_extension(ORIGINAL_DATA_FILE_EXTENSION);
+
+    const size_t rawDataSize{ rawDataPixelSize * PixelConversion::getRawPixelFormatByteSize(rawPixelFormat) };
+
+    std::unique_ptr<uint32_t[]> rgbaData;
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888)
+    {
+      const Timings::PhaseTimer conversionTimer{ Timings::Phase::PIXEL_CONVERSION, rawDataSize };
+      rgbaData = std::make_unique_for_overwrite<uint32_t[]>(rawDataPixelSize);
+      PixelConversion::argb1555ToRgba8888({ rawData.get(), rawDataPixelSize }, { rgbaData.get(), rawDataPixelSize });
+      Log(LogLevel::DEBUG, "Converted raw data to {}.", PixelConversion::getRawPixelFormatName(rawPixelFormat));
+    }
 
     Log(LogLevel::DEBUG, "Creating resource meta file.");
     {
@@ -778,22 +1015,44 @@ namespace GM1File
 
       try
       {
+        Timings::PhaseTimer metaWriteTimer{ Timings::Phase::META_WRITE };
         std::ofstream out;
         out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
         out.open(file, std::ios::out | std::ios::trunc); // text handling
 
         auto metaWriter{ ResourceMetaFormat::ResourceMetaFileWriter::startFile(out, ResourceMetaFormat::VERSION::CURRENT) };
-        metaWriter.startHeader()
+        auto& gm1ResourceWriter{ metaWriter.startHeader()
           .endObject()
 
           .startObject(Gm1ResourceMeta::RESOURCE_IDENTIFIER, Gm1ResourceMeta::CURRENT_VERSION)
           .writeMapEntry(Gm1ResourceMeta::RAW_DATA_PATH_KEY, relativeDataPath.string())
-          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_SIZE_KEY, std::to_string(rawDataSize))
-          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_TRANSPARENT_PIXEL_KEY, std::format("{:#06x}", instructions.transparentPixelRawColor),
+          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_SIZE_KEY, rawDataSize)
+          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_TRANSPARENT_PIXEL_KEY, instructions.transparentPixelRawColor, ResourceMetaFormat::INTEGER_FORMAT::HEX_WORD,
             "Color used for transparent pixel during extract. Not automatically used during packing.")
-          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_WIDTH_KEY, std::to_string(canvasWidth))
-          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_HEIGHT_KEY, std::to_string(canvasHeight))
-          .endObject();
+          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_WIDTH_KEY, canvasWidth)
+          .writeMapEntry(Gm1ResourceMeta::RAW_DATA_HEIGHT_KEY, canvasHeight) };
+        if (rgbaData)
+        {
+          gm1ResourceWriter.writeMapEntry(Gm1ResourceMeta::RAW_DATA_FORMAT_KEY, PixelConversion::getRawPixelFormatName(rawPixelFormat),
+            "Converted back to argb1555 during packing.");
+        }
+        else if (indexData)
+        {
+          gm1ResourceWriter.writeMapEntry(Gm1ResourceMeta::RAW_DATA_FORMAT_KEY, PixelConversion::getRawPixelFormatName(rawPixelFormat),
+            "One palette index per pixel.")
+            .writeMapEntry(Gm1ResourceMeta::RAW_MASK_PATH_KEY, relativeMaskPath.string(), "One bit per pixel, set for opaque pixels.");
+        }
+        if (extractOptions.dataCompression != RawCompression::Compression::NONE)
+        {
+          gm1ResourceWriter.writeMapEntry(Gm1ResourceMeta::RAW_DATA_COMPRESSION_KEY, RawCompression::getCompressionName(extractOptions.dataCompression),
+            "The data size is the size before compression.");
+        }
+        if (!canvasHashes.empty())
+        {
+          gm1ResourceWriter.writeMapEntry(Gm1ResourceMeta::ORIGINAL_DATA_PATH_KEY, relativeOriginalDataPath.string(),
+            "Encoded data of the extracted images, addressed by their data offset and size. Images that match their canvas hash can copy it.");
+        }
+        gm1ResourceWriter.endObject();
 
         writeGm1HeaderInfoToResourceMetaObject(resource.gm1Header->info, metaWriter);
 
@@ -803,7 +1062,8 @@ namespace GM1File
           const uint32_t offset{ resource.imageOffsets[i] };
           const uint32_t size{ resource.imageSizes[i] };
 
-          writeGm1ImageHeaderToResourceMetaObject(offset, size, image.imageHeader, metaWriter);
+          writeGm1ImageHeaderToResourceMetaObject(offset, size, image.imageHeader,
+            canvasHashes.empty() ? std::nullopt : std::optional{ canvasHashes[i] }, metaWriter);
           if (resource.gm1Header->info.gm1Type == Gm1Type::GM1_TYPE_TILES_OBJECT)
           {
             writeGm1TileObjectImageInfoToResourceMetaObject(image.imageInfo.tileObjectImageInfo, metaWriter);
@@ -815,6 +1075,7 @@ namespace GM1File
         }
 
         metaWriter.endFile();
+        metaWriteTimer.addBytes(static_cast<uint64_t>(out.tellp()));
       }
       catch (...)
       {
@@ -829,10 +1090,20 @@ namespace GM1File
       const std::filesystem::path file{ folder / relativeDataPath };
       try
       {
+        const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, rawDataSize };
         std::ofstream out;
         out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
         out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
-        out.write(reinterpret_cast<const char*>(rawData.get()), rawDataSize);
+        const uint8_t* data{ rgbaData ? reinterpret_cast<const uint8_t*>(rgbaData.get())
+          : indexData ? indexData.get() : reinterpret_cast<const uint8_t*>(rawData.get()) };
+        if (extractOptions.dataCompression == RawCompression::Compression::NONE)
+        {
+          out.write(reinterpret_cast<const char*>(data), rawDataSize);
+        }
+        else
+        {
+          RawCompression::writeCompressed(out, { data, rawDataSize });
+        }
       }
       catch (...)
       {
@@ -842,6 +1113,46 @@ namespace GM1File
     }
     Log(LogLevel::DEBUG, "Created resource data file.");
 
+    if (maskData)
+    {
+      Log(LogLevel::DEBUG, "Creating resource mask file.");
+      const std::filesystem::path file{ folder / relativeMaskPath };
+      try
+      {
+        const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, maskSize };
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
+        out.write(reinterpret_cast<const char*>(maskData.get()), maskSize);
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Encountered error while writing GM1 resource mask file. File is likely corrupted.");
+        throw;
+      }
+      Log(LogLevel::DEBUG, "Created resource mask file.");
+    }
+
+    if (!canvasHashes.empty())
+    {
+      Log(LogLevel::DEBUG, "Creating original data file.");
+      const std::filesystem::path file{ folder / relativeOriginalDataPath };
+      try
+      {
+        const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, resource.gm1Header->info.dataSize };
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
+        out.write(reinterpret_cast<const char*>(resource.imageData), resource.gm1Header->info.dataSize);
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Encountered error while writing GM1 original data file. File is likely corrupted.");
+        throw;
+      }
+      Log(LogLevel::DEBUG, "Created original data file.");
+    }
+
     Log(LogLevel::DEBUG, "Creating palette data files.");
     for (size_t i{ 0 }; i < PALETTE_COUNT; ++i)
     {
@@ -859,6 +1170,59 @@ namespace GM1File
     }
     Log(LogLevel::DEBUG, "Created palette data files.");
 
+    if (extractOptions.pngFormat != PngFile::PngFormat::NONE && rawDataSize > 0)
+    {
+      Log(LogLevel::DEBUG, "Creating PNG files.");
+      const auto savePngFile{ [&](const std::filesystem::path& file, const uint16_t* data)
+        {
+          try
+          {
+            const Timings::PhaseTimer pngTimer{ Timings::Phase::PNG_WRITE, rawDataPixelSize * sizeof(uint16_t) };
+            PngFile::savePng(file, PngFile::PngSource{
+              .data{ data },
+              .width{ canvasWidth },
+              .height{ canvasHeight },
+              .transparentPixel{ instructions.transparentPixelRawColor },
+              .palette{ nullptr }
+            }, extractOptions.pngFormat);
+          }
+          catch (...)
+          {
+            Log(LogLevel::ERROR, "Encountered error while writing GM1 PNG file. File is likely corrupted.");
+            throw;
+          }
+        } };
+
+      if (pngPalettes.empty())
+      {
+        std::filesystem::path file{ folder / resourceName };
+        savePngFile(file.replace_extension(PngFile::FILE_EXTENSION), rawData.get());
+      }
+      else if (extractOptions.pngPalette != PNG_ALL_PALETTES)
+      {
+        std::filesystem::path file{ folder / resourceName };
+        savePngFile(file.replace_extension(PngFile::FILE_EXTENSION), pngPaletteData.front().get());
+      }
+      else
+      {
+        for (size_t i{ 0 }; i < pngPalettes.size(); ++i)
+        {
+          std::filesystem::path file{ folder / std::format("{}_{}", resourceName, pngPalettes[i]) };
+          savePngFile(file.replace_extension(PngFile::FILE_EXTENSION), pngPaletteData[i].get());
+        }
+      }
+      Log(LogLevel::DEBUG, "Created PNG files.");
+    }
+
     Log(LogLevel::INFO, "Saved GM1 resource as raw data.");
   }
+
+  int pngPaletteFromStr(const std::string& str)
+  {
+    if (str == "all")
+    {
+      return PNG_ALL_PALETTES;
+    }
+    return intFromStr<int, 0, 0, PALETTE_COUNT - 1>(str);
+  }
 }
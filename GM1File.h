@@ -4,6 +4,7 @@
 
 #include "TGXCoder.h"
 #include "Utility.h"
+#include "ExtractOptions.h"
 
 #include <memory>
 #include <filesystem>
@@ -202,6 +203,8 @@ namespace GM1File
   inline constexpr std::string_view RAW_DATA_FILE_EXTENSION{ ".data" };
 
   inline constexpr std::string_view PALETTE_FILE_EXTENSION{ ".palette" };
+  inline constexpr std::string_view MASK_FILE_EXTENSION{ ".mask" };
+  inline constexpr std::string_view ORIGINAL_DATA_FILE_EXTENSION{ ".encoded" };
   inline constexpr int PALETTE_COUNT{ 10 };
   inline constexpr int PALETTE_SIZE{ 512 };
 
@@ -219,6 +222,10 @@ namespace GM1File
     inline constexpr std::string_view RAW_DATA_TRANSPARENT_PIXEL_KEY{ "transparent pixel" };
     inline constexpr std::string_view RAW_DATA_WIDTH_KEY{ "data width" };
     inline constexpr std::string_view RAW_DATA_HEIGHT_KEY{ "data height" };
+    inline constexpr std::string_view RAW_DATA_FORMAT_KEY{ "data format" }; // optional, only written if not argb1555
+    inline constexpr std::string_view RAW_MASK_PATH_KEY{ "mask path" }; // optional, only written for indexed8
+    inline constexpr std::string_view RAW_DATA_COMPRESSION_KEY{ "data compression" }; // optional, only written if compressed, not used for the mask
+    inline constexpr std::string_view ORIGINAL_DATA_PATH_KEY{ "original data path" }; // optional, only written if the original encoding is kept
   }
 
   namespace Gm1HeaderMeta
@@ -265,6 +272,7 @@ namespace GM1File
 
     inline constexpr std::string_view OFFSET_KEY{ "data offset" };
     inline constexpr std::string_view SIZE_KEY{ "data size" };
+    inline constexpr std::string_view CANVAS_HASH_KEY{ "canvas hash" }; // optional, hash of the image region, only written if the original encoding is kept
 
     inline constexpr std::string_view COMMENT_WIDTH{ "width" };
     inline constexpr std::string_view COMMENT_HEIGHT{ "height" };
@@ -310,11 +318,18 @@ namespace GM1File
   // basically the hight the image is "sunk" into the tile, and it seems to be a constant in the game
   inline constexpr int TILE_IMAGE_HEIGHT_OFFSET{ 7 };
 
-  void validateGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions, bool tgxAsText);
+  // returns true if the resource is valid
+  // the detailed analysis is optional and filled with the sum of all TGX images if the GM1 is valid
+  bool validateGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions, TgxTextMode tgxTextMode,
+    TgxDetailedAnalysis* detailedAnalysis = nullptr);
 
   UniqueGm1ResourcePointer loadGm1Resource(const std::filesystem::path& file);
   void saveGm1Resource(const std::filesystem::path& file, const Gm1Resource& resource);
 
   UniqueGm1ResourcePointer loadGm1ResourceFromRaw(const std::filesystem::path& folder);
-  void saveGm1ResourceAsRaw(const std::filesystem::path& folder, const Gm1Resource& resource, const TgxCoderInstruction& instructions);
+  void saveGm1ResourceAsRaw(const std::filesystem::path& folder, const Gm1Resource& resource, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions);
+
+  // accepts a palette index or "all" for PNG_ALL_PALETTES, throws otherwise
+  int pngPaletteFromStr(const std::string& str);
 }
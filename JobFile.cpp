@@ -0,0 +1,194 @@
+#include "JobFile.h"
+
+#include "Console.h"
+#include "Utility.h"
+#include "ResourceMetaFormat.h"
+#include "GM1File.h"
+
+#include <fstream>
+#include <format>
+#include <set>
+#include <span>
+#include <algorithm>
+
+namespace JobFile
+{
+  static bool isVersionSupported(int version, std::span<const int> supportedVersions)
+  {
+    const auto it{ std::find(supportedVersions.begin(), supportedVersions.end(), version) };
+    return it != supportedVersions.end();
+  }
+
+  static const std::string* findEntry(const std::map<std::string, std::string, std::less<>>& entries, std::string_view key)
+  {
+    const auto it{ entries.find(key) };
+    return it == entries.end() ? nullptr : &it->second;
+  }
+
+  static BatchOperations::BatchOperationType operationFromStr(std::string_view str)
+  {
+    if (str == JobMeta::OPERATION_TEST)
+    {
+      return BatchOperations::BatchOperationType::TEST;
+    }
+    if (str == JobMeta::OPERATION_EXTRACT)
+    {
+      return BatchOperations::BatchOperationType::EXTRACT;
+    }
+    if (str == JobMeta::OPERATION_PACK)
+    {
+      return BatchOperations::BatchOperationType::PACK;
+    }
+    if (str == JobMeta::OPERATION_ROUNDTRIP)
+    {
+      return BatchOperations::BatchOperationType::ROUNDTRIP;
+    }
+    throw std::invalid_argument{ std::format("Unknown job operation '{}'.", str) };
+  }
+
+  static uintmax_t getWorkSize(const std::filesystem::path& source)
+  {
+    std::error_code errorCode{};
+    if (std::filesystem::is_regular_file(source, errorCode))
+    {
+      const uintmax_t size{ std::filesystem::file_size(source, errorCode) };
+      return errorCode ? 0 : size;
+    }
+    uintmax_t size{ 0 };
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ source, errorCode })
+    {
+      if (entry.is_regular_file(errorCode))
+      {
+        size += entry.file_size(errorCode);
+      }
+    }
+    return size;
+  }
+
+  BatchOperations::BatchJob parseJob(const ResourceMetaFormat::ResourceMetaObjectReader& jobMeta, size_t jobIndex,
+    const std::filesystem::path& baseFolder, const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions,
+    TgxTextMode defaultTgxTextMode)
+  {
+    if (jobMeta.getIdentifier() != JobMeta::RESOURCE_IDENTIFIER)
+    {
+      throw std::invalid_argument{ std::format("Object {} is not a {} object.", jobIndex, JobMeta::RESOURCE_IDENTIFIER) };
+    }
+    if (!isVersionSupported(jobMeta.getVersion(), JobMeta::SUPPORTED_VERSIONS))
+    {
+      throw std::invalid_argument{ std::format("{} object {} has no supported version.", JobMeta::RESOURCE_IDENTIFIER, jobIndex) };
+    }
+    // version currently ignored, since only one available
+
+    const auto& entries{ jobMeta.getMapEntries() };
+    const std::string* operation{ findEntry(entries, JobMeta::OPERATION_KEY) };
+    const std::string* source{ findEntry(entries, JobMeta::SOURCE_KEY) };
+    if (!operation || !source)
+    {
+      throw std::invalid_argument{ std::format("{} object {} requires the entries '{}' and '{}'.",
+        JobMeta::RESOURCE_IDENTIFIER, jobIndex, JobMeta::OPERATION_KEY, JobMeta::SOURCE_KEY) };
+    }
+    const BatchOperations::BatchOperationType type{ operationFromStr(*operation) };
+
+    const std::string* target{ findEntry(entries, JobMeta::TARGET_KEY) };
+    const bool needsTarget{ type == BatchOperations::BatchOperationType::EXTRACT || type == BatchOperations::BatchOperationType::PACK };
+    if (needsTarget && !target)
+    {
+      throw std::invalid_argument{ std::format("{} object {} requires the entry '{}'.", JobMeta::RESOURCE_IDENTIFIER, jobIndex, JobMeta::TARGET_KEY) };
+    }
+
+    TgxCoderInstruction instructions{ defaultInstructions };
+    if (const std::string* value{ findEntry(entries, JobMeta::TRANSPARENT_PIXEL_TGX_COLOR_KEY) })
+    {
+      instructions.transparentPixelTgxColor = uintFromStr<uint16_t>(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::TRANSPARENT_PIXEL_RAW_COLOR_KEY) })
+    {
+      instructions.transparentPixelRawColor = uintFromStr<uint16_t>(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::PIXEL_REPEAT_THRESHOLD_KEY) })
+    {
+      instructions.pixelRepeatThreshold = intFromStr<int>(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::PADDING_ALIGNMENT_KEY) })
+    {
+      instructions.paddingAlignment = intFromStr<int>(*value);
+    }
+    ExtractOptions extractOptions{ defaultExtractOptions };
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_PNG_KEY) })
+    {
+      extractOptions.pngFormat = PngFile::pngFormatFromStr(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_RAW_FORMAT_KEY) })
+    {
+      extractOptions.rawPixelFormat = PixelConversion::rawPixelFormatFromStr(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_PNG_PALETTE_KEY) })
+    {
+      extractOptions.pngPalette = GM1File::pngPaletteFromStr(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_COMPRESSION_KEY) })
+    {
+      extractOptions.dataCompression = RawCompression::compressionFromStr(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_TUNE_REPEAT_THRESHOLD_KEY) })
+    {
+      extractOptions.tunePixelRepeatThreshold = boolFromStr(*value);
+    }
+    if (const std::string* value{ findEntry(entries, JobMeta::EXTRACT_KEEP_ORIGINAL_KEY) })
+    {
+      extractOptions.keepOriginalEncoding = boolFromStr(*value);
+    }
+    const std::string* tgxTextMode{ findEntry(entries, JobMeta::TGX_AS_TEXT_KEY) };
+
+    const std::filesystem::path sourcePath{ (baseFolder / *source).lexically_normal() };
+    return BatchOperations::BatchJob{
+      .type{ type },
+      .source{ sourcePath },
+      .target{ needsTarget ? (baseFolder / *target).lexically_normal() : std::filesystem::path{} },
+      .instructions{ instructions },
+      .extractOptions{ extractOptions },
+      .tgxTextMode{ tgxTextMode ? tgxTextModeFromStr(*tgxTextMode) : defaultTgxTextMode },
+      .workSize{ getWorkSize(sourcePath) }
+    };
+  }
+
+  std::vector<BatchOperations::BatchJob> loadJobFile(const std::filesystem::path& file,
+    const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions, TgxTextMode defaultTgxTextMode)
+  {
+    Log(LogLevel::INFO, "Try loading job file.");
+    if (!std::filesystem::is_regular_file(file))
+    {
+      throw std::invalid_argument{ "Provided job file is not a regular file." };
+    }
+    const std::filesystem::path baseFolder{ std::filesystem::absolute(file).parent_path() };
+
+    std::ifstream in;
+    in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    in.open(file, std::ios::in); // text handling
+
+    auto reader{ ResourceMetaFormat::ResourceMetaFileStreamReader::startFrom(in) };
+    std::vector<BatchOperations::BatchJob> jobs{};
+    std::set<std::filesystem::path> usedTargets{};
+    while (std::optional<ResourceMetaFormat::ResourceMetaObjectReader> jobMeta{ reader.next() })
+    {
+      BatchOperations::BatchJob job{ parseJob(*jobMeta, jobs.size(), baseFolder, defaultInstructions, defaultExtractOptions, defaultTgxTextMode) };
+      if (!job.target.empty() && !usedTargets.insert(job.target).second)
+      {
+        throw std::invalid_argument{ std::format("Target '{}' of job {} is already used by another job.", job.target.string(), jobs.size()) };
+      }
+      jobs.emplace_back(std::move(job));
+    }
+
+    // done upfront, since parallel creation of shared parents could collide
+    for (const BatchOperations::BatchJob& job : jobs)
+    {
+      if (!job.target.empty())
+      {
+        std::filesystem::create_directories(job.target.parent_path());
+      }
+    }
+
+    Log(LogLevel::INFO, "Loaded {} jobs.", jobs.size());
+    return jobs;
+  }
+}
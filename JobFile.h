@@ -0,0 +1,76 @@
+#pragma once
+
+#include "BatchOperations.h"
+#include "ResourceMetaFormat.h"
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+/*
+  Job files describe a list of independent operations, that are executed by one process.
+  They use the resource meta format, with one Job object per operation.
+  Relative paths are resolved against the folder of the job file.
+  Options not set by a job fall back to the options given to the run command.
+
+  EXAMPLE:
+  """
+    RESOURCE_META_HEADER 1
+
+    Job 1
+    : operation = extract
+    : source = gm1/body_lord.gm1
+    : target = out/body_lord
+    : tgx-coder-pixel-repeat-threshold = 3
+    : extract-png = rgba8
+
+    Job 1
+    : operation = test
+    : source = gfx/frame.tgx
+    : test-tgx-to-text = true
+  """
+*/
+
+namespace JobFile
+{
+  namespace JobMeta
+  {
+    inline constexpr std::string_view RESOURCE_IDENTIFIER{ "Job" };
+    inline constexpr int CURRENT_VERSION{ 1 };
+    inline constexpr int SUPPORTED_VERSIONS[]{ 1 };
+
+    inline constexpr std::string_view OPERATION_KEY{ "operation" };
+    inline constexpr std::string_view SOURCE_KEY{ "source" };
+    inline constexpr std::string_view TARGET_KEY{ "target" };
+
+    // same names as the CLI options
+    inline constexpr std::string_view TGX_AS_TEXT_KEY{ "test-tgx-to-text" }; // bool, "markers" or "rows"
+    inline constexpr std::string_view TRANSPARENT_PIXEL_TGX_COLOR_KEY{ "tgx-coder-transparent-pixel-tgx-color" };
+    inline constexpr std::string_view TRANSPARENT_PIXEL_RAW_COLOR_KEY{ "tgx-coder-transparent-pixel-raw-color" };
+    inline constexpr std::string_view PIXEL_REPEAT_THRESHOLD_KEY{ "tgx-coder-pixel-repeat-threshold" };
+    inline constexpr std::string_view PADDING_ALIGNMENT_KEY{ "tgx-coder-padding-alignment" };
+    inline constexpr std::string_view EXTRACT_PNG_KEY{ "extract-png" };
+    inline constexpr std::string_view EXTRACT_RAW_FORMAT_KEY{ "extract-raw-format" };
+    inline constexpr std::string_view EXTRACT_PNG_PALETTE_KEY{ "extract-png-palette" };
+    inline constexpr std::string_view EXTRACT_COMPRESSION_KEY{ "extract-compression" };
+    inline constexpr std::string_view EXTRACT_TUNE_REPEAT_THRESHOLD_KEY{ "extract-tune-repeat-threshold" };
+    inline constexpr std::string_view EXTRACT_KEEP_ORIGINAL_KEY{ "extract-keep-original" };
+
+    inline constexpr std::string_view OPERATION_TEST{ "test" };
+    inline constexpr std::string_view OPERATION_EXTRACT{ "extract" };
+    inline constexpr std::string_view OPERATION_PACK{ "pack" };
+    inline constexpr std::string_view OPERATION_ROUNDTRIP{ "roundtrip" };
+  }
+
+  // creates the job described by a single Job object, throws if the object is malformed
+  // the index is only used for error messages
+  BatchOperations::BatchJob parseJob(const ResourceMetaFormat::ResourceMetaObjectReader& jobMeta, size_t jobIndex,
+    const std::filesystem::path& baseFolder, const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions,
+    TgxTextMode defaultTgxTextMode);
+
+  // reads all jobs of the file, throws if the file is malformed
+  // jobs do not depend on each other, so two jobs with the same target are rejected
+  // the parent folders of all targets are created beforehand
+  std::vector<BatchOperations::BatchJob> loadJobFile(const std::filesystem::path& file,
+    const TgxCoderInstruction& defaultInstructions, const ExtractOptions& defaultExtractOptions, TgxTextMode defaultTgxTextMode);
+}
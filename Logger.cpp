@@ -0,0 +1,252 @@
+#include "Console.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  Every thread that logs gets a single producer, single consumer ring buffer, so logging threads never wait for each other.
+  The background thread wakes up regularly, or if a buffer is full or a flush is requested, and writes the records of all
+  buffers sorted by time. The time zone is resolved once by the background thread, without a usable zone database
+  the times are written in UTC.
+*/
+
+namespace
+{
+  constexpr size_t RING_CAPACITY{ 256 }; // records per thread
+  constexpr std::chrono::milliseconds DRAIN_INTERVAL{ 10 };
+
+  struct LogRing
+  {
+    std::array<LogRecord, RING_CAPACITY> records{};
+    alignas(64) std::atomic<size_t> head{ 0 }; // next record to write, only changed by the owning thread
+    alignas(64) std::atomic<size_t> tail{ 0 }; // next record to read, only changed by the background thread
+    std::atomic<bool> abandoned{ false }; // the owning thread ended, the ring is removed once it is empty
+  };
+
+  class Logger
+  {
+  private:
+    std::mutex mutex;
+    std::condition_variable drainRequested;
+    std::condition_variable drained;
+    std::vector<std::shared_ptr<LogRing>> rings; // guarded by mutex
+    size_t requestedDrains{ 0 }; // guarded by mutex
+    size_t completedDrains{ 0 }; // guarded by mutex
+    bool stopping{ false }; // guarded by mutex
+    std::thread worker;
+
+    static const std::chrono::time_zone* findLocalZone()
+    {
+      try
+      {
+        return std::chrono::current_zone();
+      }
+      catch (...)
+      {
+        return nullptr; // the zone database is missing or has no entry for the system zone
+      }
+    }
+
+    // returns true if any record was written, a missing zone writes the times in UTC
+    bool drainOnce(const std::chrono::time_zone* zone, std::vector<const LogRecord*>& pending, std::string& buffer)
+    {
+      std::vector<std::shared_ptr<LogRing>> currentRings;
+      {
+        const std::lock_guard lock{ mutex };
+        std::erase_if(rings, [](const std::shared_ptr<LogRing>& ring)
+          {
+            return ring->abandoned.load(std::memory_order_acquire) && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+          });
+        currentRings = rings;
+      }
+
+      pending.clear();
+      std::vector<std::pair<LogRing*, size_t>> newHeads;
+      for (const std::shared_ptr<LogRing>& ring : currentRings)
+      {
+        const size_t tail{ ring->tail.load(std::memory_order_relaxed) };
+        const size_t head{ ring->head.load(std::memory_order_acquire) };
+        for (size_t i{ tail }; i < head; ++i)
+        {
+          pending.push_back(&ring->records[i % RING_CAPACITY]);
+        }
+        newHeads.emplace_back(ring.get(), head);
+      }
+      if (pending.empty())
+      {
+        return false;
+      }
+
+      // records of one thread are already in order, the stable sort keeps them so for equal times
+      std::stable_sort(pending.begin(), pending.end(), [](const LogRecord* a, const LogRecord* b) { return a->time < b->time; });
+
+      buffer.clear();
+      for (const LogRecord* record : pending)
+      {
+        if (zone)
+        {
+          const std::chrono::zoned_time recordTime{ zone, record->time };
+          std::format_to(std::back_inserter(buffer), "{:%Y-%m-%d %T %Z} : {} : {}\n", recordTime, LOG_LEVEL_MAP.at(record->level), record->message);
+        }
+        else
+        {
+          std::format_to(std::back_inserter(buffer), "{:%Y-%m-%d %T} UTC : {} : {}\n", record->time, LOG_LEVEL_MAP.at(record->level), record->message);
+        }
+      }
+
+      // the records are released before the write, so that waiting threads can continue
+      for (const auto& [ring, head] : newHeads)
+      {
+        ring->tail.store(head, std::memory_order_release);
+      }
+      LOG_OUT.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      LOG_OUT.flush();
+      return true;
+    }
+
+    void workerLoop()
+    {
+      const std::chrono::time_zone* zone{ findLocalZone() };
+      std::vector<const LogRecord*> pending;
+      std::string buffer;
+      while (true)
+      {
+        size_t drainTarget;
+        bool stop;
+        {
+          std::unique_lock lock{ mutex };
+          drainRequested.wait_for(lock, DRAIN_INTERVAL, [this]() { return stopping || requestedDrains != completedDrains; });
+          drainTarget = requestedDrains;
+          stop = stopping;
+        }
+
+        try
+        {
+          // repeated, since records released during the write can already be refilled
+          while (drainOnce(zone, pending, buffer))
+          {
+          }
+        }
+        catch (...)
+        {
+          // the log has no place to report its own failures
+        }
+
+        {
+          const std::lock_guard lock{ mutex };
+          completedDrains = drainTarget;
+        }
+        drained.notify_all();
+        if (stop)
+        {
+          return;
+        }
+      }
+    }
+  public:
+    Logger()
+    {
+      worker = std::thread{ &Logger::workerLoop, this };
+    }
+
+    ~Logger()
+    {
+      {
+        const std::lock_guard lock{ mutex };
+        stopping = true;
+      }
+      drainRequested.notify_one();
+      worker.join();
+    }
+
+    void registerRing(std::shared_ptr<LogRing> ring)
+    {
+      const std::lock_guard lock{ mutex };
+      rings.emplace_back(std::move(ring));
+    }
+
+    void requestDrain()
+    {
+      drainRequested.notify_one();
+    }
+
+    void flush()
+    {
+      std::unique_lock lock{ mutex };
+      if (stopping)
+      {
+        return;
+      }
+      const size_t target{ ++requestedDrains };
+      drainRequested.notify_one();
+      drained.wait(lock, [this, target]() { return completedDrains >= target; });
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+  };
+
+  Logger& getLogger()
+  {
+    static Logger logger{};
+    return logger;
+  }
+
+  // owns the ring of the current thread and marks it as abandoned when the thread ends
+  class ThreadRing
+  {
+  private:
+    std::shared_ptr<LogRing> ring;
+  public:
+    ThreadRing() : ring{ std::make_shared<LogRing>() }
+    {
+      getLogger().registerRing(ring);
+    }
+
+    ~ThreadRing()
+    {
+      ring->abandoned.store(true, std::memory_order_release);
+    }
+
+    LogRing& get()
+    {
+      return *ring;
+    }
+
+    ThreadRing(const ThreadRing&) = delete;
+    ThreadRing& operator=(const ThreadRing&) = delete;
+  };
+
+  LogRing& getThreadRing()
+  {
+    thread_local ThreadRing threadRing{};
+    return threadRing.get();
+  }
+}
+
+LogRecord& beginLogRecord()
+{
+  LogRing& ring{ getThreadRing() };
+  const size_t head{ ring.head.load(std::memory_order_relaxed) };
+  while (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY)
+  {
+    getLogger().requestDrain();
+    std::this_thread::yield();
+  }
+  return ring.records[head % RING_CAPACITY];
+}
+
+void commitLogRecord()
+{
+  LogRing& ring{ getThreadRing() };
+  ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void flushLog()
+{
+  getLogger().flush();
+}
@@ -0,0 +1,125 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& file) : data{ nullptr }, size{ 0 }, fileHandle{ INVALID_HANDLE_VALUE }, mappingHandle{ nullptr }
+{
+  fileHandle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error{ "Failed to open file for mapping." };
+  }
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(fileHandle, &fileSize))
+  {
+    release();
+    throw std::runtime_error{ "Failed to get size of file for mapping." };
+  }
+  if (fileSize.QuadPart == 0)
+  {
+    return; // a mapping of zero bytes is not allowed
+  }
+
+  mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void* view{ mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr };
+  if (!view)
+  {
+    release();
+    throw std::runtime_error{ "Failed to map file." };
+  }
+  data = static_cast<const uint8_t*>(view);
+  size = static_cast<size_t>(fileSize.QuadPart);
+
+  // closest hint to a sequential madvise, fetches the pages in large reads, failure only costs the prefetch
+  WIN32_MEMORY_RANGE_ENTRY range{ .VirtualAddress{ const_cast<uint8_t*>(data) }, .NumberOfBytes{ size } };
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::release()
+{
+  if (data)
+  {
+    UnmapViewOfFile(data);
+    data = nullptr;
+  }
+  if (mappingHandle)
+  {
+    CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+  }
+  if (fileHandle != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(fileHandle);
+    fileHandle = INVALID_HANDLE_VALUE;
+  }
+  size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& file) : data{ nullptr }, size{ 0 }
+{
+  const int descriptor{ open(file.c_str(), O_RDONLY) };
+  if (descriptor < 0)
+  {
+    throw std::runtime_error{ "Failed to open file for mapping." };
+  }
+  struct stat fileStat{};
+  if (fstat(descriptor, &fileStat) != 0)
+  {
+    close(descriptor);
+    throw std::runtime_error{ "Failed to get size of file for mapping." };
+  }
+  if (fileStat.st_size == 0)
+  {
+    close(descriptor);
+    return; // a mapping of zero bytes is not allowed
+  }
+
+  void* view{ mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0) };
+  close(descriptor); // the mapping keeps the file referenced
+  if (view == MAP_FAILED)
+  {
+    throw std::runtime_error{ "Failed to map file." };
+  }
+  data = static_cast<const uint8_t*>(view);
+  size = static_cast<size_t>(fileStat.st_size);
+  // the advice values are not flags and can not be combined, failure only costs the read ahead
+  madvise(view, size, MADV_SEQUENTIAL);
+  madvise(view, size, MADV_WILLNEED);
+}
+
+void MappedFile::release()
+{
+  if (data)
+  {
+    munmap(const_cast<uint8_t*>(data), size);
+    data = nullptr;
+  }
+  size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+  release();
+}
+
+std::span<const uint8_t> MappedFile::get() const
+{
+  return { data, size };
+}
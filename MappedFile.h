@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include <stdint.h>
+
+/*
+  Read only memory mapping of a whole file, used to hand raw data to the coder without copying it.
+  The mapping is hinted for one sequential pass, so the system reads ahead and can drop pages behind the reader.
+  Uses the file mapping API on Windows and mmap with madvise otherwise.
+*/
+
+class MappedFile
+{
+private:
+  const uint8_t* data;
+  size_t size;
+#ifdef _WIN32
+  void* fileHandle;
+  void* mappingHandle;
+#endif
+
+  void release();
+public:
+  // throws if the file can not be mapped, an empty file results in an empty mapping
+  explicit MappedFile(const std::filesystem::path& file);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  std::span<const uint8_t> get() const;
+};
@@ -0,0 +1,296 @@
+#include "Microbenchmark.h"
+
+#include "Console.h"
+#include "Gm1Coder.h"
+#include "ResourceMetaFormat.h"
+
+#include <fstream>
+#include <format>
+#include <chrono>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace Microbenchmark
+{
+  // same as the alpha the TGX coder uses for indexed colors, the lower byte is the palette index
+  static constexpr uint16_t INDEXED_COLOR_ALPHA{ 0xff00 };
+  static constexpr uint16_t OPAQUE_ALPHA_BIT{ 0x8000 };
+
+  // a sample repeats the operation until this time is reached, to reduce the timer overhead
+  static constexpr std::chrono::microseconds MIN_SAMPLE_DURATION{ 2000 };
+  static constexpr int LONG_REPEAT_LENGTH{ 64 };
+
+  enum class Pattern
+  {
+    ALL_TRANSPARENT, // only transparent pixels
+    UNIQUE, // every pixel differs from its neighbors
+    LONG_REPEATS, // long runs of the same color
+  };
+
+  static std::string_view getPatternName(const Pattern pattern)
+  {
+    switch (pattern)
+    {
+    case Pattern::ALL_TRANSPARENT:
+      return "transparent";
+    case Pattern::UNIQUE:
+      return "unique";
+    case Pattern::LONG_REPEATS:
+      return "long repeats";
+    default:
+      return "unknown";
+    }
+  }
+
+  static uint16_t createColor(const size_t index, const bool indexed)
+  {
+    if (indexed)
+    {
+      return INDEXED_COLOR_ALPHA | static_cast<uint16_t>(index % 256);
+    }
+    // odd factor keeps neighbors different, the alpha bit keeps it away from the default transparent color
+    return OPAQUE_ALPHA_BIT | static_cast<uint16_t>((index * 7919) % OPAQUE_ALPHA_BIT);
+  }
+
+  static std::vector<uint16_t> createRaw(const Pattern pattern, const int width, const int height, const bool indexed,
+    const TgxCoderInstruction& instructions)
+  {
+    std::vector<uint16_t> raw(static_cast<size_t>(width) * height, instructions.transparentPixelRawColor);
+    if (pattern == Pattern::ALL_TRANSPARENT)
+    {
+      return raw;
+    }
+    for (size_t i{ 0 }; i < raw.size(); ++i)
+    {
+      uint16_t color{ createColor(pattern == Pattern::LONG_REPEATS ? i / LONG_REPEAT_LENGTH : i, indexed) };
+      if (color == instructions.transparentPixelRawColor || color == instructions.transparentPixelTgxColor)
+      {
+        color ^= 1;
+      }
+      raw[i] = color;
+    }
+    return raw;
+  }
+
+  // returns the median duration of one run in the samples
+  static std::chrono::duration<double, std::nano> measure(const int samples, const std::function<void()>& operation)
+  {
+    operation(); // warm up
+    std::vector<std::chrono::duration<double, std::nano>> results{};
+    results.reserve(samples);
+    for (int sample{ 0 }; sample < samples; ++sample)
+    {
+      int runs{ 0 };
+      const auto start{ std::chrono::steady_clock::now() };
+      std::chrono::steady_clock::duration elapsed{};
+      do
+      {
+        operation();
+        ++runs;
+        elapsed = std::chrono::steady_clock::now() - start;
+      } while (elapsed < MIN_SAMPLE_DURATION);
+      results.emplace_back(std::chrono::duration<double, std::nano>{ elapsed } / runs);
+    }
+    std::sort(results.begin(), results.end());
+    return results[results.size() / 2];
+  }
+
+  static void checkTgxResult(const TgxCoderResult result, const TgxCoderResult expected)
+  {
+    if (result != expected)
+    {
+      throw std::runtime_error{ getTgxResultDescription(result) };
+    }
+  }
+
+  static void checkGm1Result(const Gm1CoderResult result, const Gm1CoderResult expected)
+  {
+    if (result != expected)
+    {
+      throw std::runtime_error{ getGm1ResultDescription(result) };
+    }
+  }
+
+  static void addTgxCases(std::vector<MicrobenchmarkResult>& results, const Pattern pattern, const bool indexed, const MicrobenchmarkSettings& settings)
+  {
+    const int width{ settings.width };
+    const int height{ settings.height };
+    const double pixels{ static_cast<double>(width) * height };
+    const TgxColorType colorType{ indexed ? TgxColorType::INDEXED : TgxColorType::DEFAULT };
+    const std::string suffix{ std::format("{}/{}", getPatternName(pattern), indexed ? "indexed" : "default") };
+
+    std::vector<uint16_t> raw{ createRaw(pattern, width, height, indexed, settings.instructions) };
+    const TgxCoderRawInfo rawInfo{ .data{ raw.data() }, .rawWidth{ width }, .rawHeight{ height }, .rawX{ 0 }, .rawY{ 0 } };
+    TgxCoderTgxInfo tgxInfo{ .colorType{ colorType }, .data{ nullptr }, .dataSize{ 0 }, .tgxWidth{ width }, .tgxHeight{ height } };
+    checkTgxResult(encodeRawToTgx(&rawInfo, &tgxInfo, &settings.instructions), TgxCoderResult::FILLED_ENCODING_SIZE);
+    std::vector<uint8_t> encoded(tgxInfo.dataSize);
+    tgxInfo.data = encoded.data();
+    checkTgxResult(encodeRawToTgx(&rawInfo, &tgxInfo, &settings.instructions), TgxCoderResult::SUCCESS);
+
+    const std::chrono::duration<double, std::nano> encodeDuration{ measure(settings.samples, [&]()
+      {
+        TgxCoderTgxInfo encodeInfo{ tgxInfo };
+        encodeInfo.dataSize = static_cast<uint32_t>(encoded.size());
+        checkTgxResult(encodeRawToTgx(&rawInfo, &encodeInfo, &settings.instructions), TgxCoderResult::SUCCESS);
+      }) };
+    results.emplace_back(std::format("encodeRawToTgx/{}", suffix), encodeDuration.count() / pixels);
+
+    const std::chrono::duration<double, std::nano> predictDuration{ measure(settings.samples, [&]()
+      {
+        TgxCoderTgxInfo predictInfo{ tgxInfo };
+        checkTgxResult(predictRawToTgxSize(&rawInfo, &predictInfo, &settings.instructions), TgxCoderResult::FILLED_ENCODING_SIZE);
+        if (predictInfo.dataSize != encoded.size())
+        {
+          throw std::runtime_error{ "Predicted TGX size does not match the encoded size." };
+        }
+      }) };
+    results.emplace_back(std::format("predictRawToTgxSize/{}", suffix), predictDuration.count() / pixels);
+
+    std::vector<uint16_t> decoded(raw.size(), settings.instructions.transparentPixelRawColor);
+    const std::chrono::duration<double, std::nano> decodeDuration{ measure(settings.samples, [&]()
+      {
+        TgxCoderRawInfo decodeInfo{ .data{ decoded.data() }, .rawWidth{ width }, .rawHeight{ height }, .rawX{ 0 }, .rawY{ 0 } };
+        checkTgxResult(decodeTgxToRaw(&tgxInfo, &decodeInfo, nullptr), TgxCoderResult::SUCCESS);
+      }) };
+    results.emplace_back(std::format("decodeTgxToRaw/{}", suffix), decodeDuration.count() / pixels);
+  }
+
+  static void addTileCases(std::vector<MicrobenchmarkResult>& results, const MicrobenchmarkSettings& settings)
+  {
+    constexpr double pixels{ TILE_WIDTH * TILE_HEIGHT };
+    std::vector<uint16_t> raw{ createRaw(Pattern::UNIQUE, TILE_WIDTH, TILE_HEIGHT, false, settings.instructions) };
+    std::vector<uint16_t> tile(TILE_BYTE_SIZE / sizeof(uint16_t));
+    const Gm1CoderRawInfo rawInfo{ .raw{ raw.data() }, .rawWidth{ TILE_WIDTH }, .rawHeight{ TILE_HEIGHT }, .rawX{ 0 }, .rawY{ 0 } };
+
+    const std::chrono::duration<double, std::nano> encodeDuration{ measure(settings.samples, [&]()
+      {
+        checkGm1Result(encodeRawToTile(&rawInfo, tile.data()), Gm1CoderResult::SUCCESS);
+      }) };
+    results.emplace_back("encodeRawToTile/unique/default", encodeDuration.count() / pixels);
+
+    std::vector<uint16_t> decoded(raw.size(), settings.instructions.transparentPixelRawColor);
+    const std::chrono::duration<double, std::nano> decodeDuration{ measure(settings.samples, [&]()
+      {
+        Gm1CoderRawInfo decodeInfo{ .raw{ decoded.data() }, .rawWidth{ TILE_WIDTH }, .rawHeight{ TILE_HEIGHT }, .rawX{ 0 }, .rawY{ 0 } };
+        checkGm1Result(decodeTileToRaw(tile.data(), &decodeInfo), Gm1CoderResult::SUCCESS);
+      }) };
+    results.emplace_back("decodeTileToRaw/unique/default", decodeDuration.count() / pixels);
+  }
+
+  // the uncompressed format only allows transparency in whole lines at the end, so every pattern works
+  static void addUncompressedCases(std::vector<MicrobenchmarkResult>& results, const Pattern pattern, const MicrobenchmarkSettings& settings)
+  {
+    const int width{ settings.width };
+    const int height{ settings.height };
+    const double pixels{ static_cast<double>(width) * height };
+    const uint16_t transparentColor{ settings.instructions.transparentPixelRawColor };
+    const std::string suffix{ std::format("{}/default", getPatternName(pattern)) };
+
+    std::vector<uint16_t> raw{ createRaw(pattern, width, height, false, settings.instructions) };
+    const Gm1CoderRawInfo rawInfo{ .raw{ raw.data() }, .rawWidth{ width }, .rawHeight{ height }, .rawX{ 0 }, .rawY{ 0 } };
+    Gm1CoderDataInfo dataInfo{ .data{ nullptr }, .dataSize{ 0 }, .dataWidth{ width }, .dataHeight{ height } };
+    checkGm1Result(copyRawToUncompressed(&rawInfo, &dataInfo, transparentColor), Gm1CoderResult::FILLED_ENCODING_SIZE);
+    // at least one byte, since a missing buffer would request the size again
+    std::vector<uint8_t> data(std::max<size_t>(dataInfo.dataSize, 1));
+    dataInfo.data = data.data();
+
+    const std::chrono::duration<double, std::nano> encodeDuration{ measure(settings.samples, [&]()
+      {
+        checkGm1Result(copyRawToUncompressed(&rawInfo, &dataInfo, transparentColor), Gm1CoderResult::SUCCESS);
+      }) };
+    results.emplace_back(std::format("copyRawToUncompressed/{}", suffix), encodeDuration.count() / pixels);
+
+    std::vector<uint16_t> decoded(raw.size(), transparentColor);
+    const std::chrono::duration<double, std::nano> decodeDuration{ measure(settings.samples, [&]()
+      {
+        Gm1CoderRawInfo decodeInfo{ .raw{ decoded.data() }, .rawWidth{ width }, .rawHeight{ height }, .rawX{ 0 }, .rawY{ 0 } };
+        checkGm1Result(copyUncompressedToRaw(&dataInfo, &decodeInfo, transparentColor), Gm1CoderResult::SUCCESS);
+      }) };
+    results.emplace_back(std::format("copyUncompressedToRaw/{}", suffix), decodeDuration.count() / pixels);
+  }
+
+  std::vector<MicrobenchmarkResult> runMicrobenchmarks(const MicrobenchmarkSettings& settings)
+  {
+    constexpr Pattern PATTERNS[]{ Pattern::ALL_TRANSPARENT, Pattern::UNIQUE, Pattern::LONG_REPEATS };
+
+    std::vector<MicrobenchmarkResult> results{};
+    for (const Pattern pattern : PATTERNS)
+    {
+      Log(LogLevel::DEBUG, "Running cases for pattern '{}'.", getPatternName(pattern));
+      addTgxCases(results, pattern, false, settings);
+      addTgxCases(results, pattern, true, settings);
+      addUncompressedCases(results, pattern, settings);
+    }
+    addTileCases(results, settings);
+    return results;
+  }
+
+  void saveBaseline(const std::filesystem::path& file, const std::vector<MicrobenchmarkResult>& results)
+  {
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    out.open(file, std::ios::out | std::ios::trunc); // text handling
+
+    auto metaWriter{ ResourceMetaFormat::ResourceMetaFileWriter::startFile(out, ResourceMetaFormat::VERSION::CURRENT) };
+    metaWriter.startHeader()
+      .endObject();
+    auto& objectWriter{ metaWriter.startObject(BaselineMeta::RESOURCE_IDENTIFIER, BaselineMeta::CURRENT_VERSION, "ns per pixel") };
+    for (const MicrobenchmarkResult& result : results)
+    {
+      objectWriter.writeMapEntry(result.name, std::format("{:.4f}", result.nanosecondsPerPixel));
+    }
+    objectWriter.endObject()
+      .endFile();
+  }
+
+  std::map<std::string, double, std::less<>> loadBaseline(const std::filesystem::path& file)
+  {
+    std::ifstream in;
+    in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    in.open(file, std::ios::in); // text handling
+
+    auto reader{ ResourceMetaFormat::ResourceMetaFileStreamReader::startFrom(in) };
+    const std::optional<ResourceMetaFormat::ResourceMetaObjectReader> baselineObject{ reader.next() };
+    if (!baselineObject || baselineObject->getIdentifier() != BaselineMeta::RESOURCE_IDENTIFIER)
+    {
+      throw std::invalid_argument{ std::format("Baseline file has no {} object.", BaselineMeta::RESOURCE_IDENTIFIER) };
+    }
+    if (std::find(std::begin(BaselineMeta::SUPPORTED_VERSIONS), std::end(BaselineMeta::SUPPORTED_VERSIONS), baselineObject->getVersion())
+      == std::end(BaselineMeta::SUPPORTED_VERSIONS))
+    {
+      throw std::invalid_argument{ std::format("{} object has no supported version.", BaselineMeta::RESOURCE_IDENTIFIER) };
+    }
+
+    std::map<std::string, double, std::less<>> baseline{};
+    for (const auto& [name, valueStr] : baselineObject->getMapEntries())
+    {
+      double value{ 0.0 };
+      const auto [end, errorCode] { std::from_chars(valueStr.data(), valueStr.data() + valueStr.size(), value) };
+      if (errorCode != std::errc{} || end != valueStr.data() + valueStr.size())
+      {
+        throw std::invalid_argument{ std::format("Baseline value of '{}' is not a number.", name) };
+      }
+      baseline.emplace(name, value);
+    }
+    return baseline;
+  }
+
+  void printResults(const std::vector<MicrobenchmarkResult>& results, const std::map<std::string, double, std::less<>>& baseline)
+  {
+    Out("### Microbenchmark results ###\n");
+    Out("{:<50} {:>12} {:>12} {:>9}\n", "Case", "ns/pixel", "baseline", "change");
+    for (const MicrobenchmarkResult& result : results)
+    {
+      const auto it{ baseline.find(result.name) };
+      if (it == baseline.end() || it->second <= 0.0)
+      {
+        Out("{:<50} {:>12.4f}\n", result.name, result.nanosecondsPerPixel);
+        continue;
+      }
+      const double change{ (result.nanosecondsPerPixel / it->second - 1.0) * 100.0 };
+      Out("{:<50} {:>12.4f} {:>12.4f} {:>+8.1f}%\n", result.name, result.nanosecondsPerPixel, it->second, change);
+    }
+  }
+}
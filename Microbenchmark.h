@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TGXCoder.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+// measures the coder C API on generated images, independent of any game file
+// every case is reported in ns per pixel and can be compared against a saved baseline
+
+namespace Microbenchmark
+{
+  namespace BaselineMeta
+  {
+    inline constexpr std::string_view RESOURCE_IDENTIFIER{ "MicrobenchmarkBaseline" };
+    inline constexpr int CURRENT_VERSION{ 1 };
+    inline constexpr int SUPPORTED_VERSIONS[]{ 1 };
+  }
+
+  struct MicrobenchmarkSettings
+  {
+    int width;
+    int height;
+    int samples; // the median of the samples is reported
+    TgxCoderInstruction instructions;
+  };
+
+  struct MicrobenchmarkResult
+  {
+    std::string name; // operation/pattern/color type
+    double nanosecondsPerPixel;
+  };
+
+  std::vector<MicrobenchmarkResult> runMicrobenchmarks(const MicrobenchmarkSettings& settings);
+
+  // the baseline is a resource meta file with the case names as keys
+  void saveBaseline(const std::filesystem::path& file, const std::vector<MicrobenchmarkResult>& results);
+  std::map<std::string, double, std::less<>> loadBaseline(const std::filesystem::path& file);
+
+  // prints the results, with the relative change to the baseline for every case it contains
+  void printResults(const std::vector<MicrobenchmarkResult>& results, const std::map<std::string, double, std::less<>>& baseline);
+}
@@ -0,0 +1,238 @@
+#include "PixelConversion.h"
+
+#include <format>
+#include <stdexcept>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PIXEL_CONVERSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace PixelConversion
+{
+  RawPixelFormat rawPixelFormatFromStr(const std::string& str)
+  {
+    for (const RawPixelFormat format : { RawPixelFormat::ARGB_1555, RawPixelFormat::RGBA_8888, RawPixelFormat::INDEXED_8 })
+    {
+      if (str == getRawPixelFormatName(format))
+      {
+        return format;
+      }
+    }
+    throw std::invalid_argument{ std::format("Unknown raw pixel format '{}'.", str) };
+  }
+
+  std::string_view getRawPixelFormatName(const RawPixelFormat format)
+  {
+    switch (format)
+    {
+    case RawPixelFormat::ARGB_1555:
+      return "argb1555";
+    case RawPixelFormat::RGBA_8888:
+      return "rgba8888";
+    case RawPixelFormat::INDEXED_8:
+      return "indexed8";
+
+    default:
+      return "unknown";
+    }
+  }
+
+  size_t getRawPixelFormatByteSize(const RawPixelFormat format)
+  {
+    switch (format)
+    {
+    case RawPixelFormat::RGBA_8888:
+      return sizeof(uint32_t);
+    case RawPixelFormat::INDEXED_8:
+      return sizeof(uint8_t);
+
+    default:
+      return sizeof(uint16_t);
+    }
+  }
+
+  static void checkSizes(const size_t sourceSize, const size_t targetSize)
+  {
+    if (sourceSize != targetSize)
+    {
+      throw std::invalid_argument{ "Source and target of a pixel conversion have different sizes." };
+    }
+  }
+
+  /* SCALAR */
+
+  static uint32_t expand5(const uint32_t value)
+  {
+    return (value << 3) | (value >> 2);
+  }
+
+  static uint32_t expand6(const uint32_t value)
+  {
+    return (value << 2) | (value >> 4);
+  }
+
+  // round(value * maximum / 255), exact for all products up to 255 * 255
+  static uint32_t reduceChannel(const uint32_t value, const uint32_t maximum)
+  {
+    const uint32_t scaled{ value * maximum + 128 };
+    return (scaled + (scaled >> 8)) >> 8;
+  }
+
+  static uint32_t scalarArgb1555ToRgba8888(const uint16_t pixel)
+  {
+    return expand5((pixel >> 10) & 0x1f) | (expand5((pixel >> 5) & 0x1f) << 8) | (expand5(pixel & 0x1f) << 16) | ((pixel & 0x8000) ? 0xff000000u : 0u);
+  }
+
+  static uint32_t scalarRgb565ToRgba8888(const uint16_t pixel)
+  {
+    return expand5((pixel >> 11) & 0x1f) | (expand6((pixel >> 5) & 0x3f) << 8) | (expand5(pixel & 0x1f) << 16) | 0xff000000u;
+  }
+
+  static uint16_t scalarRgba8888ToArgb1555(const uint32_t pixel)
+  {
+    return static_cast<uint16_t>(((pixel >> 31) << 15) | (reduceChannel(pixel & 0xff, 31) << 10)
+      | (reduceChannel((pixel >> 8) & 0xff, 31) << 5) | reduceChannel((pixel >> 16) & 0xff, 31));
+  }
+
+  static uint16_t scalarRgba8888ToRgb565(const uint32_t pixel)
+  {
+    return static_cast<uint16_t>((reduceChannel(pixel & 0xff, 31) << 11) | (reduceChannel((pixel >> 8) & 0xff, 63) << 5)
+      | reduceChannel((pixel >> 16) & 0xff, 31));
+  }
+
+  /* SSE2 */
+
+#ifdef PIXEL_CONVERSION_SSE2
+
+  static constexpr size_t SIMD_PIXELS{ 8 };
+
+  static __m128i expand5Simd(const __m128i value)
+  {
+    return _mm_or_si128(_mm_slli_epi16(value, 3), _mm_srli_epi16(value, 2));
+  }
+
+  static __m128i expand6Simd(const __m128i value)
+  {
+    return _mm_or_si128(_mm_slli_epi16(value, 2), _mm_srli_epi16(value, 4));
+  }
+
+  static __m128i reduceChannelSimd(const __m128i value, const int16_t maximum)
+  {
+    const __m128i scaled{ _mm_add_epi16(_mm_mullo_epi16(value, _mm_set1_epi16(maximum)), _mm_set1_epi16(128)) };
+    return _mm_srli_epi16(_mm_add_epi16(scaled, _mm_srli_epi16(scaled, 8)), 8);
+  }
+
+  // takes 16 bit lanes of channel values up to 255 and stores them as 8 RGBA8888 pixels
+  static void storeRgba8888(const __m128i r, const __m128i g, const __m128i b, const __m128i a, uint32_t* target)
+  {
+    const __m128i rg{ _mm_or_si128(r, _mm_slli_epi16(g, 8)) };
+    const __m128i ba{ _mm_or_si128(b, _mm_slli_epi16(a, 8)) };
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4), _mm_unpackhi_epi16(rg, ba));
+  }
+
+  // loads 8 RGBA8888 pixels as 16 bit lanes per channel
+  static void loadRgba8888(const uint32_t* source, __m128i& r, __m128i& g, __m128i& b, __m128i& a)
+  {
+    const __m128i low{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)) };
+    const __m128i high{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4)) };
+    const __m128i byteMask{ _mm_set1_epi32(0xff) };
+    r = _mm_packs_epi32(_mm_and_si128(low, byteMask), _mm_and_si128(high, byteMask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, 8), byteMask), _mm_and_si128(_mm_srli_epi32(high, 8), byteMask));
+    b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, 16), byteMask), _mm_and_si128(_mm_srli_epi32(high, 16), byteMask));
+    a = _mm_packs_epi32(_mm_srli_epi32(low, 24), _mm_srli_epi32(high, 24));
+  }
+
+#endif
+
+  void argb1555ToRgba8888(std::span<const uint16_t> source, std::span<uint32_t> target)
+  {
+    checkSizes(source.size(), target.size());
+    size_t i{ 0 };
+#ifdef PIXEL_CONVERSION_SSE2
+    const __m128i fiveBits{ _mm_set1_epi16(0x1f) };
+    for (; i + SIMD_PIXELS <= source.size(); i += SIMD_PIXELS)
+    {
+      const __m128i pixels{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + i)) };
+      storeRgba8888(
+        expand5Simd(_mm_and_si128(_mm_srli_epi16(pixels, 10), fiveBits)),
+        expand5Simd(_mm_and_si128(_mm_srli_epi16(pixels, 5), fiveBits)),
+        expand5Simd(_mm_and_si128(pixels, fiveBits)),
+        _mm_srli_epi16(_mm_srai_epi16(pixels, 15), 8),
+        target.data() + i);
+    }
+#endif
+    for (; i < source.size(); ++i)
+    {
+      target[i] = scalarArgb1555ToRgba8888(source[i]);
+    }
+  }
+
+  void rgb565ToRgba8888(std::span<const uint16_t> source, std::span<uint32_t> target)
+  {
+    checkSizes(source.size(), target.size());
+    size_t i{ 0 };
+#ifdef PIXEL_CONVERSION_SSE2
+    const __m128i fiveBits{ _mm_set1_epi16(0x1f) };
+    const __m128i sixBits{ _mm_set1_epi16(0x3f) };
+    const __m128i opaque{ _mm_set1_epi16(0xff) };
+    for (; i + SIMD_PIXELS <= source.size(); i += SIMD_PIXELS)
+    {
+      const __m128i pixels{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + i)) };
+      storeRgba8888(
+        expand5Simd(_mm_and_si128(_mm_srli_epi16(pixels, 11), fiveBits)),
+        expand6Simd(_mm_and_si128(_mm_srli_epi16(pixels, 5), sixBits)),
+        expand5Simd(_mm_and_si128(pixels, fiveBits)),
+        opaque,
+        target.data() + i);
+    }
+#endif
+    for (; i < source.size(); ++i)
+    {
+      target[i] = scalarRgb565ToRgba8888(source[i]);
+    }
+  }
+
+  void rgba8888ToArgb1555(std::span<const uint32_t> source, std::span<uint16_t> target)
+  {
+    checkSizes(source.size(), target.size());
+    size_t i{ 0 };
+#ifdef PIXEL_CONVERSION_SSE2
+    for (; i + SIMD_PIXELS <= source.size(); i += SIMD_PIXELS)
+    {
+      __m128i r, g, b, a;
+      loadRgba8888(source.data() + i, r, g, b, a);
+      const __m128i pixels{ _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(a, 7), 15), _mm_slli_epi16(reduceChannelSimd(r, 31), 10)),
+        _mm_or_si128(_mm_slli_epi16(reduceChannelSimd(g, 31), 5), reduceChannelSimd(b, 31))) };
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(target.data() + i), pixels);
+    }
+#endif
+    for (; i < source.size(); ++i)
+    {
+      target[i] = scalarRgba8888ToArgb1555(source[i]);
+    }
+  }
+
+  void rgba8888ToRgb565(std::span<const uint32_t> source, std::span<uint16_t> target)
+  {
+    checkSizes(source.size(), target.size());
+    size_t i{ 0 };
+#ifdef PIXEL_CONVERSION_SSE2
+    for (; i + SIMD_PIXELS <= source.size(); i += SIMD_PIXELS)
+    {
+      __m128i r, g, b, a;
+      loadRgba8888(source.data() + i, r, g, b, a);
+      const __m128i pixels{ _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi16(reduceChannelSimd(r, 31), 11), _mm_slli_epi16(reduceChannelSimd(g, 63), 5)),
+        reduceChannelSimd(b, 31)) };
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(target.data() + i), pixels);
+    }
+#endif
+    for (; i < source.size(); ++i)
+    {
+      target[i] = scalarRgba8888ToRgb565(source[i]);
+    }
+  }
+}
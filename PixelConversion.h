@@ -0,0 +1,38 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <stdint.h>
+
+/*
+  Conversion kernels between the 16 bit game formats and RGBA8888.
+  RGBA8888 pixels are stored as bytes in the order R, G, B, A, which is a uint32_t of 0xAABBGGRR on little endian.
+  - Expanding to 8 bit repeats the highest bits in the lowest ones, so 0 stays 0 and the maximum becomes 255.
+  - Reducing to fewer bits rounds to the nearest value, which makes expanding and reducing again lossless.
+  - ARGB1555 maps its alpha bit to 0 or 255 and back by the highest bit of the alpha byte, RGB565 is always opaque.
+  SSE2 is used if the target supports it, the scalar versions handle the remaining pixels and other targets.
+  The spans of one call need the same number of pixels.
+*/
+
+namespace PixelConversion
+{
+  // the formats the raw data file can use
+  enum class RawPixelFormat : int
+  {
+    ARGB_1555, // the native format of the canvas
+    RGBA_8888,
+    INDEXED_8, // palette indices of animations, with the transparency in a separate bit mask
+  };
+
+  // accepts "argb1555", "rgba8888" and "indexed8", throws std::invalid_argument otherwise
+  RawPixelFormat rawPixelFormatFromStr(const std::string& str);
+  std::string_view getRawPixelFormatName(RawPixelFormat format);
+  size_t getRawPixelFormatByteSize(RawPixelFormat format);
+
+  void argb1555ToRgba8888(std::span<const uint16_t> source, std::span<uint32_t> target);
+  void rgb565ToRgba8888(std::span<const uint16_t> source, std::span<uint32_t> target);
+  void rgba8888ToArgb1555(std::span<const uint32_t> source, std::span<uint16_t> target);
+  void rgba8888ToRgb565(std::span<const uint32_t> source, std::span<uint16_t> target);
+}
@@ -0,0 +1,510 @@
+#include "PngFile.h"
+
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <format>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace PngFile
+{
+  PngFormat pngFormatFromStr(const std::string& str)
+  {
+    for (const PngFormat format : { PngFormat::NONE, PngFormat::RGBA8, PngFormat::RGBA16 })
+    {
+      if (str == getPngFormatName(format))
+      {
+        return format;
+      }
+    }
+    throw std::invalid_argument{ std::format("Unknown PNG format '{}'.", str) };
+  }
+
+  std::string_view getPngFormatName(const PngFormat format)
+  {
+    switch (format)
+    {
+    case PngFormat::NONE:
+      return "none";
+    case PngFormat::RGBA8:
+      return "rgba8";
+    case PngFormat::RGBA16:
+      return "rgba16";
+
+    default:
+      return "unknown";
+    }
+  }
+
+  /* CHECKSUMS */
+
+  static constexpr std::array<uint32_t, 256> CRC_TABLE{ []()
+    {
+      std::array<uint32_t, 256> table{};
+      for (uint32_t i{ 0 }; i < 256; ++i)
+      {
+        uint32_t crc{ i };
+        for (int bit{ 0 }; bit < 8; ++bit)
+        {
+          crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+        }
+        table[i] = crc;
+      }
+      return table;
+    }() };
+
+  static uint32_t updateCrc(uint32_t crc, std::span<const uint8_t> data)
+  {
+    for (const uint8_t byte : data)
+    {
+      crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+  static constexpr uint32_t ADLER_MODULO{ 65521 };
+
+  static uint32_t computeAdler32(std::span<const uint8_t> data)
+  {
+    uint32_t a{ 1 };
+    uint32_t b{ 0 };
+    constexpr size_t MAX_BLOCK{ 5552 }; // largest number of bytes before b could overflow
+    while (!data.empty())
+    {
+      const size_t blockSize{ std::min(data.size(), MAX_BLOCK) };
+      for (const uint8_t byte : data.first(blockSize))
+      {
+        a += byte;
+        b += a;
+      }
+      a %= ADLER_MODULO;
+      b %= ADLER_MODULO;
+      data = data.subspan(blockSize);
+    }
+    return (b << 16) | a;
+  }
+
+  // checksum of the concatenation, if the second part has the given length
+  static uint32_t combineAdler32(const uint32_t first, const uint32_t second, const uint64_t secondLength)
+  {
+    const uint64_t remainder{ secondLength % ADLER_MODULO };
+    const uint64_t firstA{ first & 0xffff };
+    const uint64_t firstB{ first >> 16 };
+    const uint64_t secondA{ second & 0xffff };
+    const uint64_t secondB{ second >> 16 };
+    const uint64_t a{ (firstA + secondA + ADLER_MODULO - 1) % ADLER_MODULO };
+    const uint64_t b{ (firstB + secondB + remainder * firstA + ADLER_MODULO - remainder) % ADLER_MODULO };
+    return static_cast<uint32_t>((b << 16) | a);
+  }
+
+  /* DEFLATE */
+
+  static constexpr int WINDOW_SIZE{ 32768 };
+  static constexpr int MIN_MATCH{ 3 };
+  static constexpr int MAX_MATCH{ 258 };
+  static constexpr int HASH_BITS{ 15 };
+  static constexpr int MAX_CHAIN{ 32 };
+
+  static constexpr uint16_t LENGTH_BASE[]{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+  static constexpr uint8_t LENGTH_EXTRA_BITS[]{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+  static constexpr uint16_t DISTANCE_BASE[]{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+  static constexpr uint8_t DISTANCE_EXTRA_BITS[]{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+  static constexpr uint32_t reverseBits(uint32_t value, const int count)
+  {
+    uint32_t result{ 0 };
+    for (int i{ 0 }; i < count; ++i)
+    {
+      result = (result << 1) | (value & 1);
+      value >>= 1;
+    }
+    return result;
+  }
+
+  struct HuffmanCode
+  {
+    uint16_t code; // already reversed, since deflate writes Huffman codes starting with the highest bit
+    uint8_t length;
+  };
+
+  static constexpr std::array<HuffmanCode, 288> FIXED_LITERAL_CODES{ []()
+    {
+      std::array<HuffmanCode, 288> codes{};
+      for (uint32_t symbol{ 0 }; symbol < 288; ++symbol)
+      {
+        uint32_t code;
+        int length;
+        if (symbol < 144)
+        {
+          code = 0x30 + symbol;
+          length = 8;
+        }
+        else if (symbol < 256)
+        {
+          code = 0x190 + symbol - 144;
+          length = 9;
+        }
+        else if (symbol < 280)
+        {
+          code = symbol - 256;
+          length = 7;
+        }
+        else
+        {
+          code = 0xc0 + symbol - 280;
+          length = 8;
+        }
+        codes[symbol] = HuffmanCode{ static_cast<uint16_t>(reverseBits(code, length)), static_cast<uint8_t>(length) };
+      }
+      return codes;
+    }() };
+
+  class BitWriter
+  {
+  private:
+    std::vector<uint8_t>& out;
+    uint64_t bitBuffer;
+    int bitCount;
+  public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out{ out }, bitBuffer{ 0 }, bitCount{ 0 } {}
+
+    void writeBits(const uint32_t value, const int count)
+    {
+      bitBuffer |= static_cast<uint64_t>(value) << bitCount;
+      bitCount += count;
+      while (bitCount >= 8)
+      {
+        out.push_back(static_cast<uint8_t>(bitBuffer));
+        bitBuffer >>= 8;
+        bitCount -= 8;
+      }
+    }
+
+    void alignToByte()
+    {
+      if (bitCount > 0)
+      {
+        writeBits(0, 8 - bitCount);
+      }
+    }
+  };
+
+  static void writeLiteral(BitWriter& writer, const int symbol)
+  {
+    const HuffmanCode& code{ FIXED_LITERAL_CODES[symbol] };
+    writer.writeBits(code.code, code.length);
+  }
+
+  static void writeMatch(BitWriter& writer, const int length, const int distance)
+  {
+    int lengthIndex{ 28 };
+    while (LENGTH_BASE[lengthIndex] > length)
+    {
+      --lengthIndex;
+    }
+    writeLiteral(writer, 257 + lengthIndex);
+    writer.writeBits(length - LENGTH_BASE[lengthIndex], LENGTH_EXTRA_BITS[lengthIndex]);
+
+    int distanceIndex{ 29 };
+    while (DISTANCE_BASE[distanceIndex] > distance)
+    {
+      --distanceIndex;
+    }
+    writer.writeBits(reverseBits(distanceIndex, 5), 5); // fixed distance codes are the plain 5 bit index
+    writer.writeBits(distance - DISTANCE_BASE[distanceIndex], DISTANCE_EXTRA_BITS[distanceIndex]);
+  }
+
+  static uint32_t hashAt(const uint8_t* data)
+  {
+    const uint32_t value{ (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2] };
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+  // compresses the data independently of other blocks and ends byte aligned, the last block finishes the deflate stream
+  static std::vector<uint8_t> deflateBlock(std::span<const uint8_t> data, const bool lastBlock)
+  {
+    std::vector<uint8_t> out{};
+    out.reserve(data.size() / 4 + 64);
+    BitWriter writer{ out };
+
+    writer.writeBits(0, 1); // not final, the stream ends with the empty stored block below
+    writer.writeBits(1, 2); // fixed Huffman codes
+
+    const int size{ static_cast<int>(data.size()) };
+    std::vector<int32_t> head(size_t{ 1 } << HASH_BITS, -1);
+    std::vector<int32_t> previous(data.size());
+    const auto insertHash{ [&](const int position)
+      {
+        if (position + MIN_MATCH > size)
+        {
+          return;
+        }
+        const uint32_t hash{ hashAt(data.data() + position) };
+        previous[position] = head[hash];
+        head[hash] = position;
+      }
+    };
+
+    int position{ 0 };
+    while (position < size)
+    {
+      int bestLength{ 0 };
+      int bestDistance{ 0 };
+      if (position + MIN_MATCH <= size)
+      {
+        const int maxLength{ std::min(MAX_MATCH, size - position) };
+        int candidate{ head[hashAt(data.data() + position)] };
+        for (int chain{ 0 }; candidate >= 0 && position - candidate <= WINDOW_SIZE && chain < MAX_CHAIN; ++chain)
+        {
+          int length{ 0 };
+          while (length < maxLength && data[candidate + length] == data[position + length])
+          {
+            ++length;
+          }
+          if (length > bestLength)
+          {
+            bestLength = length;
+            bestDistance = position - candidate;
+            if (length == maxLength)
+            {
+              break;
+            }
+          }
+          candidate = previous[candidate];
+        }
+      }
+
+      if (bestLength >= MIN_MATCH)
+      {
+        writeMatch(writer, bestLength, bestDistance);
+        for (int i{ 0 }; i < bestLength; ++i)
+        {
+          insertHash(position + i);
+        }
+        position += bestLength;
+      }
+      else
+      {
+        writeLiteral(writer, data[position]);
+        insertHash(position);
+        ++position;
+      }
+    }
+    writeLiteral(writer, 256); // end of block
+
+    // empty stored block, aligns the output to a byte boundary
+    writer.writeBits(lastBlock ? 1 : 0, 1);
+    writer.writeBits(0, 2);
+    writer.alignToByte();
+    out.insert(out.end(), { 0x00, 0x00, 0xff, 0xff });
+    return out;
+  }
+
+  /* PNG */
+
+  static constexpr size_t TARGET_BLOCK_BYTES{ 256 * 1024 };
+
+  static uint8_t expandTo8Bit(const uint16_t fiveBits)
+  {
+    return static_cast<uint8_t>((fiveBits << 3) | (fiveBits >> 2));
+  }
+
+  static void convertRow(const PngSource& source, const PngFormat format, const int row, std::span<uint8_t> outRow)
+  {
+    const uint16_t* pixels{ source.data + static_cast<size_t>(row) * source.width };
+    uint8_t* out{ outRow.data() };
+    for (int x{ 0 }; x < source.width; ++x)
+    {
+      uint16_t pixel{ pixels[x] };
+      const bool transparent{ pixel == source.transparentPixel };
+      if (source.palette && !transparent)
+      {
+        pixel = source.palette[pixel & 0xff];
+      }
+      const uint8_t rgba[]{
+        transparent ? uint8_t{ 0 } : expandTo8Bit((pixel >> 10) & 0x1f),
+        transparent ? uint8_t{ 0 } : expandTo8Bit((pixel >> 5) & 0x1f),
+        transparent ? uint8_t{ 0 } : expandTo8Bit(pixel & 0x1f),
+        transparent ? uint8_t{ 0 } : uint8_t{ 0xff }
+      };
+      for (const uint8_t channel : rgba)
+      {
+        *out++ = channel;
+        if (format == PngFormat::RGBA16)
+        {
+          *out++ = channel; // scaling by 257 repeats the byte
+        }
+      }
+    }
+  }
+
+  // chooses the filter with the smallest sum of absolute differences, a common heuristic for the best compression
+  static void filterRow(std::span<const uint8_t> row, std::span<const uint8_t> previousRow, const int bytesPerPixel, std::span<uint8_t> outFiltered)
+  {
+    const size_t size{ row.size() };
+    const auto filterByte{ [&](const int filter, const size_t i) -> uint8_t
+      {
+        const uint8_t left{ i >= static_cast<size_t>(bytesPerPixel) ? row[i - bytesPerPixel] : uint8_t{ 0 } };
+        const uint8_t up{ previousRow.empty() ? uint8_t{ 0 } : previousRow[i] };
+        switch (filter)
+        {
+        case 1:
+          return static_cast<uint8_t>(row[i] - left);
+        case 2:
+          return static_cast<uint8_t>(row[i] - up);
+
+        default:
+          return row[i];
+        }
+      }
+    };
+
+    int bestFilter{ 0 };
+    uint64_t bestSum{ std::numeric_limits<uint64_t>::max() };
+    for (int filter{ 0 }; filter < 3; ++filter)
+    {
+      uint64_t sum{ 0 };
+      for (size_t i{ 0 }; i < size && sum < bestSum; ++i)
+      {
+        sum += static_cast<uint64_t>(std::abs(static_cast<int8_t>(filterByte(filter, i))));
+      }
+      if (sum < bestSum)
+      {
+        bestSum = sum;
+        bestFilter = filter;
+      }
+    }
+
+    outFiltered[0] = static_cast<uint8_t>(bestFilter);
+    for (size_t i{ 0 }; i < size; ++i)
+    {
+      outFiltered[i + 1] = filterByte(bestFilter, i);
+    }
+  }
+
+  struct CompressedBlock
+  {
+    std::vector<uint8_t> data;
+    uint32_t adler;
+    uint64_t filteredSize;
+  };
+
+  static CompressedBlock compressRows(const PngSource& source, const PngFormat format, const int firstRow, const int endRow, const bool lastBlock)
+  {
+    const int bytesPerPixel{ format == PngFormat::RGBA16 ? 8 : 4 };
+    const size_t rowSize{ static_cast<size_t>(source.width) * bytesPerPixel };
+
+    std::vector<uint8_t> previousRow{};
+    if (firstRow > 0)
+    {
+      previousRow.resize(rowSize);
+      convertRow(source, format, firstRow - 1, previousRow);
+    }
+    std::vector<uint8_t> currentRow(rowSize);
+    std::vector<uint8_t> filtered((rowSize + 1) * (endRow - firstRow));
+    for (int row{ firstRow }; row < endRow; ++row)
+    {
+      convertRow(source, format, row, currentRow);
+      filterRow(currentRow, previousRow, bytesPerPixel, std::span{ filtered }.subspan((rowSize + 1) * (row - firstRow), rowSize + 1));
+      previousRow.swap(currentRow);
+      currentRow.resize(rowSize);
+    }
+
+    return CompressedBlock{
+      .data{ deflateBlock(filtered, lastBlock) },
+      .adler{ computeAdler32(filtered) },
+      .filteredSize{ filtered.size() }
+    };
+  }
+
+  static void writeBigEndian(std::vector<uint8_t>& out, const uint32_t value)
+  {
+    out.insert(out.end(), { static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value) });
+  }
+
+  static void writeChunk(std::ofstream& out, const std::string_view type, std::span<const uint8_t> data)
+  {
+    std::vector<uint8_t> header{};
+    writeBigEndian(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type.begin(), type.end());
+    uint32_t crc{ updateCrc(0xffffffffu, std::span{ header }.subspan(4)) };
+    crc = updateCrc(crc, data) ^ 0xffffffffu;
+    std::vector<uint8_t> footer{};
+    writeBigEndian(footer, crc);
+
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+  }
+
+  void savePng(const std::filesystem::path& file, const PngSource& source, const PngFormat format)
+  {
+    if (format == PngFormat::NONE)
+    {
+      return;
+    }
+    if (source.width <= 0 || source.height <= 0)
+    {
+      throw std::invalid_argument{ "PNG requires an image with at least one pixel." };
+    }
+
+    const size_t rowSize{ static_cast<size_t>(source.width) * (format == PngFormat::RGBA16 ? 8 : 4) + 1 };
+    const int rowsPerBlock{ static_cast<int>(std::clamp<size_t>(TARGET_BLOCK_BYTES / rowSize, 1, source.height)) };
+    const int blockCount{ (source.height + rowsPerBlock - 1) / rowsPerBlock };
+
+    std::vector<CompressedBlock> blocks(blockCount);
+    TaskPool::runParallel(blockCount, [&](const size_t block)
+      {
+        const int firstRow{ static_cast<int>(block) * rowsPerBlock };
+        blocks[block] = compressRows(source, format, firstRow, std::min(firstRow + rowsPerBlock, source.height), block == blocks.size() - 1);
+      });
+
+    uint32_t adler{ 1 };
+    for (const CompressedBlock& block : blocks)
+    {
+      adler = combineAdler32(adler, block.adler, block.filteredSize);
+    }
+
+    std::filesystem::remove(file);
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    constexpr uint8_t SIGNATURE[]{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    out.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+
+    std::vector<uint8_t> header{};
+    writeBigEndian(header, static_cast<uint32_t>(source.width));
+    writeBigEndian(header, static_cast<uint32_t>(source.height));
+    header.insert(header.end(), {
+      static_cast<uint8_t>(format == PngFormat::RGBA16 ? 16 : 8), // bit depth
+      6, // color type RGBA
+      0, // deflate
+      0, // adaptive filtering
+      0 // no interlace
+    });
+    writeChunk(out, "IHDR", header);
+
+    constexpr uint8_t ZLIB_HEADER[]{ 0x78, 0x01 }; // 32K window, fastest level hint
+    writeChunk(out, "IDAT", ZLIB_HEADER);
+    for (const CompressedBlock& block : blocks)
+    {
+      writeChunk(out, "IDAT", block.data);
+    }
+    std::vector<uint8_t> checksum{};
+    writeBigEndian(checksum, adler);
+    writeChunk(out, "IDAT", checksum);
+
+    writeChunk(out, "IEND", {});
+  }
+}
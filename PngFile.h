@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <stdint.h>
+
+/*
+  Writes raw canvases as PNG, without any external library.
+  The image is split into blocks of rows, that are filtered and deflated with TaskPool::runParallel. Every block ends on a byte boundary
+  with an empty stored block, so the compressed blocks can simply be concatenated into one zlib stream.
+  The deflate encoder uses LZ77 with hash chains and the fixed Huffman codes.
+  The PNG is only an export for viewing and editing, packing still uses the raw data file.
+*/
+
+namespace PngFile
+{
+  inline constexpr std::string_view FILE_EXTENSION{ ".png" };
+
+  enum class PngFormat : int
+  {
+    NONE, // no PNG is written
+    RGBA8,
+    RGBA16,
+  };
+
+  // accepts "none", "rgba8" and "rgba16", throws std::invalid_argument otherwise
+  PngFormat pngFormatFromStr(const std::string& str);
+  std::string_view getPngFormatName(PngFormat format);
+
+  struct PngSource
+  {
+    const uint16_t* data; // ARGB1555 canvas, the alpha bit is ignored
+    int width;
+    int height;
+    uint16_t transparentPixel; // pixels of this color are written fully transparent
+    const uint16_t* palette; // if set, the lower byte of every other pixel is an index into these 256 colors
+  };
+
+  // throws if the file can not be written
+  void savePng(const std::filesystem::path& file, const PngSource& source, PngFormat format);
+}
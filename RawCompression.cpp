@@ -0,0 +1,351 @@
+#include "RawCompression.h"
+
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <stdexcept>
+
+namespace RawCompression
+{
+  Compression compressionFromStr(const std::string& str)
+  {
+    for (const Compression compression : { Compression::NONE, Compression::LZ })
+    {
+      if (str == getCompressionName(compression))
+      {
+        return compression;
+      }
+    }
+    throw std::invalid_argument{ std::format("Unknown compression '{}'.", str) };
+  }
+
+  std::string_view getCompressionName(const Compression compression)
+  {
+    switch (compression)
+    {
+    case Compression::NONE:
+      return "none";
+    case Compression::LZ:
+      return "lz";
+
+    default:
+      return "unknown";
+    }
+  }
+
+  static constexpr char MAGIC[]{ 'S', 'H', 'C', 'Z' };
+  static constexpr uint32_t VERSION{ 1 };
+  static constexpr uint32_t STORED_FLAG{ 0x80000000u };
+
+  static constexpr int MIN_MATCH{ 4 };
+  static constexpr int MAX_OFFSET{ 65535 };
+  static constexpr int HASH_BITS{ 14 };
+
+  /* COMPRESSION */
+
+  static uint32_t read32(const uint8_t* data)
+  {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  static uint32_t hashAt(const uint8_t* data)
+  {
+    return (read32(data) * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+  static void writeLength(std::vector<uint8_t>& out, size_t length)
+  {
+    for (; length >= 255; length -= 255)
+    {
+      out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+  }
+
+  static void writeSequence(std::vector<uint8_t>& out, std::span<const uint8_t> literals, const int offset, const size_t matchLength)
+  {
+    const size_t matchCode{ matchLength > 0 ? matchLength - MIN_MATCH : 0 };
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(literals.size(), 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literals.size() >= 15)
+    {
+      writeLength(out, literals.size() - 15);
+    }
+    out.insert(out.end(), literals.begin(), literals.end());
+    if (matchLength == 0)
+    {
+      return;
+    }
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15)
+    {
+      writeLength(out, matchCode - 15);
+    }
+  }
+
+  // greedy matching with one candidate per hash, misses increase the step to move fast over data that does not compress
+  static std::vector<uint8_t> compressBlock(std::span<const uint8_t> data)
+  {
+    std::vector<uint8_t> out{};
+    out.reserve(data.size() / 2);
+    std::vector<int32_t> table(size_t{ 1 } << HASH_BITS, -1);
+
+    const int size{ static_cast<int>(data.size()) };
+    int literalStart{ 0 };
+    int position{ 0 };
+    int misses{ 0 };
+    while (position + MIN_MATCH <= size)
+    {
+      const uint32_t hash{ hashAt(data.data() + position) };
+      const int candidate{ table[hash] };
+      table[hash] = position;
+      if (candidate < 0 || position - candidate > MAX_OFFSET || read32(data.data() + candidate) != read32(data.data() + position))
+      {
+        position += 1 + (misses++ >> 5);
+        continue;
+      }
+      misses = 0;
+
+      int length{ MIN_MATCH };
+      while (position + length < size && data[candidate + length] == data[position + length])
+      {
+        ++length;
+      }
+      writeSequence(out, data.subspan(literalStart, position - literalStart), position - candidate, length);
+      position += length;
+      literalStart = position;
+    }
+    writeSequence(out, data.subspan(literalStart), 0, 0);
+    return out;
+  }
+
+  static void write32(std::ostream& out, const uint32_t value)
+  {
+    const uint8_t bytes[]{ static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24) };
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+  }
+
+  uint64_t writeCompressed(std::ostream& out, std::span<const uint8_t> data)
+  {
+    const size_t blockCount{ (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE };
+    std::vector<std::vector<uint8_t>> blocks(blockCount);
+    TaskPool::runParallel(blockCount, [&](const size_t index)
+      {
+        blocks[index] = compressBlock(data.subspan(index * BLOCK_SIZE, std::min<size_t>(BLOCK_SIZE, data.size() - index * BLOCK_SIZE)));
+      });
+
+    out.write(MAGIC, sizeof(MAGIC));
+    write32(out, VERSION);
+    write32(out, BLOCK_SIZE);
+    write32(out, static_cast<uint32_t>(data.size()));
+    write32(out, static_cast<uint32_t>(static_cast<uint64_t>(data.size()) >> 32));
+    write32(out, static_cast<uint32_t>(blockCount));
+    uint64_t writtenBytes{ sizeof(MAGIC) + 5 * sizeof(uint32_t) + blockCount * sizeof(uint32_t) };
+
+    // blocks that do not get smaller are stored as they are
+    for (size_t i{ 0 }; i < blockCount; ++i)
+    {
+      const size_t rawSize{ std::min<size_t>(BLOCK_SIZE, data.size() - i * BLOCK_SIZE) };
+      write32(out, blocks[i].size() < rawSize ? static_cast<uint32_t>(blocks[i].size()) : static_cast<uint32_t>(rawSize) | STORED_FLAG);
+    }
+    for (size_t i{ 0 }; i < blockCount; ++i)
+    {
+      const std::span<const uint8_t> raw{ data.subspan(i * BLOCK_SIZE, std::min<size_t>(BLOCK_SIZE, data.size() - i * BLOCK_SIZE)) };
+      const std::span<const uint8_t> block{ blocks[i].size() < raw.size() ? std::span<const uint8_t>{ blocks[i] } : raw };
+      out.write(reinterpret_cast<const char*>(block.data()), block.size());
+      writtenBytes += block.size();
+    }
+    return writtenBytes;
+  }
+
+  /* DECOMPRESSION */
+
+  static uint32_t read32(std::istream& in)
+  {
+    uint8_t bytes[4]{};
+    in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+  }
+
+  BlockTable readBlockTable(std::istream& in, const uint64_t expectedSize)
+  {
+    char magic[sizeof(MAGIC)]{};
+    in.read(magic, sizeof(magic));
+    if (!in || !std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)))
+    {
+      throw std::exception{ "Compressed raw data has no valid magic." };
+    }
+    if (read32(in) != VERSION)
+    {
+      throw std::exception{ "Compressed raw data has an unsupported version." };
+    }
+
+    BlockTable table{};
+    table.blockSize = read32(in);
+    table.uncompressedSize = read32(in);
+    table.uncompressedSize |= static_cast<uint64_t>(read32(in)) << 32;
+    const uint32_t blockCount{ read32(in) };
+    if (!in)
+    {
+      throw std::exception{ "Compressed raw data ends inside its header." };
+    }
+    // the block count follows from the size, so a corrupted header can not size the table
+    if (table.uncompressedSize != expectedSize)
+    {
+      throw std::exception{ "Compressed raw data does not have the expected size." };
+    }
+    // readers size their buffers with the block size of this version, so other sizes are rejected instead of trusted
+    if (table.blockSize != BLOCK_SIZE || blockCount != (table.uncompressedSize + table.blockSize - 1) / table.blockSize)
+    {
+      throw std::exception{ "Compressed raw data has an invalid block table." };
+    }
+    table.compressedSizes.resize(blockCount);
+    for (uint32_t& compressedSize : table.compressedSizes)
+    {
+      compressedSize = read32(in);
+      // the writer stores blocks that do not get smaller, so no block is bigger than the block size
+      if ((compressedSize & ~STORED_FLAG) > table.blockSize)
+      {
+        throw std::exception{ "Compressed raw data has an invalid block table." };
+      }
+    }
+    if (!in)
+    {
+      throw std::exception{ "Compressed raw data ends inside its block table." };
+    }
+    return table;
+  }
+
+  static size_t readLength(std::span<const uint8_t> block, size_t& position, size_t length)
+  {
+    if (length < 15)
+    {
+      return length;
+    }
+    uint8_t value;
+    do
+    {
+      if (position >= block.size())
+      {
+        throw std::exception{ "Compressed raw data block ends inside a length." };
+      }
+      value = block[position++];
+      length += value;
+    } while (value == 255);
+    return length;
+  }
+
+  void decompressBlock(std::span<const uint8_t> block, const uint32_t compressedSize, std::span<uint8_t> target)
+  {
+    if (compressedSize & STORED_FLAG)
+    {
+      if (block.size() != target.size())
+      {
+        throw std::exception{ "Stored raw data block does not match the block size." };
+      }
+      memcpy(target.data(), block.data(), block.size());
+      return;
+    }
+
+    size_t position{ 0 };
+    size_t written{ 0 };
+    while (position < block.size())
+    {
+      const uint8_t token{ block[position++] };
+      const size_t literalCount{ readLength(block, position, token >> 4) };
+      if (literalCount > block.size() - position || literalCount > target.size() - written)
+      {
+        throw std::exception{ "Compressed raw data block has literals beyond its end." };
+      }
+      memcpy(target.data() + written, block.data() + position, literalCount);
+      position += literalCount;
+      written += literalCount;
+      if (position == block.size())
+      {
+        break; // last sequence
+      }
+
+      if (block.size() - position < 2)
+      {
+        throw std::exception{ "Compressed raw data block ends inside an offset." };
+      }
+      const size_t offset{ static_cast<size_t>(block[position] | (block[position + 1] << 8)) };
+      position += 2;
+      const size_t matchLength{ readLength(block, position, token & 0x0f) + MIN_MATCH };
+      if (offset == 0 || offset > written || matchLength > target.size() - written)
+      {
+        throw std::exception{ "Compressed raw data block has an invalid match." };
+      }
+
+      uint8_t* destination{ target.data() + written };
+      const uint8_t* source{ destination - offset };
+      if (offset == 1)
+      {
+        memset(destination, *source, matchLength);
+      }
+      else if (offset >= matchLength)
+      {
+        memcpy(destination, source, matchLength);
+      }
+      else
+      {
+        for (size_t i{ 0 }; i < matchLength; ++i)
+        {
+          destination[i] = source[i];
+        }
+      }
+      written += matchLength;
+    }
+    if (written != target.size())
+    {
+      throw std::exception{ "Compressed raw data block does not fill the block size." };
+    }
+  }
+
+  void readCompressedBlocks(std::istream& in, const uint64_t expectedSize, const std::function<bool(std::span<const uint8_t>)>& blockConsumer)
+  {
+    const BlockTable table{ readBlockTable(in, expectedSize) };
+
+    // the blocks of a window are read, decompressed in parallel and passed in order, before the next window is read
+    const size_t blockCount{ table.compressedSizes.size() };
+    const size_t windowBlockCount{ std::min<size_t>(TaskPool::getParallelThreadCount(), blockCount) };
+    std::vector<std::vector<uint8_t>> compressed(windowBlockCount);
+    std::vector<uint8_t> blocks(windowBlockCount * std::min<uint64_t>(table.blockSize, table.uncompressedSize));
+    const auto getTarget{ [&](const size_t blockIndex)
+      {
+        return std::span{ blocks }.subspan((blockIndex % windowBlockCount) * table.blockSize,
+          std::min<uint64_t>(table.blockSize, table.uncompressedSize - blockIndex * table.blockSize));
+      }
+    };
+    for (size_t windowStart{ 0 }; windowStart < blockCount; windowStart += windowBlockCount)
+    {
+      const size_t windowEnd{ std::min(windowStart + windowBlockCount, blockCount) };
+      for (size_t i{ windowStart }; i < windowEnd; ++i)
+      {
+        std::vector<uint8_t>& block{ compressed[i - windowStart] };
+        block.resize(table.compressedSizes[i] & ~STORED_FLAG);
+        in.read(reinterpret_cast<char*>(block.data()), block.size());
+        if (!in)
+        {
+          throw std::exception{ "Compressed raw data ends before its last block." };
+        }
+      }
+      TaskPool::runParallel(windowEnd - windowStart, [&](const size_t index)
+        {
+          decompressBlock(compressed[index], table.compressedSizes[windowStart + index], getTarget(windowStart + index));
+        });
+      for (size_t i{ windowStart }; i < windowEnd; ++i)
+      {
+        if (!blockConsumer(getTarget(i)))
+        {
+          return;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdint.h>
+
+/*
+  Optional compression of the raw data files, without any external library.
+  The data is split into blocks, that are compressed independently with a fast LZ77 variant, so both directions
+  run in parallel and a reader can decompress any block on its own.
+
+  FILE LAYOUT (little endian):
+  - magic "SHCZ", uint32 version, uint32 block size, uint64 uncompressed size, uint32 block count
+  - uint32 per block with the compressed size, the highest bit marks a block that is stored uncompressed
+  - the blocks in order
+
+  BLOCK FORMAT:
+  Sequences of a token byte, literals and a match. The high nibble of the token is the literal count and the low nibble
+  the match length minus 4, the value 15 is continued by bytes that are added until one is below 255.
+  The literals follow the literal count, the match uses a 2 byte offset and follows the literals.
+  The last sequence of a block only has literals.
+*/
+
+namespace RawCompression
+{
+  enum class Compression : int
+  {
+    NONE,
+    LZ,
+  };
+
+  // accepts "none" and "lz", throws std::invalid_argument otherwise
+  Compression compressionFromStr(const std::string& str);
+  std::string_view getCompressionName(Compression compression);
+
+  inline constexpr uint32_t BLOCK_SIZE{ 256 * 1024 };
+
+  struct BlockTable
+  {
+    uint32_t blockSize;
+    uint64_t uncompressedSize;
+    std::vector<uint32_t> compressedSizes; // including the stored flag
+  };
+
+  // compresses the data in parallel and writes it to the stream, returns the number of written bytes
+  uint64_t writeCompressed(std::ostream& out, std::span<const uint8_t> data);
+
+  // reads the header and the block table, throws if they are malformed, do not use BLOCK_SIZE
+  // or do not have the expected uncompressed size, which is checked before the table is allocated
+  BlockTable readBlockTable(std::istream& in, uint64_t expectedSize);
+
+  // decompresses one block, compressedSize may include the stored flag
+  // throws if the block is malformed or does not fill the target exactly
+  void decompressBlock(std::span<const uint8_t> block, uint32_t compressedSize, std::span<uint8_t> target);
+
+  // reads a compressed stream and passes the decompressed blocks in order to the consumer, which returns false to stop
+  // a window of one block per parallel thread is decompressed at once, so the memory stays bounded by the window
+  // throws if the uncompressed size does not match the expected size
+  void readCompressedBlocks(std::istream& in, uint64_t expectedSize, const std::function<bool(std::span<const uint8_t>)>& blockConsumer);
+}
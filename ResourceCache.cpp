@@ -0,0 +1,85 @@
+#include "ResourceCache.h"
+
+#include "Console.h"
+#include "TGXFile.h"
+#include "GM1File.h"
+
+#include <algorithm>
+
+namespace ResourceCache
+{
+  Cache::Cache(const uint64_t maxBytes) : mutex{}, entries{}, cachedBytes{ 0 }, useCounter{ 0 }, maxBytes{ maxBytes }
+  {
+  }
+
+  template<typename Resource, typename Loader>
+  std::shared_ptr<const Resource> Cache::load(const std::filesystem::path& file, const Loader& loader)
+  {
+    const std::string key{ std::filesystem::absolute(file).lexically_normal().string() };
+    std::error_code errorCode{};
+    const std::filesystem::file_time_type lastWriteTime{ std::filesystem::last_write_time(file, errorCode) };
+    const uintmax_t fileSize{ errorCode ? 0 : std::filesystem::file_size(file, errorCode) };
+    if (errorCode)
+    {
+      return loader(file); // reports the missing file like without a cache
+    }
+    {
+      const std::lock_guard lock{ mutex };
+      const auto it{ entries.find(key) };
+      if (it != entries.end() && it->second.lastWriteTime == lastWriteTime && it->second.fileSize == fileSize)
+      {
+        if (const auto* resource{ std::get_if<std::shared_ptr<const Resource>>(&it->second.resource) })
+        {
+          it->second.lastUse = ++useCounter;
+          Log(LogLevel::DEBUG, "Using cached resource of '{}'.", file.string());
+          return *resource;
+        }
+      }
+    }
+
+    // loaded without the lock, so requests for other files do not wait, concurrent requests for one file might both load it
+    // a file changed after its write time was read is stored with the old time, so the next request loads it again
+    std::shared_ptr<const Resource> resource{ loader(file) };
+    if (!resource)
+    {
+      return resource;
+    }
+    const uint64_t bytes{ sizeof(Resource) + resource->base.resourceSize };
+    if (bytes > maxBytes)
+    {
+      return resource;
+    }
+
+    const std::lock_guard lock{ mutex };
+    if (const auto it{ entries.find(key) }; it != entries.end())
+    {
+      cachedBytes -= it->second.bytes;
+      entries.erase(it);
+    }
+    while (cachedBytes + bytes > maxBytes)
+    {
+      const auto leastRecentlyUsed{ std::ranges::min_element(entries, {}, [](const auto& keyEntry) { return keyEntry.second.lastUse; }) };
+      cachedBytes -= leastRecentlyUsed->second.bytes;
+      entries.erase(leastRecentlyUsed);
+    }
+    entries.emplace(key, Entry{
+      .lastWriteTime{ lastWriteTime },
+      .fileSize{ fileSize },
+      .resource{ resource },
+      .bytes{ bytes },
+      .lastUse{ ++useCounter }
+    });
+    cachedBytes += bytes;
+    return resource;
+  }
+
+  std::shared_ptr<const TgxResource> Cache::loadTgx(const std::filesystem::path& file)
+  {
+    return load<TgxResource>(file, [](const std::filesystem::path& path) { return TGXFile::loadTgxResource(path); });
+  }
+
+  std::shared_ptr<const Gm1Resource> Cache::loadGm1(const std::filesystem::path& file)
+  {
+    return load<Gm1Resource>(file, [](const std::filesystem::path& path) { return GM1File::loadGm1Resource(path); });
+  }
+}
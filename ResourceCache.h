@@ -0,0 +1,54 @@
+#pragma once
+
+#include "SHCResourceConverter.h"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include <stdint.h>
+
+/*
+  In-memory cache of loaded TGX and GM1 files, so a long running process like the server keeps resources warm across requests.
+  Entries are keyed by the absolute path and only used while the last write time and the size of the file are unchanged.
+  The summed size of the cached resources is bounded, the least recently used entries are dropped first.
+  Resources are shared read only, so a dropped entry stays valid for the requests still using it.
+*/
+
+namespace ResourceCache
+{
+  inline constexpr uint64_t DEFAULT_MAX_MEGABYTES{ 256 };
+
+  class Cache
+  {
+  private:
+    using CachedResource = std::variant<std::shared_ptr<const TgxResource>, std::shared_ptr<const Gm1Resource>>;
+
+    struct Entry
+    {
+      std::filesystem::file_time_type lastWriteTime;
+      uintmax_t fileSize;
+      CachedResource resource;
+      uint64_t bytes;
+      uint64_t lastUse;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries; // guarded by mutex
+    uint64_t cachedBytes; // guarded by mutex
+    uint64_t useCounter; // guarded by mutex
+    uint64_t maxBytes;
+
+    template<typename Resource, typename Loader>
+    std::shared_ptr<const Resource> load(const std::filesystem::path& file, const Loader& loader);
+  public:
+    explicit Cache(uint64_t maxBytes);
+
+    // return nullptr if the file could not be loaded, exceptions of the load functions are passed on
+    std::shared_ptr<const TgxResource> loadTgx(const std::filesystem::path& file);
+    std::shared_ptr<const Gm1Resource> loadGm1(const std::filesystem::path& file);
+  };
+}
@@ -4,6 +4,8 @@
 #include "Console.h"
 
 #include <iostream>
+#include <charconv>
+#include <array>
 
 namespace ResourceMetaFormat
 {
@@ -100,15 +102,9 @@ namespace ResourceMetaFormat
       trimLeadingAndTrailingWhitespaceInPlace(versionString);
 
       int version{ 0 };
-      try
+      if (tryIntFromStr(versionString, version) != std::errc{})
       {
-        version = intFromStr(versionString);
-      }
-      catch (const std::exception& ex)
-      {
-        std::string exMessage{ "Unable to extract version from identifier line: " };
-        exMessage.append(ex.what());
-        throw std::ios::failure(exMessage);
+        throw std::ios::failure("Unable to extract version from identifier line.");
       }
 
       // extract keys and values 
@@ -163,7 +159,39 @@ namespace ResourceMetaFormat
   {
   }
 
-  bool ResourceMetaFileReader::consumeTillObject(std::istream& stream)
+  ResourceMetaFileReader::~ResourceMetaFileReader() {}
+
+  const ResourceMetaObjectReader& ResourceMetaFileReader::getHeader() const
+  {
+    return header;
+  }
+
+  const std::vector<ResourceMetaObjectReader>& ResourceMetaFileReader::getObjects() const
+  {
+    return objects;
+  }
+
+  ResourceMetaFileReader ResourceMetaFileReader::parseFrom(std::istream& stream)
+  {
+    ResourceMetaFileStreamReader streamReader{ ResourceMetaFileStreamReader::startFrom(stream) };
+
+    std::vector<ResourceMetaObjectReader> objects{};
+    while (std::optional<ResourceMetaObjectReader> object{ streamReader.next() })
+    {
+      objects.emplace_back(std::move(*object));
+    }
+    return ResourceMetaFileReader{ std::move(streamReader.header), std::move(objects) };
+  }
+
+
+  /* ResourceMetaFileStreamReader */
+
+  ResourceMetaFileStreamReader::ResourceMetaFileStreamReader(std::istream& stream, ResourceMetaObjectReader&& header)
+    : internalStream{ stream }, header(std::move(header)), finished{ false }
+  {
+  }
+
+  bool ResourceMetaFileStreamReader::consumeTillObject(std::istream& stream)
   {
     while (!stream.eof())
     {
@@ -181,25 +209,72 @@ namespace ResourceMetaFormat
     return false;
   }
 
-  ResourceMetaFileReader::~ResourceMetaFileReader() {}
+  ResourceMetaFileStreamReader::~ResourceMetaFileStreamReader() {}
 
-  const ResourceMetaObjectReader& ResourceMetaFileReader::getHeader() const
+  const ResourceMetaObjectReader& ResourceMetaFileStreamReader::getHeader() const
   {
     return header;
   }
 
-  const std::vector<ResourceMetaObjectReader>& ResourceMetaFileReader::getObjects() const
+  bool ResourceMetaFileStreamReader::isFinished() const
   {
-    return objects;
+    return finished;
   }
 
-  ResourceMetaFileReader ResourceMetaFileReader::parseFrom(std::istream& stream)
+  std::optional<ResourceMetaObjectReader> ResourceMetaFileStreamReader::next()
+  {
+    if (finished)
+    {
+      return std::nullopt;
+    }
+
+    const std::ios::iostate oldExceptions = internalStream.exceptions();
+    internalStream.exceptions(std::ios::failbit | std::ios::badbit);
+    try
+    {
+      if (!ResourceMetaFileStreamReader::consumeTillObject(internalStream))
+      {
+        finished = true;
+        internalStream.exceptions(oldExceptions);
+        return std::nullopt;
+      }
+      std::optional<ResourceMetaObjectReader> object{ ResourceMetaObjectReader::parseFrom(internalStream, header.getVersion()) };
+      internalStream.exceptions(oldExceptions);
+      return object;
+    }
+    catch (...)
+    {
+      finished = true; // stream is in an unknown state
+      internalStream.exceptions(oldExceptions);
+      throw;
+    }
+  }
+
+  bool ResourceMetaFileStreamReader::skipMalformedObject()
+  {
+    if (internalStream.fail())
+    {
+      return false;
+    }
+
+    const std::ios::iostate oldExceptions = internalStream.exceptions();
+    internalStream.exceptions(std::ios::goodbit);
+    while (!internalStream.eof() && !ResourceMetaObjectReader::extractMeaningfulLine(internalStream).empty())
+    {
+      // the object ends with the next empty line
+    }
+    internalStream.exceptions(oldExceptions);
+    finished = internalStream.fail();
+    return !finished;
+  }
+
+  ResourceMetaFileStreamReader ResourceMetaFileStreamReader::startFrom(std::istream& stream)
   {
     const std::ios::iostate oldExceptions = stream.exceptions();
     stream.exceptions(std::ios::failbit | std::ios::badbit);
     try
     {
-      if (!ResourceMetaFileReader::consumeTillObject(stream))
+      if (!ResourceMetaFileStreamReader::consumeTillObject(stream))
       {
         throw std::ios::failure("File is empty.");
       }
@@ -210,14 +285,8 @@ namespace ResourceMetaFormat
       }
       // format version is ignored for now
 
-      std::vector<ResourceMetaObjectReader> objects{};
-      while (ResourceMetaFileReader::consumeTillObject(stream))
-      {
-        objects.emplace_back(ResourceMetaObjectReader::parseFrom(stream, header.getVersion()));
-      }
-
       stream.exceptions(oldExceptions); // reset stream exception
-      return ResourceMetaFileReader{ std::move(header), std::move(objects) };
+      return ResourceMetaFileStreamReader{ stream, std::move(header) };
     }
     catch (...)
     {
@@ -260,39 +329,63 @@ namespace ResourceMetaFormat
     parent.validateStreamState();
 
     active = true;
-    parent.internalStream << identifier << MARKER::SPACE_CHARACTER << version;
+    parent.outputBuffer.append(identifier);
+    parent.outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+    parent.internalWriteSigned(version, INTEGER_FORMAT::DECIMAL);
     parent.internalWriteComment(comment, true);
-    parent.internalStream << MARKER::NEWLINE_CHARACTER;
+    parent.outputBuffer.push_back(MARKER::NEWLINE_CHARACTER);
+    parent.flushIfThresholdReached();
     return *this;
   }
 
-  ResourceMetaFileWriter::ResourceMetaObjectWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::writeListEntry(
-    std::string_view entry, std::string_view comment)
+  void ResourceMetaFileWriter::ResourceMetaObjectWriter::startListEntry()
   {
     parent.validateFileActive();
     parent.validateObjectActive();
     parent.validateStreamState();
 
-    parent.internalStream << MARKER::LIST_ITEM_CHARACTER << MARKER::SPACE_CHARACTER << entry;
-    parent.internalWriteComment(comment, true);
-    parent.internalStream << MARKER::NEWLINE_CHARACTER;
-    return *this;
+    parent.outputBuffer.push_back(MARKER::LIST_ITEM_CHARACTER);
+    parent.outputBuffer.push_back(MARKER::SPACE_CHARACTER);
   }
 
-  ResourceMetaFileWriter::ResourceMetaObjectWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::writeMapEntry(
-    std::string_view key, std::string_view value, std::string_view comment)
+  void ResourceMetaFileWriter::ResourceMetaObjectWriter::startMapEntry(std::string_view key)
   {
     parent.validateFileActive();
     parent.validateObjectActive();
     parent.validateStreamState();
 
-    parent.internalStream << MARKER::MAP_ITEM_CHARACTER << MARKER::SPACE_CHARACTER << key
-      << MARKER::SPACE_CHARACTER << MARKER::MAP_SEPARATOR_CHARACTER << MARKER::SPACE_CHARACTER << value;
+    parent.outputBuffer.push_back(MARKER::MAP_ITEM_CHARACTER);
+    parent.outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+    parent.outputBuffer.append(key);
+    parent.outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+    parent.outputBuffer.push_back(MARKER::MAP_SEPARATOR_CHARACTER);
+    parent.outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+  }
+
+  ResourceMetaFileWriter::ResourceMetaObjectWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::endEntry(std::string_view comment)
+  {
     parent.internalWriteComment(comment, true);
-    parent.internalStream << MARKER::NEWLINE_CHARACTER;
+    parent.outputBuffer.push_back(MARKER::NEWLINE_CHARACTER);
+    parent.flushIfThresholdReached();
     return *this;
   }
 
+  ResourceMetaFileWriter::ResourceMetaObjectWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::writeListEntry(
+    std::string_view entry, std::string_view comment)
+  {
+    startListEntry();
+    parent.outputBuffer.append(entry);
+    return endEntry(comment);
+  }
+
+  ResourceMetaFileWriter::ResourceMetaObjectWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::writeMapEntry(
+    std::string_view key, std::string_view value, std::string_view comment)
+  {
+    startMapEntry(key);
+    parent.outputBuffer.append(value);
+    return endEntry(comment);
+  }
+
   ResourceMetaFileWriter& ResourceMetaFileWriter::ResourceMetaObjectWriter::endObject(std::string_view comment)
   {
     parent.validateFileActive();
@@ -300,7 +393,8 @@ namespace ResourceMetaFormat
     parent.validateStreamState();
 
     parent.internalWriteComment(comment, false);
-    parent.internalStream << MARKER::NEWLINE_CHARACTER;
+    parent.outputBuffer.push_back(MARKER::NEWLINE_CHARACTER);
+    parent.flushIfThresholdReached();
     active = false;
     return parent;
   }
@@ -309,8 +403,9 @@ namespace ResourceMetaFormat
   /* ResourceMetaFileWriter */
 
   ResourceMetaFileWriter::ResourceMetaFileWriter(std::ostream& stream, int formatVersion)
-    : formatVersion{ formatVersion }, internalStream{ stream }, active{ true }, headerPlaced{ false }, writerObject{ *this }
+    : formatVersion{ formatVersion }, internalStream{ stream }, outputBuffer{}, active{ true }, headerPlaced{ false }, writerObject{ *this }
   {
+    outputBuffer.reserve(WRITER::FLUSH_THRESHOLD);
   }
 
   void ResourceMetaFileWriter::validateObjectActive() const
@@ -357,9 +452,74 @@ namespace ResourceMetaFormat
     }
     if (prefixSpace)
     {
-      internalStream << MARKER::SPACE_CHARACTER;
+      outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+    }
+    outputBuffer.push_back(MARKER::COMMENT_CHARACTER);
+    outputBuffer.push_back(MARKER::SPACE_CHARACTER);
+    outputBuffer.append(comment);
+  }
+
+  // sign, prefix, zero padding, digits
+  static void appendFormattedInteger(std::string& out, bool negative, std::string_view digits, const IntegerFormat& format)
+  {
+    if (negative)
+    {
+      out.push_back('-');
     }
-    internalStream << MARKER::COMMENT_CHARACTER << MARKER::SPACE_CHARACTER << comment;
+    out.append(format.prefix);
+    for (int i{ static_cast<int>(digits.size()) }; i < format.minDigits; ++i)
+    {
+      out.push_back('0');
+    }
+    out.append(digits);
+  }
+
+  void ResourceMetaFileWriter::internalWriteSigned(long long value, const IntegerFormat& format)
+  {
+    if (value >= 0)
+    {
+      internalWriteUnsigned(static_cast<unsigned long long>(value), format);
+      return;
+    }
+    // negate in unsigned space, so that the minimum value is handled
+    std::array<char, std::numeric_limits<unsigned long long>::digits> digits;
+    const unsigned long long magnitude{ 0ull - static_cast<unsigned long long>(value) };
+    const auto [end, errorCode] { std::to_chars(digits.data(), digits.data() + digits.size(), magnitude, format.base) };
+    if (errorCode != std::errc{})
+    {
+      throw std::ios::failure("Unable to format integer value.");
+    }
+    appendFormattedInteger(outputBuffer, true, std::string_view{ digits.data(), end }, format);
+  }
+
+  void ResourceMetaFileWriter::internalWriteUnsigned(unsigned long long value, const IntegerFormat& format)
+  {
+    std::array<char, std::numeric_limits<unsigned long long>::digits> digits;
+    const auto [end, errorCode] { std::to_chars(digits.data(), digits.data() + digits.size(), value, format.base) };
+    if (errorCode != std::errc{})
+    {
+      throw std::ios::failure("Unable to format integer value.");
+    }
+    appendFormattedInteger(outputBuffer, false, std::string_view{ digits.data(), end }, format);
+  }
+
+  void ResourceMetaFileWriter::flushIfThresholdReached()
+  {
+    if (outputBuffer.size() >= WRITER::FLUSH_THRESHOLD)
+    {
+      flushBuffer();
+    }
+  }
+
+  void ResourceMetaFileWriter::flushBuffer()
+  {
+    if (outputBuffer.empty())
+    {
+      return;
+    }
+    internalStream.write(outputBuffer.data(), outputBuffer.size());
+    outputBuffer.clear();
+    validateStreamState();
   }
 
   ResourceMetaFileWriter::~ResourceMetaFileWriter()
@@ -421,15 +581,16 @@ namespace ResourceMetaFormat
     validateStreamState();
 
     internalWriteComment(comment, false);
-    internalStream << MARKER::NEWLINE_CHARACTER;
+    outputBuffer.push_back(MARKER::NEWLINE_CHARACTER);
+    flushIfThresholdReached();
     return *this;
   }
 
   void ResourceMetaFileWriter::endFile()
   {
     validateFileActive();
-    // does not need to validate stream, since inactive
-    active = false; // nothing special to do here, only complete the file
+    active = false; // only the remaining buffer needs to be handed to the stream
+    flushBuffer();
   }
 
   ResourceMetaFileWriter ResourceMetaFileWriter::startFile(std::ostream& stream, int formatVersion)
@@ -47,6 +47,8 @@
 #include <string_view>
 #include <vector>
 #include <map>
+#include <optional>
+#include <concepts>
 
 namespace ResourceMetaFormat
 {
@@ -81,6 +83,28 @@ namespace ResourceMetaFormat
     inline constexpr std::string_view EMPTY_STRING_VIEW;
   }
 
+  // describes how integer values are written by the writer, prefix is placed after a potential sign
+  struct IntegerFormat
+  {
+    int base;
+    int minDigits;
+    std::string_view prefix;
+  };
+
+  namespace INTEGER_FORMAT
+  {
+    inline constexpr IntegerFormat DECIMAL{ 10, 1, HELPER::EMPTY_STRING_VIEW };
+    inline constexpr IntegerFormat HEX_WORD{ 16, 4, "0x" }; // same as "{:#06x}"
+    inline constexpr IntegerFormat HEX_QWORD{ 16, 16, "0x" }; // same as "{:#018x}"
+    inline constexpr IntegerFormat BINARY_BYTE{ 2, 8, HELPER::EMPTY_STRING_VIEW }; // same as "{:08b}"
+  }
+
+  namespace WRITER
+  {
+    // the writer collects the text and only hands it to the stream once this size is reached or the file ends
+    inline constexpr size_t FLUSH_THRESHOLD{ 64 * 1024 };
+  }
+
   class ResourceMetaObjectReader
   {
   private:
@@ -108,6 +132,8 @@ namespace ResourceMetaFormat
 
     ResourceMetaObjectReader(const ResourceMetaObjectReader&) = delete;
     ResourceMetaObjectReader& operator=(const ResourceMetaObjectReader&) = delete;
+
+    friend class ResourceMetaFileStreamReader;
   };
 
   class ResourceMetaFileReader
@@ -117,9 +143,6 @@ namespace ResourceMetaFormat
     std::vector<ResourceMetaObjectReader> objects;
 
     explicit ResourceMetaFileReader(ResourceMetaObjectReader&& header, std::vector<ResourceMetaObjectReader>&& objects);
-
-    // returns true if a new object was found
-    static bool consumeTillObject(std::istream& stream);
   public:
     ~ResourceMetaFileReader();
 
@@ -135,6 +158,43 @@ namespace ResourceMetaFormat
     ResourceMetaFileReader& operator=(const ResourceMetaFileReader&) = delete;
   };
 
+  // pull based reader, that only parses the next object when it is requested
+  // allows to process objects while the file is still read, without keeping all of them in memory
+  class ResourceMetaFileStreamReader
+  {
+  private:
+    std::istream& internalStream;
+    ResourceMetaObjectReader header;
+    bool finished;
+
+    explicit ResourceMetaFileStreamReader(std::istream& stream, ResourceMetaObjectReader&& header);
+
+    // returns true if a new object was found
+    static bool consumeTillObject(std::istream& stream);
+  public:
+    ~ResourceMetaFileStreamReader();
+
+    const ResourceMetaObjectReader& getHeader() const;
+    bool isFinished() const;
+
+    // returns the next object or an empty optional if the stream contains no further objects
+    std::optional<ResourceMetaObjectReader> next();
+
+    // only valid after next threw, skips the remaining lines of the malformed object so that next can continue
+    // returns false if the stream itself failed and no further object can be read
+    bool skipMalformedObject();
+
+    // parses the header, the stream reference will be kept until the end of the reading
+    static ResourceMetaFileStreamReader startFrom(std::istream& stream);
+
+    ResourceMetaFileStreamReader(ResourceMetaFileStreamReader&& resourceMetaFile) = default;
+
+    ResourceMetaFileStreamReader(const ResourceMetaFileStreamReader&) = delete;
+    ResourceMetaFileStreamReader& operator=(const ResourceMetaFileStreamReader&) = delete;
+
+    friend class ResourceMetaFileReader;
+  };
+
   class ResourceMetaFileWriter
   {
   private:
@@ -146,6 +206,11 @@ namespace ResourceMetaFormat
 
       ResourceMetaObjectWriter& startObject(std::string_view identifier, int version, std::string_view comment = HELPER::EMPTY_STRING_VIEW);
 
+      // entries are written as start, value and end, to allow different value types
+      void startListEntry();
+      void startMapEntry(std::string_view key);
+      ResourceMetaObjectWriter& endEntry(std::string_view comment);
+
       explicit ResourceMetaObjectWriter(ResourceMetaFileWriter& parent);
     public:
       ~ResourceMetaObjectWriter();
@@ -157,6 +222,36 @@ namespace ResourceMetaFormat
       ResourceMetaObjectWriter& writeListEntry(std::string_view entry, std::string_view comment = HELPER::EMPTY_STRING_VIEW);
       ResourceMetaObjectWriter& writeMapEntry(std::string_view key, std::string_view value, std::string_view comment = HELPER::EMPTY_STRING_VIEW);
       ResourceMetaFileWriter& endObject(std::string_view comment = HELPER::EMPTY_STRING_VIEW);
+
+      // integer versions, the values are formatted directly into the output buffer
+
+      template<std::integral Int> requires (!std::same_as<Int, bool>)
+      ResourceMetaObjectWriter& writeListEntry(Int entry, std::string_view comment = HELPER::EMPTY_STRING_VIEW)
+      {
+        return writeListEntry(entry, INTEGER_FORMAT::DECIMAL, comment);
+      }
+
+      template<std::integral Int> requires (!std::same_as<Int, bool>)
+      ResourceMetaObjectWriter& writeListEntry(Int entry, const IntegerFormat& format, std::string_view comment = HELPER::EMPTY_STRING_VIEW)
+      {
+        startListEntry();
+        parent.internalWriteInteger(entry, format);
+        return endEntry(comment);
+      }
+
+      template<std::integral Int> requires (!std::same_as<Int, bool>)
+      ResourceMetaObjectWriter& writeMapEntry(std::string_view key, Int value, std::string_view comment = HELPER::EMPTY_STRING_VIEW)
+      {
+        return writeMapEntry(key, value, INTEGER_FORMAT::DECIMAL, comment);
+      }
+
+      template<std::integral Int> requires (!std::same_as<Int, bool>)
+      ResourceMetaObjectWriter& writeMapEntry(std::string_view key, Int value, const IntegerFormat& format, std::string_view comment = HELPER::EMPTY_STRING_VIEW)
+      {
+        startMapEntry(key);
+        parent.internalWriteInteger(value, format);
+        return endEntry(comment);
+      }
     
       ResourceMetaObjectWriter(const ResourceMetaObjectWriter&) = delete;
       ResourceMetaObjectWriter& operator=(const ResourceMetaObjectWriter&) = delete;
@@ -166,6 +261,7 @@ namespace ResourceMetaFormat
 
     const int formatVersion;
     std::ostream& internalStream;
+    std::string outputBuffer;
     bool active;
     bool headerPlaced;
     ResourceMetaObjectWriter writerObject;
@@ -178,6 +274,26 @@ namespace ResourceMetaFormat
     // does not add a new line
     void internalWriteComment(std::string_view comment, bool prefixSpace);
 
+    void internalWriteSigned(long long value, const IntegerFormat& format);
+    void internalWriteUnsigned(unsigned long long value, const IntegerFormat& format);
+
+    template<std::integral Int>
+    void internalWriteInteger(Int value, const IntegerFormat& format)
+    {
+      if constexpr (std::is_signed_v<Int>)
+      {
+        internalWriteSigned(value, format);
+      }
+      else
+      {
+        internalWriteUnsigned(value, format);
+      }
+    }
+
+    // hands the buffer to the stream if the threshold is reached
+    void flushIfThresholdReached();
+    void flushBuffer();
+
     explicit ResourceMetaFileWriter(std::ostream& stream, int formatVersion);
   public:
     ~ResourceMetaFileWriter();
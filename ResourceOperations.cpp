@@ -0,0 +1,291 @@
+#include "ResourceOperations.h"
+
+#include "Console.h"
+#include "ResourceMetaFormat.h"
+#include "RoundTrip.h"
+#include "Timings.h"
+
+#include "TGXFile.h"
+#include "GM1File.h"
+
+#include <fstream>
+
+namespace ResourceOperations
+{
+  PathNameType determinePathNameType(const std::filesystem::path& path)
+  {
+    const std::string extension{ path.extension().string() };
+    if (extension == TGXFile::FILE_EXTENSION)
+    {
+      return PathNameType::TGX_FILE;
+    }
+    if (extension == GM1File::FILE_EXTENSION)
+    {
+      return PathNameType::GM1_FILE;
+    }
+    else if (extension == "")
+    {
+      return PathNameType::FOLDER;
+    }
+    else
+    {
+      return PathNameType::UNKNOWN;
+    }
+  }
+
+  PathNameType determineRawResourceType(const std::filesystem::path& folder)
+  {
+    std::filesystem::path file{ folder / folder.filename() };
+    file.replace_extension(ResourceMetaFormat::FILE::EXTENSION);
+    if (!std::filesystem::is_regular_file(file))
+    {
+      return PathNameType::UNKNOWN;
+    }
+
+    try
+    {
+      std::ifstream in;
+      in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+      in.open(file, std::ios::in); // text handling
+
+      auto reader{ ResourceMetaFormat::ResourceMetaFileStreamReader::startFrom(in) };
+      const std::optional<ResourceMetaFormat::ResourceMetaObjectReader> resourceObject{ reader.next() };
+      if (!resourceObject)
+      {
+        return PathNameType::UNKNOWN;
+      }
+      if (resourceObject->getIdentifier() == TGXFile::TgxResourceMeta::RESOURCE_IDENTIFIER)
+      {
+        return PathNameType::TGX_FILE;
+      }
+      if (resourceObject->getIdentifier() == GM1File::Gm1ResourceMeta::RESOURCE_IDENTIFIER)
+      {
+        return PathNameType::GM1_FILE;
+      }
+    }
+    catch (const std::exception& e)
+    {
+      Log(LogLevel::WARNING, "Unable to read resource meta file '{}': {}", file.string(), e.what());
+    }
+    return PathNameType::UNKNOWN;
+  }
+
+  static std::shared_ptr<const TgxResource> loadTgxFile(const std::filesystem::path& source, ResourceCache::Cache* resourceCache)
+  {
+    if (resourceCache)
+    {
+      return resourceCache->loadTgx(source);
+    }
+    return TGXFile::loadTgxResource(source);
+  }
+
+  static std::shared_ptr<const Gm1Resource> loadGm1File(const std::filesystem::path& source, ResourceCache::Cache* resourceCache)
+  {
+    if (resourceCache)
+    {
+      return resourceCache->loadGm1(source);
+    }
+    return GM1File::loadGm1Resource(source);
+  }
+
+  bool testResource(const std::filesystem::path& source, const TgxCoderInstruction& instructions, TgxTextMode tgxTextMode,
+    TgxDetailedAnalysis* detailedAnalysis, ResourceCache::Cache* resourceCache)
+  {
+    const Timings::FileScope timingScope{ source };
+    switch (determinePathNameType(source))
+    {
+    case PathNameType::TGX_FILE:
+    {
+      Log(LogLevel::INFO, "Try testing provided TGX file path.");
+      const std::shared_ptr<const TgxResource> tgxResource{ loadTgxFile(source, resourceCache) };
+      if (!tgxResource)
+      {
+        return false;
+      }
+      return TGXFile::validateTgxResource(*tgxResource, tgxTextMode, detailedAnalysis);
+    }
+    case PathNameType::GM1_FILE:
+    {
+      Log(LogLevel::INFO, "Try testing provided GM1 file path.");
+      const std::shared_ptr<const Gm1Resource> gm1Resource{ loadGm1File(source, resourceCache) };
+      if (!gm1Resource)
+      {
+        return false;
+      }
+      return GM1File::validateGm1Resource(*gm1Resource, instructions, tgxTextMode, detailedAnalysis);
+    }
+    default:
+      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
+      return false;
+    }
+  }
+
+  static bool reportRoundTripDifference(const std::optional<RoundTrip::RoundTripDifference>& difference)
+  {
+    if (difference)
+    {
+      Out("### First difference ###\n{}\n\n### Round trip changed the data ###\n", *difference);
+      Log(LogLevel::ERROR, "Round trip completed. Encoded data differs.");
+      return false;
+    }
+    Out("### Round trip reproduced the data ###\n");
+    Log(LogLevel::INFO, "Round trip completed successfully.");
+    return true;
+  }
+
+  bool roundTripResource(const std::filesystem::path& source, const TgxCoderInstruction& instructions, ResourceCache::Cache* resourceCache)
+  {
+    const Timings::FileScope timingScope{ source };
+    switch (determinePathNameType(source))
+    {
+    case PathNameType::TGX_FILE:
+    {
+      Log(LogLevel::INFO, "Try round trip of provided TGX file.");
+      const std::shared_ptr<const TgxResource> tgxResource{ loadTgxFile(source, resourceCache) };
+      if (!tgxResource)
+      {
+        return false;
+      }
+      return reportRoundTripDifference(RoundTrip::roundTripTgxResource(*tgxResource, instructions));
+    }
+    case PathNameType::GM1_FILE:
+    {
+      Log(LogLevel::INFO, "Try round trip of provided GM1 file.");
+      const std::shared_ptr<const Gm1Resource> gm1Resource{ loadGm1File(source, resourceCache) };
+      if (!gm1Resource)
+      {
+        return false;
+      }
+      return reportRoundTripDifference(RoundTrip::roundTripGm1Resource(*gm1Resource, instructions));
+    }
+    default:
+      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
+      return false;
+    }
+  }
+
+  static bool internalExtractResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions, ResourceCache::Cache* resourceCache)
+  {
+    if (determinePathNameType(target) != PathNameType::FOLDER)
+    {
+      Log(LogLevel::ERROR, "Provided folder has an extension, which is not supported.");
+      return false;
+    }
+
+    switch (determinePathNameType(source))
+    {
+    case PathNameType::TGX_FILE:
+    {
+      Log(LogLevel::INFO, "Try extracting provided TGX file.");
+      const std::shared_ptr<const TgxResource> tgxResource{ loadTgxFile(source, resourceCache) };
+      if (!tgxResource)
+      {
+        return false;
+      }
+      TGXFile::saveTgxResourceAsRaw(target, *tgxResource, instructions, extractOptions);
+      return true;
+    }
+    case PathNameType::GM1_FILE:
+    {
+      Log(LogLevel::INFO, "Try extracting provided GM1 file.");
+      const std::shared_ptr<const Gm1Resource> gm1Resource{ loadGm1File(source, resourceCache) };
+      if (!gm1Resource)
+      {
+        return false;
+      }
+      GM1File::saveGm1ResourceAsRaw(target, *gm1Resource, instructions, extractOptions);
+      return true;
+    }
+    default:
+      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
+      return false;
+    }
+  }
+
+  static bool internalPackResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions)
+  {
+    if (determinePathNameType(source) != PathNameType::FOLDER)
+    {
+      Log(LogLevel::ERROR, "Provided folder has an extension, which is not supported.");
+      return false;
+    }
+
+    switch (determinePathNameType(target))
+    {
+    case PathNameType::TGX_FILE:
+    {
+      Log(LogLevel::INFO, "Try packing provided TGX folder.");
+      const TGXFile::UniqueTgxResourcePointer tgxResource{ TGXFile::loadTgxResourceFromRaw(source, instructions) };
+      if (!tgxResource)
+      {
+        return false;
+      }
+      TGXFile::saveTgxResource(target, *tgxResource);
+      return true;
+    }
+    case PathNameType::GM1_FILE:
+    {
+      Log(LogLevel::INFO, "Try packing provided GM1 folder.");
+      const GM1File::UniqueGm1ResourcePointer gm1Resource{ GM1File::loadGm1ResourceFromRaw(source) };
+      if (!gm1Resource)
+      {
+        return false;
+      }
+      GM1File::saveGm1Resource(target, *gm1Resource);
+      return true;
+    }
+    default:
+      Log(LogLevel::ERROR, "Provided result file path has no supported file extension.");
+      return false;
+    }
+  }
+
+  bool extractResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions, const ConversionCache::Cache* cache, ResourceCache::Cache* resourceCache)
+  {
+    const Timings::FileScope timingScope{ source };
+    if (!cache)
+    {
+      return internalExtractResource(source, target, instructions, extractOptions, resourceCache);
+    }
+
+    Log(LogLevel::DEBUG, "Hashing input for conversion cache.");
+    const std::string key{ cache->createExtractKey(source, target, instructions, extractOptions) };
+    if (cache->tryRestoreExtract(key, target))
+    {
+      Log(LogLevel::INFO, "Input unchanged. Restored extracted files from cache entry '{}'.", key);
+      return true;
+    }
+    if (!internalExtractResource(source, target, instructions, extractOptions, resourceCache))
+    {
+      return false;
+    }
+    cache->store(key, target);
+    return true;
+  }
+
+  bool packResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ConversionCache::Cache* cache)
+  {
+    const Timings::FileScope timingScope{ source };
+    if (!cache)
+    {
+      return internalPackResource(source, target, instructions);
+    }
+
+    Log(LogLevel::DEBUG, "Hashing input for conversion cache.");
+    const std::string key{ cache->createPackKey(source, target, instructions) };
+    if (cache->tryRestorePack(key, target))
+    {
+      Log(LogLevel::INFO, "Input unchanged. Restored packed file from cache entry '{}'.", key);
+      return true;
+    }
+    if (!internalPackResource(source, target, instructions))
+    {
+      return false;
+    }
+    cache->store(key, target);
+    return true;
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "TGXCoder.h"
+#include "ConversionCache.h"
+#include "ResourceCache.h"
+#include "ExtractOptions.h"
+
+#include <filesystem>
+
+// the single file operations of the CLI, shared by the single and batch commands
+// the functions log their failures and return false, but exceptions are passed on
+// if a resource cache is given, TGX and GM1 files are loaded through it
+
+namespace ResourceOperations
+{
+  enum class PathNameType
+  {
+    TGX_FILE,
+    GM1_FILE,
+    FOLDER,
+    UNKNOWN
+  };
+
+  PathNameType determinePathNameType(const std::filesystem::path& path);
+
+  // reads the first object of the resource meta file in the folder to decide which file it packs to
+  // returns UNKNOWN if the folder contains no known resource
+  PathNameType determineRawResourceType(const std::filesystem::path& folder);
+
+  // the detailed analysis is optional and filled with the sum of all TGX images of a valid resource
+  bool testResource(const std::filesystem::path& source, const TgxCoderInstruction& instructions, TgxTextMode tgxTextMode,
+    TgxDetailedAnalysis* detailedAnalysis = nullptr, ResourceCache::Cache* resourceCache = nullptr);
+
+  // decodes and encodes the resource in memory, returns true if the result is identical to the original data
+  bool roundTripResource(const std::filesystem::path& source, const TgxCoderInstruction& instructions,
+    ResourceCache::Cache* resourceCache = nullptr);
+
+  // if a cache is given, unchanged inputs restore the cached output instead of converting again
+  bool extractResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions, const ConversionCache::Cache* cache = nullptr, ResourceCache::Cache* resourceCache = nullptr);
+  bool packResource(const std::filesystem::path& source, const std::filesystem::path& target, const TgxCoderInstruction& instructions,
+    const ConversionCache::Cache* cache = nullptr);
+}
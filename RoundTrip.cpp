@@ -0,0 +1,235 @@
+#include "RoundTrip.h"
+
+#include "Gm1Coder.h"
+#include "GM1File.h"
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+
+namespace RoundTrip
+{
+  // buffers reused across the images of one resource
+  struct RoundTripBuffers
+  {
+    std::vector<uint16_t> raw;
+    std::vector<uint8_t> encoded;
+  };
+
+  static uint16_t* prepareRaw(RoundTripBuffers& buffers, const int width, const int height, const uint16_t transparentPixel)
+  {
+    buffers.raw.assign(static_cast<size_t>(width) * height, transparentPixel);
+    return buffers.raw.data();
+  }
+
+  static std::optional<size_t> findFirstDifference(std::span<const uint8_t> original, std::span<const uint8_t> encoded)
+  {
+    const auto [originalIt, encodedIt] { std::mismatch(original.begin(), original.end(), encoded.begin(), encoded.end()) };
+    if (originalIt == original.end() && encodedIt == encoded.end())
+    {
+      return {};
+    }
+    return static_cast<size_t>(originalIt - original.begin());
+  }
+
+  static void throwTgxError(const size_t imageIndex, const TgxCoderResult result)
+  {
+    throw std::runtime_error{ std::format("Image {}: {}", imageIndex, getTgxResultDescription(result)) };
+  }
+
+  static void throwGm1Error(const size_t imageIndex, const Gm1CoderResult result)
+  {
+    throw std::runtime_error{ std::format("Image {}: {}", imageIndex, getGm1ResultDescription(result)) };
+  }
+
+  // decodes the TGX data into a canvas of its size and appends the encoded result to the buffer
+  static void roundTripTgxData(RoundTripBuffers& buffers, const size_t imageIndex, const TgxColorType colorType,
+    std::span<uint8_t> data, const int32_t width, const int32_t height, const TgxCoderInstruction& instructions)
+  {
+    const TgxCoderTgxInfo tgxInfo{
+      .colorType{ colorType },
+      .data{ data.data() },
+      .dataSize{ static_cast<uint32_t>(data.size()) },
+      .tgxWidth{ width },
+      .tgxHeight{ height }
+    };
+    const TgxCoderRawInfo rawInfo{
+      .data{ prepareRaw(buffers, width, height, instructions.transparentPixelRawColor) },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 }
+    };
+    TgxCoderRawInfo decodeRawInfo{ rawInfo };
+    const TgxCoderResult decodeResult{ decodeTgxToRaw(&tgxInfo, &decodeRawInfo, nullptr) };
+    if (decodeResult != TgxCoderResult::SUCCESS)
+    {
+      throwTgxError(imageIndex, decodeResult);
+    }
+
+    TgxCoderTgxInfo encodeInfo{
+      .colorType{ colorType },
+      .data{ nullptr },
+      .dataSize{ 0 },
+      .tgxWidth{ width },
+      .tgxHeight{ height }
+    };
+    const TgxCoderResult sizeResult{ encodeRawToTgx(&rawInfo, &encodeInfo, &instructions) };
+    if (sizeResult != TgxCoderResult::FILLED_ENCODING_SIZE)
+    {
+      throwTgxError(imageIndex, sizeResult);
+    }
+    const size_t encodedStart{ buffers.encoded.size() };
+    buffers.encoded.resize(encodedStart + encodeInfo.dataSize);
+    encodeInfo.data = buffers.encoded.data() + encodedStart;
+    const TgxCoderResult encodeResult{ encodeRawToTgx(&rawInfo, &encodeInfo, &instructions) };
+    if (encodeResult != TgxCoderResult::SUCCESS)
+    {
+      throwTgxError(imageIndex, encodeResult);
+    }
+  }
+
+  static void roundTripTile(RoundTripBuffers& buffers, const size_t imageIndex, const uint8_t* tile, const TgxCoderInstruction& instructions)
+  {
+    Gm1CoderRawInfo rawInfo{
+      .raw{ prepareRaw(buffers, TILE_WIDTH, TILE_HEIGHT, instructions.transparentPixelRawColor) },
+      .rawWidth{ TILE_WIDTH },
+      .rawHeight{ TILE_HEIGHT },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+    const Gm1CoderResult decodeResult{ decodeTileToRaw(reinterpret_cast<const uint16_t*>(tile), &rawInfo) };
+    if (decodeResult != Gm1CoderResult::SUCCESS)
+    {
+      throwGm1Error(imageIndex, decodeResult);
+    }
+
+    const size_t encodedStart{ buffers.encoded.size() };
+    buffers.encoded.resize(encodedStart + TILE_BYTE_SIZE);
+    const Gm1CoderResult encodeResult{ encodeRawToTile(&rawInfo, reinterpret_cast<uint16_t*>(buffers.encoded.data() + encodedStart)) };
+    if (encodeResult != Gm1CoderResult::SUCCESS)
+    {
+      throwGm1Error(imageIndex, encodeResult);
+    }
+  }
+
+  static void roundTripUncompressed(RoundTripBuffers& buffers, const size_t imageIndex, std::span<uint8_t> data,
+    const int32_t width, const int32_t height, const TgxCoderInstruction& instructions)
+  {
+    const Gm1CoderDataInfo dataInfo{
+      .data{ data.data() },
+      .dataSize{ static_cast<uint32_t>(data.size()) },
+      .dataWidth{ width },
+      .dataHeight{ height },
+    };
+    Gm1CoderRawInfo rawInfo{
+      .raw{ prepareRaw(buffers, width, height, instructions.transparentPixelRawColor) },
+      .rawWidth{ width },
+      .rawHeight{ height },
+      .rawX{ 0 },
+      .rawY{ 0 },
+    };
+    const Gm1CoderResult decodeResult{ copyUncompressedToRaw(&dataInfo, &rawInfo, instructions.transparentPixelRawColor) };
+    if (decodeResult != Gm1CoderResult::SUCCESS)
+    {
+      throwGm1Error(imageIndex, decodeResult);
+    }
+
+    Gm1CoderDataInfo encodeInfo{
+      .data{ nullptr },
+      .dataSize{ 0 },
+      .dataWidth{ width },
+      .dataHeight{ height },
+    };
+    const Gm1CoderResult sizeResult{ copyRawToUncompressed(&rawInfo, &encodeInfo, instructions.transparentPixelRawColor) };
+    if (sizeResult != Gm1CoderResult::FILLED_ENCODING_SIZE)
+    {
+      throwGm1Error(imageIndex, sizeResult);
+    }
+    const size_t encodedStart{ buffers.encoded.size() };
+    buffers.encoded.resize(encodedStart + encodeInfo.dataSize);
+    encodeInfo.data = buffers.encoded.data() + encodedStart;
+    const Gm1CoderResult encodeResult{ copyRawToUncompressed(&rawInfo, &encodeInfo, instructions.transparentPixelRawColor) };
+    if (encodeResult != Gm1CoderResult::SUCCESS)
+    {
+      throwGm1Error(imageIndex, encodeResult);
+    }
+  }
+
+  static std::optional<RoundTripDifference> compareImage(const RoundTripBuffers& buffers, const size_t imageIndex, std::span<const uint8_t> original)
+  {
+    const std::optional<size_t> differenceOffset{ findFirstDifference(original, buffers.encoded) };
+    if (!differenceOffset)
+    {
+      return {};
+    }
+    return RoundTripDifference{
+      .imageIndex{ imageIndex },
+      .byteOffset{ *differenceOffset },
+      .originalSize{ static_cast<uint32_t>(original.size()) },
+      .encodedSize{ static_cast<uint32_t>(buffers.encoded.size()) }
+    };
+  }
+
+  std::optional<RoundTripDifference> roundTripTgxResource(const TgxResource& resource, const TgxCoderInstruction& instructions)
+  {
+    RoundTripBuffers buffers{};
+    const std::span<uint8_t> data{ resource.imageData, resource.dataSize };
+    roundTripTgxData(buffers, 0, TgxColorType::DEFAULT, data, resource.header->width, resource.header->height, instructions);
+    return compareImage(buffers, 0, data);
+  }
+
+  std::optional<RoundTripDifference> roundTripGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions)
+  {
+    const Gm1Type type{ resource.gm1Header->info.gm1Type };
+    RoundTripBuffers buffers{};
+    for (size_t i{ 0 }; i < resource.gm1Header->info.numberOfPicturesInFile; ++i)
+    {
+      const Gm1Image& image{ resource.imageHeaders[i] };
+      const std::span<uint8_t> data{ resource.imageData + resource.imageOffsets[i], resource.imageSizes[i] };
+      buffers.encoded.clear();
+
+      switch (type)
+      {
+      case Gm1Type::GM1_TYPE_INTERFACE:
+      case Gm1Type::GM1_TYPE_TGX_CONST_SIZE:
+      case Gm1Type::GM1_TYPE_FONT:
+      case Gm1Type::GM1_TYPE_ANIMATIONS:
+        roundTripTgxData(buffers, i, type == Gm1Type::GM1_TYPE_ANIMATIONS ? TgxColorType::INDEXED : TgxColorType::DEFAULT,
+          data, image.imageHeader.width, image.imageHeader.height, instructions);
+        break;
+      case Gm1Type::GM1_TYPE_TILES_OBJECT:
+      {
+        // tile and image part are handled separately, since they overlap on the canvas
+        if (data.size() < TILE_BYTE_SIZE)
+        {
+          throw std::runtime_error{ std::format("Image {}: Data is smaller than a tile.", i) };
+        }
+        roundTripTile(buffers, i, data.data(), instructions);
+        const Gm1TileObjectImageInfo& tileObjectInfo{ image.imageInfo.tileObjectImageInfo };
+        if (tileObjectInfo.imagePosition != Gm1TileObjectImagePosition::NONE)
+        {
+          roundTripTgxData(buffers, i, TgxColorType::DEFAULT, data.subspan(TILE_BYTE_SIZE),
+            tileObjectInfo.imageWidth, tileObjectInfo.tileOffset + GM1File::TILE_IMAGE_HEIGHT_OFFSET, instructions);
+        }
+        break;
+      }
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_1:
+      case Gm1Type::GM1_TYPE_NO_COMPRESSION_2:
+        roundTripUncompressed(buffers, i, data, image.imageHeader.width, image.imageHeader.height, instructions);
+        break;
+
+      default:
+        throw std::runtime_error{ "Resource has unknown type." };
+      }
+
+      std::optional<RoundTripDifference> difference{ compareImage(buffers, i, data) };
+      if (difference)
+      {
+        return difference;
+      }
+    }
+    return {};
+  }
+}
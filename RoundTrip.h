@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SHCResourceConverter.h"
+#include "TGXCoder.h"
+
+#include <optional>
+
+// decodes resources image by image in memory and encodes them again, to check the coders against the original data
+// no raw resource is created, so this also works for GM1 files, which can not be packed yet
+
+namespace RoundTrip
+{
+  struct RoundTripDifference
+  {
+    size_t imageIndex; // always 0 for TGX files
+    size_t byteOffset; // relative to the start of the image data
+    uint32_t originalSize;
+    uint32_t encodedSize;
+  };
+
+  // return the first difference or an empty optional if the encoded data is identical
+  // throw if the data can not be decoded or encoded
+  std::optional<RoundTripDifference> roundTripTgxResource(const TgxResource& resource, const TgxCoderInstruction& instructions);
+  std::optional<RoundTripDifference> roundTripGm1Resource(const Gm1Resource& resource, const TgxCoderInstruction& instructions);
+}
+
+template<>
+struct std::formatter<RoundTrip::RoundTripDifference> : public std::formatter<std::string>
+{
+  template<typename FormatContext>
+  auto format(const RoundTrip::RoundTripDifference& args, FormatContext& ctx) const
+  {
+    return format_to(ctx.out(), "Image Index: {}\nByte Offset: {}\nOriginal Size: {}\nEncoded Size: {}",
+      args.imageIndex, args.byteOffset, args.originalSize, args.encodedSize);
+  }
+};
@@ -2,8 +2,10 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <map>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
 
 #include "Console.h"
 #include "Utility.h"
@@ -16,6 +18,17 @@
 #include "TGXFile.h"
 #include "GM1File.h"
 
+#include "ResourceOperations.h"
+#include "BatchOperations.h"
+#include "JobFile.h"
+#include "ConversionServer.h"
+#include "Benchmark.h"
+#include "CorpusGenerator.h"
+#include "Microbenchmark.h"
+#include "CoderCheck.h"
+#include "TaskPool.h"
+#include "Timings.h"
+
 // only test, TODO: clean
 #include "ResourceMetaFormat.h"
 
@@ -45,6 +58,16 @@ namespace COMMAND
   inline const std::string TEST{ "test" };
   inline const std::string EXTRACT{ "extract" };
   inline const std::string PACK{ "pack" };
+  inline const std::string TEST_ALL{ "test-all" };
+  inline const std::string EXTRACT_ALL{ "extract-all" };
+  inline const std::string PACK_ALL{ "pack-all" };
+  inline const std::string RUN{ "run" };
+  inline const std::string ROUNDTRIP{ "roundtrip" };
+  inline const std::string SERVE{ "serve" };
+  inline const std::string BENCH{ "bench" };
+  inline const std::string GENERATE{ "generate" };
+  inline const std::string MICROBENCH{ "microbench" };
+  inline const std::string CHECK{ "check" };
   inline const std::string HELP{ "help" };
 }
 
@@ -57,16 +80,33 @@ namespace OPTION
   inline const std::string TGX_CODER_TRANSPARENT_PIXEL_RAW_COLOR{ "tgx-coder-transparent-pixel-raw-color" };
   inline const std::string TGX_CODER_PIXEL_REPEAT_THRESHOLD{ "tgx-coder-pixel-repeat-threshold" };
   inline const std::string TGX_CODER_PADDING_ALIGNMENT{ "tgx-coder-padding-alignment" };
+  inline const std::string THREADS{ "threads" };
+  inline const std::string CACHE{ "cache" };
+  inline const std::string SERVE_RESOURCE_CACHE_MB{ "serve-resource-cache-mb" };
+  inline const std::string TIMINGS{ "timings" };
+  inline const std::string EXTRACT_PNG{ "extract-png" };
+  inline const std::string EXTRACT_RAW_FORMAT{ "extract-raw-format" };
+  inline const std::string EXTRACT_PNG_PALETTE{ "extract-png-palette" };
+  inline const std::string EXTRACT_COMPRESSION{ "extract-compression" };
+  inline const std::string EXTRACT_TUNE_REPEAT_THRESHOLD{ "extract-tune-repeat-threshold" };
+  inline const std::string EXTRACT_KEEP_ORIGINAL{ "extract-keep-original" };
+  inline const std::string BENCH_ITERATIONS{ "bench-iterations" };
+  inline const std::string GENERATE_SEED{ "generate-seed" };
+  inline const std::string GENERATE_WIDTH{ "generate-width" };
+  inline const std::string GENERATE_HEIGHT{ "generate-height" };
+  inline const std::string GENERATE_IMAGES{ "generate-images" };
+  inline const std::string GENERATE_TRANSPARENCY{ "generate-transparency" };
+  inline const std::string GENERATE_REPEAT{ "generate-repeat" };
+  inline const std::string GENERATE_MAX_RUN{ "generate-max-run" };
+  inline const std::string MICROBENCH_WIDTH{ "microbench-width" };
+  inline const std::string MICROBENCH_HEIGHT{ "microbench-height" };
+  inline const std::string MICROBENCH_SAMPLES{ "microbench-samples" };
+  inline const std::string MICROBENCH_BASELINE{ "microbench-baseline" };
+  inline const std::string MICROBENCH_SAVE{ "microbench-save" };
+  inline const std::string CHECK_SEED{ "check-seed" };
+  inline const std::string CHECK_CASES{ "check-cases" };
 }
 
-enum class PathNameType
-{
-  TGX_FILE,
-  GM1_FILE,
-  FOLDER,
-  UNKNOWN
-};
-
 
 /* Support functions */
 
@@ -109,25 +149,39 @@ static TgxCoderInstruction getCoderInstructionFromCliOptionsWithFallback(const C
   return coderInstruction;
 }
 
-static PathNameType determinePathNameType(const std::filesystem::path& path)
+static ExtractOptions getExtractOptionsFromCliOptionsWithFallback(const CLIArguments& cliArguments)
 {
-  const std::string extension{ path.extension().string() };
-  if (extension == TGXFile::FILE_EXTENSION)
-  {
-    return PathNameType::TGX_FILE;
-  }
-  if (extension == GM1File::FILE_EXTENSION)
-  {
-    return PathNameType::GM1_FILE;
-  }
-  else if (extension == "")
-  {
-    return PathNameType::FOLDER;
-  }
-  else
+  const ExtractOptions extractOptions{
+    .pngFormat{ cliArguments.getOptionAs<PngFile::pngFormatFromStr>(OPTION::EXTRACT_PNG).value_or(DEFAULT_EXTRACT_OPTIONS.pngFormat) },
+    .rawPixelFormat{ cliArguments.getOptionAs<PixelConversion::rawPixelFormatFromStr>(OPTION::EXTRACT_RAW_FORMAT)
+      .value_or(DEFAULT_EXTRACT_OPTIONS.rawPixelFormat) },
+    .pngPalette{ cliArguments.getOptionAs<GM1File::pngPaletteFromStr>(OPTION::EXTRACT_PNG_PALETTE).value_or(DEFAULT_EXTRACT_OPTIONS.pngPalette) },
+    .dataCompression{ cliArguments.getOptionAs<RawCompression::compressionFromStr>(OPTION::EXTRACT_COMPRESSION)
+      .value_or(DEFAULT_EXTRACT_OPTIONS.dataCompression) },
+    .tunePixelRepeatThreshold{ cliArguments.getOptionAs<boolFromStr>(OPTION::EXTRACT_TUNE_REPEAT_THRESHOLD)
+      .value_or(DEFAULT_EXTRACT_OPTIONS.tunePixelRepeatThreshold) },
+    .keepOriginalEncoding{ cliArguments.getOptionAs<boolFromStr>(OPTION::EXTRACT_KEEP_ORIGINAL)
+      .value_or(DEFAULT_EXTRACT_OPTIONS.keepOriginalEncoding) }
+  };
+  Log(LogLevel::DEBUG, "Extract PNG format: {}", PngFile::getPngFormatName(extractOptions.pngFormat));
+  Log(LogLevel::DEBUG, "Extract raw format: {}", PixelConversion::getRawPixelFormatName(extractOptions.rawPixelFormat));
+  Log(LogLevel::DEBUG, "Extract PNG palette: {}", extractOptions.pngPalette == PNG_ALL_PALETTES ? "all" : std::to_string(extractOptions.pngPalette));
+  Log(LogLevel::DEBUG, "Extract compression: {}", RawCompression::getCompressionName(extractOptions.dataCompression));
+  Log(LogLevel::DEBUG, "Extract tune repeat threshold: {}", extractOptions.tunePixelRepeatThreshold);
+  Log(LogLevel::DEBUG, "Extract keep original: {}", extractOptions.keepOriginalEncoding);
+  return extractOptions;
+}
+
+
+static std::optional<ConversionCache::Cache> getConversionCacheFromCliOption(const CLIArguments& cliArguments)
+{
+  const std::string* cacheFolder{ cliArguments.getOption(OPTION::CACHE) };
+  if (!cacheFolder)
   {
-    return PathNameType::UNKNOWN;
+    return {};
   }
+  Log(LogLevel::DEBUG, "Using conversion cache in '{}'.", *cacheFolder);
+  return ConversionCache::Cache{ std::filesystem::path{ cacheFolder->c_str() } };
 }
 
 
@@ -153,33 +207,9 @@ static int executeTest(const CLIArguments& cliArguments)
     }
     const std::filesystem::path source{ sourceStr->c_str() };
 
-    switch (determinePathNameType(source))
-    {
-    case PathNameType::TGX_FILE:
-    {
-      Log(LogLevel::INFO, "Try testing provided TGX file path.");
-      const TGXFile::UniqueTgxResourcePointer tgxResource{ TGXFile::loadTgxResource(source) };
-      if (!tgxResource)
-      {
-        return 1;
-      }
-      TGXFile::validateTgxResource(*tgxResource, cliArguments.getOptionAs<boolFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(false));
-    }
-    break;
-    case PathNameType::GM1_FILE:
+    if (!ResourceOperations::testResource(source, getCoderInstructionFromCliOptionsWithFallback(cliArguments),
+      cliArguments.getOptionAs<tgxTextModeFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(TgxTextMode::NONE)))
     {
-      Log(LogLevel::INFO, "Try testing provided GM1 file path.");
-      const GM1File::UniqueGm1ResourcePointer gm1Resource{ GM1File::loadGm1Resource(source) };
-      if (!gm1Resource)
-      {
-        return 1;
-      }
-      GM1File::validateGm1Resource(*gm1Resource, getCoderInstructionFromCliOptionsWithFallback(cliArguments),
-        cliArguments.getOptionAs<boolFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(false));
-    }
-    break;
-    default:
-      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
       return 1;
     }
     Log(LogLevel::INFO, "Successfully tested provided file.");
@@ -209,38 +239,10 @@ static int executeExtract(const CLIArguments& cliArguments)
     const std::filesystem::path source{ sourceStr->c_str() };
     const std::filesystem::path target{ targetStr->c_str() };
 
-    if (determinePathNameType(target) != PathNameType::FOLDER)
-    {
-      Log(LogLevel::ERROR, "Provided folder has an extension, which is not supported.");
-      return 1;
-    }
-
-    switch (determinePathNameType(source))
-    {
-    case PathNameType::TGX_FILE:
-    {
-      Log(LogLevel::INFO, "Try extracting provided TGX file.");
-      const TGXFile::UniqueTgxResourcePointer tgxResource{ TGXFile::loadTgxResource(source) };
-      if (!tgxResource)
-      {
-        return 1;
-      }
-      TGXFile::saveTgxResourceAsRaw(target, *tgxResource, getCoderInstructionFromCliOptionsWithFallback(cliArguments));
-    }
-    break;
-    case PathNameType::GM1_FILE:
+    const std::optional<ConversionCache::Cache> cache{ getConversionCacheFromCliOption(cliArguments) };
+    if (!ResourceOperations::extractResource(source, target, getCoderInstructionFromCliOptionsWithFallback(cliArguments),
+      getExtractOptionsFromCliOptionsWithFallback(cliArguments), cache ? &*cache : nullptr))
     {
-      Log(LogLevel::INFO, "Try extracting provided GM1 file.");
-      const GM1File::UniqueGm1ResourcePointer gm1Resource{ GM1File::loadGm1Resource(source) };
-      if (!gm1Resource)
-      {
-        return 1;
-      }
-      GM1File::saveGm1ResourceAsRaw(target, *gm1Resource, getCoderInstructionFromCliOptionsWithFallback(cliArguments));
-    }
-    break;
-    default:
-      Log(LogLevel::ERROR, "Provided file path has no supported file extension.");
       return 1;
     }
     Log(LogLevel::INFO, "Successfully extracted provided file.");
@@ -270,107 +272,551 @@ static int executePack(const CLIArguments& cliArguments)
     const std::filesystem::path source{ sourceStr->c_str() };
     const std::filesystem::path target{ targetStr->c_str() };
 
-    if (determinePathNameType(source) != PathNameType::FOLDER)
+    const std::optional<ConversionCache::Cache> cache{ getConversionCacheFromCliOption(cliArguments) };
+    if (!ResourceOperations::packResource(source, target, getCoderInstructionFromCliOptionsWithFallback(cliArguments), cache ? &*cache : nullptr))
     {
-      Log(LogLevel::ERROR, "Provided folder has an extension, which is not supported.");
       return 1;
     }
+    Log(LogLevel::INFO, "Successfully packed provided file.");
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during file pack: {}", e.what());
+    return 1;
+  }
+}
+
 
-    switch (determinePathNameType(target))
+static int executeBatch(const CLIArguments& cliArguments, BatchOperations::BatchOperationType type)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try processing provided folder.");
+    const bool requiresTarget{ type == BatchOperations::BatchOperationType::EXTRACT || type == BatchOperations::BatchOperationType::PACK };
+    const std::string* sourceStr{ cliArguments.getArgument(1) };
+    const std::string* targetStr{ cliArguments.getArgument(2) };
+    const std::string* argNumCheck{ cliArguments.getArgument(requiresTarget ? 3 : 2) };
+    if (!sourceStr || (requiresTarget && !targetStr) || argNumCheck)
     {
-    case PathNameType::TGX_FILE:
+      Log(LogLevel::WARNING, "Argument missing or too many arguments provided. Printing help.");
+      printHelp();
+      return 1;
+    }
+    const std::filesystem::path source{ sourceStr->c_str() };
+    const std::filesystem::path target{ requiresTarget ? targetStr->c_str() : "" };
+
+    if (!std::filesystem::is_directory(source))
     {
-      Log(LogLevel::INFO, "Try packing provided TGX folder.");
-      const TGXFile::UniqueTgxResourcePointer tgxResource{ TGXFile::loadTgxResourceFromRaw(source, getCoderInstructionFromCliOptionsWithFallback(cliArguments)) };
-      if (!tgxResource)
-      {
-        return 1;
-      }
-      TGXFile::saveTgxResource(target, *tgxResource);
+      Log(LogLevel::ERROR, "Provided source path is not a directory.");
+      return 1;
     }
-    break;
-    case PathNameType::GM1_FILE:
+
+    const std::vector<BatchOperations::BatchJob> jobs{ BatchOperations::collectJobs(type, source, target,
+      getCoderInstructionFromCliOptionsWithFallback(cliArguments), getExtractOptionsFromCliOptionsWithFallback(cliArguments), cliArguments.getOptionAs<tgxTextModeFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(TgxTextMode::NONE)) };
+
+    const std::optional<ConversionCache::Cache> cache{ getConversionCacheFromCliOption(cliArguments) };
+    TaskPool pool{ cliArguments.getOptionAs<uintFromStr<unsigned int>>(OPTION::THREADS).value_or(0) };
+    Log(LogLevel::INFO, "Processing {} resources with {} threads.", jobs.size(), pool.getThreadCount());
+    const std::vector<BatchOperations::BatchJobResult> results{ BatchOperations::runJobs(pool, jobs, cache ? &*cache : nullptr) };
+
+    if (BatchOperations::reportResults(jobs, results) > 0)
     {
-      Log(LogLevel::INFO, "Try packing provided GM1 folder.");
-      const GM1File::UniqueGm1ResourcePointer gm1Resource{ GM1File::loadGm1ResourceFromRaw(source) };
-      if (!gm1Resource)
-      {
-        return 1;
-      }
-      GM1File::saveGm1Resource(target, *gm1Resource);
+      Log(LogLevel::ERROR, "Some resources failed to process.");
+      return 1;
+    }
+    Log(LogLevel::INFO, "Successfully processed provided folder.");
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during folder processing: {}", e.what());
+    return 1;
+  }
+}
+
+
+// a folder is handled like a batch command, to check many files in parallel
+static int executeRoundTrip(const CLIArguments& cliArguments)
+{
+  try
+  {
+    const std::string* sourceStr{ cliArguments.getArgument(1) };
+    const std::string* argNumCheck{ cliArguments.getArgument(2) };
+    if (!sourceStr || argNumCheck)
+    {
+      Log(LogLevel::WARNING, "Argument missing or too many arguments provided. Printing help.");
+      printHelp();
+      return 1;
     }
-    break;
-    default:
-      Log(LogLevel::ERROR, "Provided result file path has no supported file extension.");
+    const std::filesystem::path source{ sourceStr->c_str() };
+    if (std::filesystem::is_directory(source))
+    {
+      return executeBatch(cliArguments, BatchOperations::BatchOperationType::ROUNDTRIP);
+    }
+
+    Log(LogLevel::INFO, "Try round trip of provided file.");
+    if (!ResourceOperations::roundTripResource(source, getCoderInstructionFromCliOptionsWithFallback(cliArguments)))
+    {
       return 1;
     }
-    Log(LogLevel::INFO, "Successfully packed provided file.");
+    Log(LogLevel::INFO, "Successfully completed round trip of provided file.");
     return 0;
   }
   catch (const std::exception& e)
   {
-    Log(LogLevel::ERROR, "Encountered exception during file pack: {}", e.what());
+    Log(LogLevel::ERROR, "Encountered exception during round trip: {}", e.what());
     return 1;
   }
 }
 
+static int executeRun(const CLIArguments& cliArguments)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try running provided job file.");
+    const std::string* jobFileStr{ cliArguments.getArgument(1) };
+    const std::string* argNumCheck{ cliArguments.getArgument(2) };
+    if (!jobFileStr || argNumCheck)
+    {
+      Log(LogLevel::WARNING, "Argument missing or too many arguments provided. Printing help.");
+      printHelp();
+      return 1;
+    }
+    const std::filesystem::path jobFile{ jobFileStr->c_str() };
+
+    // the options of the command are the defaults for every job
+    const std::vector<BatchOperations::BatchJob> jobs{ JobFile::loadJobFile(jobFile,
+      getCoderInstructionFromCliOptionsWithFallback(cliArguments), getExtractOptionsFromCliOptionsWithFallback(cliArguments), cliArguments.getOptionAs<tgxTextModeFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(TgxTextMode::NONE)) };
 
-/* MAIN */
+    const std::optional<ConversionCache::Cache> cache{ getConversionCacheFromCliOption(cliArguments) };
+    TaskPool pool{ cliArguments.getOptionAs<uintFromStr<unsigned int>>(OPTION::THREADS).value_or(0) };
+    Log(LogLevel::INFO, "Running {} jobs with {} threads.", jobs.size(), pool.getThreadCount());
+    const std::vector<BatchOperations::BatchJobResult> results{ BatchOperations::runJobs(pool, jobs, cache ? &*cache : nullptr) };
 
-int main(int argc, char* argv[])
+    if (BatchOperations::reportResults(jobs, results) > 0)
+    {
+      Log(LogLevel::ERROR, "Some jobs failed.");
+      return 1;
+    }
+    Log(LogLevel::INFO, "Successfully ran provided job file.");
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during job file run: {}", e.what());
+    return 1;
+  }
+}
+
+
+// requests are read from stdin and answered on stdout, see ConversionServer.h for the protocol
+static int executeServe(const CLIArguments& cliArguments)
 {
   try
   {
-    const CLIArguments cliArguments{ CLIArguments::parse(argc, argv) };
-    setLogLevelFromCliOption(cliArguments);
-    Log(LogLevel::DEBUG, "CLIArguments:\n{}", cliArguments);
-   
-    const std::string* command{ cliArguments.getArgument(0) };
-    if (!command)
+    const std::string* argNumCheck{ cliArguments.getArgument(1) };
+    if (argNumCheck)
     {
-      Log(LogLevel::WARNING, "No command provided. Printing help.");
+      Log(LogLevel::WARNING, "Too many arguments provided. Printing help.");
       printHelp();
       return 1;
     }
 
-    if (COMMAND::HELP == *command)
+    // the options of the command are the defaults for every request
+    const TgxCoderInstruction defaultInstructions{ getCoderInstructionFromCliOptionsWithFallback(cliArguments) };
+    const ExtractOptions defaultExtractOptions{ getExtractOptionsFromCliOptionsWithFallback(cliArguments) };
+    const TgxTextMode defaultTgxTextMode{ cliArguments.getOptionAs<tgxTextModeFromStr>(OPTION::TEST_TGX_TO_TEXT).value_or(TgxTextMode::NONE) };
+    const std::optional<ConversionCache::Cache> cache{ getConversionCacheFromCliOption(cliArguments) };
+    // loaded resources are kept up to this size, 0 disables the resource cache
+    const uint64_t resourceCacheMegabytes{
+      cliArguments.getOptionAs<uintFromStr<uint64_t>>(OPTION::SERVE_RESOURCE_CACHE_MB).value_or(ResourceCache::DEFAULT_MAX_MEGABYTES) };
+    std::optional<ResourceCache::Cache> resourceCache{};
+    if (resourceCacheMegabytes > 0)
+    {
+      resourceCache.emplace(resourceCacheMegabytes * 1024 * 1024);
+    }
+    TaskPool pool{ cliArguments.getOptionAs<uintFromStr<unsigned int>>(OPTION::THREADS).value_or(0) };
+
+    const size_t failedRequests{ ConversionServer::serve(std::cin, STD_OUT, pool, cache ? &*cache : nullptr, resourceCache ? &*resourceCache : nullptr,
+      defaultInstructions, defaultExtractOptions, defaultTgxTextMode) };
+    if (failedRequests > 0)
+    {
+      Log(LogLevel::WARNING, "{} requests failed.", failedRequests);
+    }
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception while serving requests: {}", e.what());
+    return 1;
+  }
+}
+
+
+// runs single threaded, to keep the measured numbers comparable
+static int executeBench(const CLIArguments& cliArguments)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try benchmarking provided path.");
+    const std::string* sourceStr{ cliArguments.getArgument(1) };
+    const std::string* argNumCheck{ cliArguments.getArgument(2) };
+    if (!sourceStr || argNumCheck)
     {
+      Log(LogLevel::WARNING, "Argument missing or too many arguments provided. Printing help.");
       printHelp();
-      return 0;
+      return 1;
     }
+    const std::filesystem::path source{ sourceStr->c_str() };
 
-    if (COMMAND::TEST == *command)
+    std::vector<std::filesystem::path> files{};
+    if (std::filesystem::is_directory(source))
     {
-      const int result{ executeTest(cliArguments) };
-      if (result != 0)
+      for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ source })
       {
-        return result;
+        const ResourceOperations::PathNameType type{ ResourceOperations::determinePathNameType(entry.path()) };
+        if (entry.is_regular_file() && (type == ResourceOperations::PathNameType::TGX_FILE || type == ResourceOperations::PathNameType::GM1_FILE))
+        {
+          files.emplace_back(entry.path());
+        }
       }
-    } else if (COMMAND::EXTRACT == *command)
+      std::sort(files.begin(), files.end());
+    }
+    else
     {
-      const int result{ executeExtract(cliArguments) };
-      if (result != 0)
+      files.emplace_back(source);
+    }
+
+    const Benchmark::BenchmarkSettings settings{
+      .iterations{ cliArguments.getOptionAs<intFromStr<int, 0, 1>>(OPTION::BENCH_ITERATIONS).value_or(5) },
+      .instructions{ getCoderInstructionFromCliOptionsWithFallback(cliArguments) }
+    };
+    Log(LogLevel::INFO, "Benchmarking {} files with {} iterations.", files.size(), settings.iterations);
+
+    Benchmark::BenchmarkReport report{};
+    size_t failedFiles{ 0 };
+    for (const std::filesystem::path& file : files)
+    {
+      try
       {
-        return result;
+        if (!Benchmark::benchmarkFile(file, settings, report))
+        {
+          ++failedFiles;
+        }
       }
-    } else if (COMMAND::PACK == *command)
-    {
-      const int result{ executePack(cliArguments) };
-      if (result != 0)
+      catch (const std::exception& e)
       {
-        return result;
+        Log(LogLevel::ERROR, "Encountered exception while benchmarking '{}': {}", file.string(), e.what());
+        ++failedFiles;
       }
     }
-    else
+    report.print();
+
+    if (failedFiles > 0)
     {
-      Log(LogLevel::ERROR, "Unknown command provided. Printing help.");
+      Log(LogLevel::ERROR, "{} files could not be benchmarked.", failedFiles);
+      return 1;
+    }
+    Log(LogLevel::INFO, "Successfully benchmarked provided path.");
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during benchmark: {}", e.what());
+    return 1;
+  }
+}
+
+
+static int executeGenerate(const CLIArguments& cliArguments)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try generating synthetic corpus.");
+    const std::string* targetStr{ cliArguments.getArgument(1) };
+    const std::string* argNumCheck{ cliArguments.getArgument(2) };
+    if (!targetStr || argNumCheck)
+    {
+      Log(LogLevel::WARNING, "Argument missing or too many arguments provided. Printing help.");
+      printHelp();
+      return 1;
+    }
+    const std::filesystem::path target{ targetStr->c_str() };
+
+    const CorpusGenerator::GeneratorSettings& defaults{ CorpusGenerator::DEFAULT_SETTINGS };
+    const CorpusGenerator::GeneratorSettings settings{
+      .seed{ cliArguments.getOptionAs<uintFromStr<uint64_t>>(OPTION::GENERATE_SEED).value_or(defaults.seed) },
+      .width{ cliArguments.getOptionAs<intFromStr<int, 0, 1, 4096>>(OPTION::GENERATE_WIDTH).value_or(defaults.width) },
+      .height{ cliArguments.getOptionAs<intFromStr<int, 0, 1, 4096>>(OPTION::GENERATE_HEIGHT).value_or(defaults.height) },
+      .imageCount{ cliArguments.getOptionAs<intFromStr<int, 0, 1, 4096>>(OPTION::GENERATE_IMAGES).value_or(defaults.imageCount) },
+      .transparencyPercent{ cliArguments.getOptionAs<intFromStr<int, 0, 0, 100>>(OPTION::GENERATE_TRANSPARENCY).value_or(defaults.transparencyPercent) },
+      .repeatPercent{ cliArguments.getOptionAs<intFromStr<int, 0, 0, 100>>(OPTION::GENERATE_REPEAT).value_or(defaults.repeatPercent) },
+      .maxRunLength{ cliArguments.getOptionAs<intFromStr<int, 0, 1>>(OPTION::GENERATE_MAX_RUN).value_or(defaults.maxRunLength) },
+      .instructions{ getCoderInstructionFromCliOptionsWithFallback(cliArguments) }
+    };
+
+    const int fileCount{ CorpusGenerator::generateCorpus(target, settings) };
+    Log(LogLevel::INFO, "Successfully generated {} files.", fileCount);
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during corpus generation: {}", e.what());
+    return 1;
+  }
+}
+
+
+static int executeMicrobench(const CLIArguments& cliArguments)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try running coder microbenchmarks.");
+    const std::string* argNumCheck{ cliArguments.getArgument(1) };
+    if (argNumCheck)
+    {
+      Log(LogLevel::WARNING, "Too many arguments provided. Printing help.");
+      printHelp();
+      return 1;
+    }
+
+    const Microbenchmark::MicrobenchmarkSettings settings{
+      .width{ cliArguments.getOptionAs<intFromStr<int, 0, 1, 4096>>(OPTION::MICROBENCH_WIDTH).value_or(256) },
+      .height{ cliArguments.getOptionAs<intFromStr<int, 0, 1, 4096>>(OPTION::MICROBENCH_HEIGHT).value_or(256) },
+      .samples{ cliArguments.getOptionAs<intFromStr<int, 0, 1>>(OPTION::MICROBENCH_SAMPLES).value_or(11) },
+      .instructions{ getCoderInstructionFromCliOptionsWithFallback(cliArguments) }
+    };
+
+    std::map<std::string, double, std::less<>> baseline{};
+    if (const std::string* baselineFile{ cliArguments.getOption(OPTION::MICROBENCH_BASELINE) })
+    {
+      baseline = Microbenchmark::loadBaseline(std::filesystem::path{ baselineFile->c_str() });
+      Log(LogLevel::INFO, "Loaded baseline with {} cases.", baseline.size());
+    }
+
+    const std::vector<Microbenchmark::MicrobenchmarkResult> results{ Microbenchmark::runMicrobenchmarks(settings) };
+    Microbenchmark::printResults(results, baseline);
+
+    if (const std::string* saveFile{ cliArguments.getOption(OPTION::MICROBENCH_SAVE) })
+    {
+      Microbenchmark::saveBaseline(std::filesystem::path{ saveFile->c_str() }, results);
+      Log(LogLevel::INFO, "Saved results as baseline.");
+    }
+    return 0;
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during microbenchmarks: {}", e.what());
+    return 1;
+  }
+}
+
+
+static int executeCheck(const CLIArguments& cliArguments)
+{
+  try
+  {
+    Log(LogLevel::INFO, "Try running coder checks.");
+    const std::string* argNumCheck{ cliArguments.getArgument(1) };
+    if (argNumCheck)
+    {
+      Log(LogLevel::WARNING, "Too many arguments provided. Printing help.");
       printHelp();
       return 1;
     }
 
+    const CoderCheck::CheckSettings& defaults{ CoderCheck::DEFAULT_SETTINGS };
+    const CoderCheck::CheckSettings settings{
+      .seed{ cliArguments.getOptionAs<uintFromStr<uint64_t>>(OPTION::CHECK_SEED).value_or(defaults.seed) },
+      .cases{ cliArguments.getOptionAs<intFromStr<int, 0, 0>>(OPTION::CHECK_CASES).value_or(defaults.cases) }
+    };
+
+    const std::vector<CoderCheck::CheckResult> results{ CoderCheck::runChecks(settings) };
+    if (!CoderCheck::printResults(results))
+    {
+      Log(LogLevel::ERROR, "Coder checks failed.");
+      return 1;
+    }
+    Log(LogLevel::INFO, "All coder checks passed.");
     return 0;
   }
   catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Encountered exception during coder checks: {}", e.what());
+    return 1;
+  }
+}
+
+
+static int executeCommand(const CLIArguments& cliArguments, const std::string& command)
+{
+  if (COMMAND::TEST == command)
+  {
+    const int result{ executeTest(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::EXTRACT == command)
+  {
+    const int result{ executeExtract(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::PACK == command)
+  {
+    const int result{ executePack(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::TEST_ALL == command)
+  {
+    const int result{ executeBatch(cliArguments, BatchOperations::BatchOperationType::TEST) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::EXTRACT_ALL == command)
+  {
+    const int result{ executeBatch(cliArguments, BatchOperations::BatchOperationType::EXTRACT) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::PACK_ALL == command)
+  {
+    const int result{ executeBatch(cliArguments, BatchOperations::BatchOperationType::PACK) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::RUN == command)
+  {
+    const int result{ executeRun(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::ROUNDTRIP == command)
+  {
+    const int result{ executeRoundTrip(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::SERVE == command)
+  {
+    const int result{ executeServe(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::BENCH == command)
+  {
+    const int result{ executeBench(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::GENERATE == command)
+  {
+    const int result{ executeGenerate(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::MICROBENCH == command)
+  {
+    const int result{ executeMicrobench(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  } else if (COMMAND::CHECK == command)
+  {
+    const int result{ executeCheck(cliArguments) };
+    if (result != 0)
+    {
+      return result;
+    }
+  }
+  else
+  {
+    Log(LogLevel::ERROR, "Unknown command provided. Printing help.");
+    printHelp();
+    return 1;
+  }
+
+  return 0;
+}
+
+static int executeCommandWithTimings(const CLIArguments& cliArguments, const std::string& command)
+{
+  const std::string* timingsFile{ cliArguments.getOption(OPTION::TIMINGS) };
+  if (!timingsFile)
+  {
+    return executeCommand(cliArguments, command);
+  }
+
+  Log(LogLevel::DEBUG, "Recording timings to '{}'.", *timingsFile);
+  Timings::TimingRecorder recorder{};
+  Timings::activeRecorder = &recorder;
+  int result{ 1 };
+  try
+  {
+    result = executeCommand(cliArguments, command);
+  }
+  catch (...)
+  {
+    Timings::activeRecorder = nullptr;
+    throw;
+  }
+  Timings::activeRecorder = nullptr;
+
+  try
+  {
+    recorder.writeJson(std::filesystem::path{ timingsFile->c_str() });
+    Log(LogLevel::INFO, "Wrote timings to '{}'.", *timingsFile);
+  }
+  catch (const std::exception& e)
+  {
+    Log(LogLevel::ERROR, "Failed to write timings: {}", e.what());
+    return result != 0 ? result : 1;
+  }
+  return result;
+}
+
+
+/* MAIN */
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    const CLIArguments cliArguments{ CLIArguments::parse(argc, argv) };
+    setLogLevelFromCliOption(cliArguments);
+    Log(LogLevel::DEBUG, "CLIArguments:\n{}", cliArguments);
+   
+    const std::string* command{ cliArguments.getArgument(0) };
+    if (!command)
+    {
+      Log(LogLevel::WARNING, "No command provided. Printing help.");
+      printHelp();
+      return 1;
+    }
+
+    if (COMMAND::HELP == *command)
+    {
+      printHelp();
+      return 0;
+    }
+
+    return executeCommandWithTimings(cliArguments, *command);
+  }
+  catch (const std::exception& e)
   {
     Log(LogLevel::ERROR, "Unexpected error occurred: {}", e.what());
     return 1;
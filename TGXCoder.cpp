@@ -2,8 +2,17 @@
 
 #include "SHCResourceConverter.h"
 
+#include <algorithm>
+#include <bit>
+#include <charconv>
 #include <ostream>
 #include <memory>
+#include <stdexcept>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TGX_CODER_SSE2
+#include <emmintrin.h>
+#endif
 
 // TODO: maybe clean logical values? Many could be unsigned
 
@@ -125,24 +134,16 @@ TgxCoderResult analyzeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxAnalysis* tgxA
   return TgxCoderResult::SUCCESS;
 }
 
+// walks the pixel stream and hands every pixel run to the writer, which decides how the pixels are stored
+// the writer needs stream(targetIndex, source, count) and repeat(targetIndex, source, count), with source pointing to the first pixel
 // target needs to be able to fit the result, no safety for this case
-TgxCoderResult decodeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxCoderRawInfo* rawData, TgxAnalysis* tgxAnalysis)
+template<typename PixelWriter>
+static TgxCoderResult walkTgxStream(const TgxCoderTgxInfo* tgxData, const int rawWidth, const int rawX, const int rawY, PixelWriter& writer)
 {
-  if (!(tgxData && rawData))
-  {
-    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
-  }
-
-  // pre-scan, since this code is meant to be careful, not fast
-  const TgxCoderResult result{ analyzeTgxToRaw(tgxData, tgxAnalysis) };
-  if (result != TgxCoderResult::SUCCESS)
-  {
-    return result;
-  }
-  const bool indexedColor{ tgxData->colorType == TgxColorType::INDEXED };
+  const int pixelSize{ tgxData->colorType == TgxColorType::INDEXED ? 1 : 2 };
   // removed safety here, since scan happens before, target needs to be big enough, though
 
-  const int lineJump{ rawData->rawWidth - tgxData->tgxWidth };
+  const int lineJump{ rawWidth - tgxData->tgxWidth };
   if (lineJump < 0)
   {
     return TgxCoderResult::RAW_WIDTH_TOO_SMALL;
@@ -150,7 +151,7 @@ TgxCoderResult decodeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxCoderRawInfo* r
 
   int currentWidth{ 0 };
   int currentHeight{ 0 }; // only required to properly handle padding
-  int targetIndex{ rawData->rawX + rawData->rawWidth * rawData->rawY };
+  int targetIndex{ rawX + rawWidth * rawY };
   for (uint32_t sourceIndex{ 0 }; sourceIndex < tgxData->dataSize;)
   {
     const TgxStreamMarker marker{ static_cast<TgxStreamMarker>(tgxData->data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_MARKER) };
@@ -187,362 +188,1285 @@ TgxCoderResult decodeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxCoderRawInfo* r
     switch (marker)
     {
     case TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS:
-      if (indexedColor)
-      {
-        for (const int indexEnd{ targetIndex + pixelNumber }; targetIndex < indexEnd;)
-        {
-          rawData->data[targetIndex++] = FILLED_INDEXED_COLOR_ALPHA + tgxData->data[sourceIndex++];
-        }
-      }
-      else
-      {
-        memcpy(rawData->data + targetIndex, tgxData->data + sourceIndex, pixelNumber * 2);
-        sourceIndex += pixelNumber * 2;
-        targetIndex += pixelNumber;
-      }
+      writer.stream(targetIndex, tgxData->data + sourceIndex, pixelNumber);
+      sourceIndex += pixelNumber * pixelSize;
       break;
     case TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS:
-      if (indexedColor)
-      {
-        for (const int indexEnd{ targetIndex + pixelNumber }; targetIndex < indexEnd;)
-        {
-          rawData->data[targetIndex++] = FILLED_INDEXED_COLOR_ALPHA + tgxData->data[sourceIndex];
-        }
-        ++sourceIndex;
-      }
-      else
-      {
-        for (const int indexEnd{ targetIndex + pixelNumber }; targetIndex < indexEnd; ++targetIndex)
-        {
-          rawData->data[targetIndex] = *(uint16_t*) (tgxData->data + sourceIndex);
-        }
-        sourceIndex += 2;
-      }
+      writer.repeat(targetIndex, tgxData->data + sourceIndex, pixelNumber);
+      sourceIndex += pixelSize;
       break;
     case TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS:
-      targetIndex += pixelNumber;
       break;
     }
+    targetIndex += pixelNumber;
     currentWidth += pixelNumber;
   }
 
-  return result;
+  return TgxCoderResult::SUCCESS;
 }
 
-TgxCoderResult encodeRawToTgx(const TgxCoderRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction)
+TgxCoderResult decodeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxCoderRawInfo* rawData, TgxAnalysis* tgxAnalysis)
 {
-  if (!(rawData && tgxData && instruction))
+  if (!(tgxData && rawData))
   {
     return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
   }
 
-  const int lineJump{ rawData->rawWidth - tgxData->tgxWidth };
-  if (lineJump < 0)
+  // pre-scan, since this code is meant to be careful, not fast
+  const TgxCoderResult result{ analyzeTgxToRaw(tgxData, tgxAnalysis) };
+  if (result != TgxCoderResult::SUCCESS)
   {
-    return TgxCoderResult::RAW_WIDTH_TOO_SMALL;
+    return result;
   }
-  // indexed can work with the alpha form like normal, it just needs to cut out the higher order byte
-  const bool indexedColor{ tgxData->colorType == TgxColorType::INDEXED };
-
-  // TODO: test and clean up
 
-  uint32_t resultSize{ 0 };
-  int sourceIndex{ rawData->rawX + rawData->rawWidth * rawData->rawY };
-  int targetIndex{ 0 };
-  for (int yIndex{ 0 }; yIndex < tgxData->tgxHeight; ++yIndex)
+  if (tgxData->colorType == TgxColorType::INDEXED)
   {
-    for (int xIndex{ 0 }; xIndex < tgxData->tgxWidth;)
+    struct IndexedWriter
     {
-      int transparentPixelCount{ 0 };
-      while (xIndex < tgxData->tgxWidth && rawData->data[sourceIndex] == instruction->transparentPixelRawColor) // consume all transparency
-      {
-        ++transparentPixelCount;
-        ++xIndex;
-        ++sourceIndex;
-      }
+      uint16_t* target;
 
-      if (!indexedColor || xIndex < tgxData->tgxWidth) // if indexed and end of the line, short circuit to newline
+      void stream(const int targetIndex, const uint8_t* source, const int count)
       {
-        while (transparentPixelCount > 0)
+        for (int i{ 0 }; i < count; ++i)
         {
-          const int pixelThisBatch{ transparentPixelCount > MAX_PIXEL_PER_MARKER ? MAX_PIXEL_PER_MARKER : transparentPixelCount };
-          transparentPixelCount -= pixelThisBatch;
-
-          ++resultSize;
-          if (tgxData->data)
-          {
-            if (resultSize > tgxData->dataSize)
-            {
-              return TgxCoderResult::INVALID_TGX_DATA_SIZE;
-            }
-            tgxData->data[targetIndex++] = TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS | (pixelThisBatch - 1);
-          };
+          target[targetIndex + i] = FILLED_INDEXED_COLOR_ALPHA + source[i];
         }
       }
 
-      // TODO?: is there a special handling for the magenta transparent-marker color pixel, since the RGB transform ignores it, but only for stream pixels?
-      uint16_t pixelBuffer[MAX_PIXEL_PER_MARKER]{ 0 };
-      int count{ 0 };
-      int repeatingPixelCount{ 0 };
-      uint16_t repeatingPixel{ 0 };
-      while (xIndex < tgxData->tgxWidth && count < MAX_PIXEL_PER_MARKER)
+      void repeat(const int targetIndex, const uint8_t* source, const int count)
       {
-        uint16_t nextPixel{ rawData->data[sourceIndex] };
-        if (nextPixel == instruction->transparentPixelRawColor)
-        {
-          break;
-        }
-
-        // count all repeating pixels that can be considered this line, but check pixels of next lines for this decision
-        // TODO?: Is there a better approach to this? This loop always starts for every single pixel, even if it is not needed
-        // TODO: threshold > 32 would cause issues now
-        int tempXIndex{ xIndex };
-        int tempYIndex{ yIndex };
-        int tempSourceIndex{ sourceIndex };
-        int tempRepeatingPixelCount{ 0 };
-        while (true)
-        {
-          if (tempRepeatingPixelCount >= MAX_PIXEL_PER_MARKER)
-          {
-            repeatingPixelCount += MAX_PIXEL_PER_MARKER;
-            tempRepeatingPixelCount = 0;
-          }
-          if (tempYIndex != yIndex && tempRepeatingPixelCount >= instruction->pixelRepeatThreshold)
-          {
-            break; // if we reach next line and the threshold is reached, we can stop, since the next line starts new
-          }
-          if (tempXIndex >= tgxData->tgxWidth)
-          {
-            ++tempYIndex;
-            if (tempYIndex >= tgxData->tgxHeight)
-            {
-              break;
-            }
-            tempXIndex = 0;
-            tempSourceIndex += lineJump;
-          }
-          if (rawData->data[tempSourceIndex] != nextPixel)
-          {
-            break;
-          }
-          ++tempRepeatingPixelCount;
-          ++tempSourceIndex;
-          ++tempXIndex;
-        }
-        // if more then one batch, only add remaining pixel count if threshold is reached by them
-        if (repeatingPixelCount == 0 || tempRepeatingPixelCount >= instruction->pixelRepeatThreshold)
-        {
-          repeatingPixelCount += tempRepeatingPixelCount;
-        }
-        const bool reachedThreshold{ repeatingPixelCount >= instruction->pixelRepeatThreshold };
+        std::fill_n(target + targetIndex, count, static_cast<uint16_t>(FILLED_INDEXED_COLOR_ALPHA + *source));
+      }
+    } writer{ rawData->data };
+    return walkTgxStream(tgxData, rawData->rawWidth, rawData->rawX, rawData->rawY, writer);
+  }
 
-        // always fix number of pixels extend over line, since the number is used to know how many repeated pixels to write
-        const int remainingPixelCount{ tgxData->tgxWidth - xIndex };
-        if (remainingPixelCount < repeatingPixelCount)
-        {
-          repeatingPixelCount = remainingPixelCount;
-        }
+  struct ColorWriter
+  {
+    uint16_t* target;
 
-        if (reachedThreshold)
-        {
-          repeatingPixel = nextPixel;
-          break;
-        }
+    void stream(const int targetIndex, const uint8_t* source, const int count)
+    {
+      memcpy(target + targetIndex, source, count * 2);
+    }
 
-        // fix if repeating pixel not long enough for stream
-        int adjustPixel{ count + repeatingPixelCount };
-        if (adjustPixel > MAX_PIXEL_PER_MARKER)
-        {
-          adjustPixel = MAX_PIXEL_PER_MARKER;
-        }
+    void repeat(const int targetIndex, const uint8_t* source, const int count)
+    {
+      std::fill_n(target + targetIndex, count, *(uint16_t*) source);
+    }
+  } writer{ rawData->data };
+  return walkTgxStream(tgxData, rawData->rawWidth, rawData->rawX, rawData->rawY, writer);
+}
 
-        while (count < adjustPixel)
-        {
-          ++sourceIndex;
-          ++xIndex;
-          pixelBuffer[count++] = nextPixel;
-        }
-        repeatingPixelCount = 0;
-      }
+// lookup of a run of indices, unrolled since SSE2 has no gather and a 256 color table stays in the L1 cache anyway
+static void resolveIndexRun(const uint8_t* indices, const int count, const uint16_t* palette, uint16_t* target)
+{
+  int i{ 0 };
+  for (; i + 4 <= count; i += 4)
+  {
+    const uint16_t first{ palette[indices[i]] };
+    const uint16_t second{ palette[indices[i + 1]] };
+    const uint16_t third{ palette[indices[i + 2]] };
+    const uint16_t fourth{ palette[indices[i + 3]] };
+    target[i] = first;
+    target[i + 1] = second;
+    target[i + 2] = third;
+    target[i + 3] = fourth;
+  }
+  for (; i < count; ++i)
+  {
+    target[i] = palette[indices[i]];
+  }
+}
 
-      if (count > 0)
-      {
-        const int pixelSize{ indexedColor ? count : count * 2 };
-        resultSize += 1 + pixelSize;
-        if (tgxData->data)
-        {
-          if (resultSize > tgxData->dataSize)
-          {
-            return TgxCoderResult::INVALID_TGX_DATA_SIZE;
-          }
-          tgxData->data[targetIndex++] = TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS | (count - 1);
-          if (indexedColor)
-          {
-            for (int i{ 0 }; i < count; ++i)
-            {
-              tgxData->data[targetIndex++] = static_cast<uint8_t>(~FILLED_INDEXED_COLOR_ALPHA & pixelBuffer[i]);
-            }
-          }
-          else
-          {
-            memcpy(tgxData->data + targetIndex, pixelBuffer, pixelSize);
-            targetIndex += pixelSize;
-          }
-        }
-      }
+TgxCoderResult decodeIndexedTgxToPaletteRaw(const TgxCoderTgxInfo* tgxData, const TgxCoderPaletteRawInfo* rawData)
+{
+  if (!(tgxData && rawData && rawData->data && rawData->palettes))
+  {
+    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
+  }
+  if (tgxData->colorType != TgxColorType::INDEXED)
+  {
+    return TgxCoderResult::NOT_INDEXED_COLOR;
+  }
+  if (rawData->paletteCount <= 0)
+  {
+    return TgxCoderResult::INVALID_PALETTE_COUNT;
+  }
 
-      while (repeatingPixelCount > 0)
-      {
-        const int pixelThisBatch{ repeatingPixelCount > MAX_PIXEL_PER_MARKER ? MAX_PIXEL_PER_MARKER : repeatingPixelCount };
-        repeatingPixelCount -= pixelThisBatch;
+  const TgxCoderResult result{ analyzeTgxToRaw(tgxData, nullptr) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
 
-        // adjust indexes
-        xIndex += pixelThisBatch;
-        sourceIndex += pixelThisBatch;
+  // the pixel writes are done for every palette during the one walk over the stream
+  struct PaletteWriter
+  {
+    const TgxCoderPaletteRawInfo* rawData;
 
-        // add to data
-        resultSize += indexedColor ? 2 : 3;
-        if (tgxData->data)
-        {
-          if (resultSize > tgxData->dataSize)
-          {
-            return TgxCoderResult::INVALID_TGX_DATA_SIZE;
-          }
-          tgxData->data[targetIndex++] = TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS | (pixelThisBatch - 1);
-          if (indexedColor)
-          {
-            tgxData->data[targetIndex++] = static_cast<uint8_t>(~FILLED_INDEXED_COLOR_ALPHA & repeatingPixel);
-          }
-          else
-          {
-            *((uint16_t*) (tgxData->data + targetIndex)) = repeatingPixel;
-            targetIndex += 2;
-          }
-        }
+    void stream(const int targetIndex, const uint8_t* source, const int count)
+    {
+      for (int i{ 0 }; i < rawData->paletteCount; ++i)
+      {
+        resolveIndexRun(source, count, rawData->palettes[i], rawData->data[i] + targetIndex);
       }
     }
-    // line end
-    ++resultSize;
-    if (tgxData->data) {
-      if (resultSize > tgxData->dataSize)
+
+    void repeat(const int targetIndex, const uint8_t* source, const int count)
+    {
+      for (int i{ 0 }; i < rawData->paletteCount; ++i)
       {
-        return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+        std::fill_n(rawData->data[i] + targetIndex, count, rawData->palettes[i][*source]);
       }
-      tgxData->data[targetIndex++] = TgxStreamMarker::TGX_MARKER_NEWLINE;
-    };
-    sourceIndex += lineJump;
+    }
+  } writer{ rawData };
+  return walkTgxStream(tgxData, rawData->rawWidth, rawData->rawX, rawData->rawY, writer);
+}
+
+static void setMaskBits(uint8_t* mask, int start, int count)
+{
+  for (; count > 0 && (start & 7) != 0; ++start, --count)
+  {
+    mask[start >> 3] |= static_cast<uint8_t>(1 << (start & 7));
+  }
+  if (count >= 8)
+  {
+    memset(mask + (start >> 3), 0xff, count >> 3);
+    start += count & ~7;
+    count &= 7;
+  }
+  for (; count > 0; ++start, --count)
+  {
+    mask[start >> 3] |= static_cast<uint8_t>(1 << (start & 7));
   }
+}
 
-  const uint32_t reminder{ resultSize % instruction->paddingAlignment };
-  if (reminder > 0)
+TgxCoderResult decodeIndexedTgxToIndexedRaw(const TgxCoderTgxInfo* tgxData, TgxCoderIndexedRawInfo* rawData)
+{
+  if (!(tgxData && rawData && rawData->data && rawData->mask))
+  {
+    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
+  }
+  if (tgxData->colorType != TgxColorType::INDEXED)
+  {
+    return TgxCoderResult::NOT_INDEXED_COLOR;
+  }
+
+  const TgxCoderResult result{ analyzeTgxToRaw(tgxData, nullptr) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
+
+  struct IndexedMaskWriter
   {
-    const uint32_t requiredPadding{ instruction->paddingAlignment - reminder };
-    resultSize += requiredPadding;
-    if (tgxData->data)
+    TgxCoderIndexedRawInfo* rawData;
+
+    void stream(const int targetIndex, const uint8_t* source, const int count)
     {
-      if (resultSize > tgxData->dataSize)
-      {
-        return TgxCoderResult::INVALID_TGX_DATA_SIZE;
-      }
-      for (uint32_t i{ 0 }; i < requiredPadding; ++i)
-      {
-        tgxData->data[targetIndex++] = TgxStreamMarker::TGX_MARKER_NEWLINE;
-      }
+      memcpy(rawData->data + targetIndex, source, count);
+      setMaskBits(rawData->mask, targetIndex, count);
     }
-  }
 
-  tgxData->dataSize = resultSize;
-  return tgxData->data ? TgxCoderResult::SUCCESS : TgxCoderResult::FILLED_ENCODING_SIZE;
+    void repeat(const int targetIndex, const uint8_t* source, const int count)
+    {
+      memset(rawData->data + targetIndex, *source, count);
+      setMaskBits(rawData->mask, targetIndex, count);
+    }
+  } writer{ rawData };
+  return walkTgxStream(tgxData, rawData->rawWidth, rawData->rawX, rawData->rawY, writer);
 }
 
-const char* getTgxResultDescription(const TgxCoderResult result)
+// output of the encoder that only counts if no buffer is given, fails if the given buffer is too small
+struct TgxBufferOutput
 {
-  switch (result)
+  uint8_t* data;
+  uint32_t capacity;
+  uint32_t size;
+
+  // target is nullptr if the output only counts
+  bool reserve(const uint32_t count, uint8_t*& target)
   {
-  case TgxCoderResult::SUCCESS:
-    return "Coder completed successfully.";
-  case TgxCoderResult::FILLED_ENCODING_SIZE:
-    return "Dry run of encoder completed successfully. Encoding data size was filled into given struct.";
+    size += count;
+    if (!data)
+    {
+      target = nullptr;
+      return true;
+    }
+    if (size > capacity)
+    {
+      return false;
+    }
+    target = data + size - count;
+    return true;
+  }
+};
 
-  case TgxCoderResult::WIDTH_TOO_BIG:
-    return "Decoder encountered line with bigger width than said by meta data.";
-  case TgxCoderResult::HEIGHT_TOO_BIG:
-    return "Decoder encountered bigger height than said by meta data.";
-  case TgxCoderResult::UNKNOWN_MARKER:
-    return "Decoder encountered an unknown marker in the encoded data.";
-  case TgxCoderResult::INVALID_TGX_DATA_SIZE:
-    return "Decoder attempted to run beyond the given encoded data. Data likely invalid or incomplete.";
-  case TgxCoderResult::TGX_HAS_NOT_ENOUGH_PIXELS:
-    return "Decoder produced an image with less pixels than required by the dimensions requested by the meta data.";
-  case TgxCoderResult::RAW_WIDTH_TOO_SMALL:
-    return "Coder was given a raw image width that is not compatible with the other meta data.";
-  case TgxCoderResult::MISSING_REQUIRED_STRUCTS:
-    return "Coder was not given the structs required for de- or encoding.";
+// output of the encoder that grows a vector
+struct TgxVectorOutput
+{
+  std::vector<uint8_t>& data;
+  uint32_t& size;
 
-  default:
-    return "Encountered unknown decoder analysis result. This should not happen.";
+  bool reserve(const uint32_t count, uint8_t*& target)
+  {
+    size += count;
+    data.resize(data.size() + count);
+    target = data.data() + data.size() - count;
+    return true;
   }
-}
+};
 
-TgxCoderResult decodeTgxToText(const TgxCoderTgxInfo& tgxData, std::ostream& outStream)
+// output of the stream encoder that writes to caller memory and lets the caller grow it
+struct TgxGrowingOutput
 {
-  const TgxCoderResult result{ analyzeTgxToRaw(&tgxData, nullptr) };
-  if (result != TgxCoderResult::SUCCESS)
+  TgxStreamOutput& output;
+  uint32_t& size;
+
+  bool reserve(const uint32_t count, uint8_t*& target)
   {
-    return result;
+    if (count > UINT32_MAX - output.size)
+    {
+      return false;
+    }
+    if (output.size + count > output.capacity)
+    {
+      output.grow(output, output.size + count);
+    }
+    target = output.data + output.size;
+    output.size += count;
+    size += count;
+    return true;
   }
+};
+
+// encodes one line including the newline marker, sourceIndex is the index of the first pixel of the line
+// the repeating pixel lookahead might read pixels of the following lines, see getTgxEncoderLookaheadLines
+// the reader returns the pixel at an index of the raw canvas, with transparent pixels returned as the transparent raw color
+template<typename PixelReader, typename Output>
+static TgxCoderResult encodeTgxLine(const PixelReader& pixelAt, int sourceIndex, const int yIndex, const int lineJump,
+  const TgxCoderTgxInfo& tgxData, const TgxCoderInstruction& instruction, Output& output)
+{
+  // indexed can work with the alpha form like normal, it just needs to cut out the higher order byte
   const bool indexedColor{ tgxData.colorType == TgxColorType::INDEXED };
 
-  uint32_t sourceIndex{ 0 };
-  while (sourceIndex < tgxData.dataSize)
+  // TODO: test and clean up
+
+  uint8_t* target;
+  for (int xIndex{ 0 }; xIndex < tgxData.tgxWidth;)
   {
-    const TgxStreamMarker marker{ static_cast<TgxStreamMarker>(tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_MARKER) };
-    const int pixelNumber{ (tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_NUMBER) + 1 }; // 0 means one pixel, like an index
-    ++sourceIndex;
+    int transparentPixelCount{ 0 };
+    while (xIndex < tgxData.tgxWidth && pixelAt(sourceIndex) == instruction.transparentPixelRawColor) // consume all transparency
+    {
+      ++transparentPixelCount;
+      ++xIndex;
+      ++sourceIndex;
+    }
 
-    switch (marker)
+    if (!indexedColor || xIndex < tgxData.tgxWidth) // if indexed and end of the line, short circuit to newline
     {
-    case TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS:
-      std::print(outStream, "STREAM_PIXEL {}", pixelNumber);
-      if (indexedColor)
+      while (transparentPixelCount > 0)
       {
-        for (int i{ 0 }; i < pixelNumber; ++i)
+        const int pixelThisBatch{ transparentPixelCount > MAX_PIXEL_PER_MARKER ? MAX_PIXEL_PER_MARKER : transparentPixelCount };
+        transparentPixelCount -= pixelThisBatch;
+
+        if (!output.reserve(1, target))
+        {
+          return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+        }
+        if (target)
         {
-          std::print(outStream, " {:#04x}", *(uint8_t*) (tgxData.data + sourceIndex));
-          ++sourceIndex;
+          *target = TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS | (pixelThisBatch - 1);
         }
       }
-      else
+    }
+
+    // TODO?: is there a special handling for the magenta transparent-marker color pixel, since the RGB transform ignores it, but only for stream pixels?
+    uint16_t pixelBuffer[MAX_PIXEL_PER_MARKER]{ 0 };
+    int count{ 0 };
+    int repeatingPixelCount{ 0 };
+    uint16_t repeatingPixel{ 0 };
+    while (xIndex < tgxData.tgxWidth && count < MAX_PIXEL_PER_MARKER)
+    {
+      uint16_t nextPixel{ pixelAt(sourceIndex) };
+      if (nextPixel == instruction.transparentPixelRawColor)
+      {
+        break;
+      }
+
+      // count all repeating pixels that can be considered this line, but check pixels of next lines for this decision
+      // TODO?: Is there a better approach to this? This loop always starts for every single pixel, even if it is not needed
+      // TODO: threshold > 32 would cause issues now
+      int tempXIndex{ xIndex };
+      int tempYIndex{ yIndex };
+      int tempSourceIndex{ sourceIndex };
+      int tempRepeatingPixelCount{ 0 };
+      while (true)
       {
-        for (int i{ 0 }; i < pixelNumber * 2; i += 2)
+        if (tempRepeatingPixelCount >= MAX_PIXEL_PER_MARKER)
+        {
+          repeatingPixelCount += MAX_PIXEL_PER_MARKER;
+          tempRepeatingPixelCount = 0;
+        }
+        if (tempYIndex != yIndex && tempRepeatingPixelCount >= instruction.pixelRepeatThreshold)
         {
-          std::print(outStream, " {:#06x}", *(uint16_t*) (tgxData.data + sourceIndex));
-          sourceIndex += 2;
+          break; // if we reach next line and the threshold is reached, we can stop, since the next line starts new
+        }
+        if (tempXIndex >= tgxData.tgxWidth)
+        {
+          ++tempYIndex;
+          if (tempYIndex >= tgxData.tgxHeight)
+          {
+            break;
+          }
+          tempXIndex = 0;
+          tempSourceIndex += lineJump;
+        }
+        if (pixelAt(tempSourceIndex) != nextPixel)
+        {
+          break;
         }
+        ++tempRepeatingPixelCount;
+        ++tempSourceIndex;
+        ++tempXIndex;
       }
-      std::print(outStream, "\n");
-      break;
-    case TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS:
-      if (indexedColor)
+      // if more then one batch, only add remaining pixel count if threshold is reached by them
+      if (repeatingPixelCount == 0 || tempRepeatingPixelCount >= instruction.pixelRepeatThreshold)
       {
-        std::print(outStream, "REPEAT_PIXEL {} {:#04x}\n", pixelNumber, *(uint8_t*) (tgxData.data + sourceIndex));
-        ++sourceIndex;
+        repeatingPixelCount += tempRepeatingPixelCount;
       }
-      else
+      const bool reachedThreshold{ repeatingPixelCount >= instruction.pixelRepeatThreshold };
+
+      // always fix number of pixels extend over line, since the number is used to know how many repeated pixels to write
+      const int remainingPixelCount{ tgxData.tgxWidth - xIndex };
+      if (remainingPixelCount < repeatingPixelCount)
       {
-        std::print(outStream, "REPEAT_PIXEL {} {:#06x}\n", pixelNumber, *(uint16_t*) (tgxData.data + sourceIndex));
-        sourceIndex += 2;
+        repeatingPixelCount = remainingPixelCount;
       }
-      break;
-    case TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS:
-      std::print(outStream, "TRANSPARENT_PIXEL {}\n", pixelNumber);
-      break;
-    case TgxStreamMarker::TGX_MARKER_NEWLINE:
-      std::print(outStream, "NEWLINE {}\n", pixelNumber);
-      break;
-    default:
-      return TgxCoderResult::UNKNOWN_MARKER;
-    }
-  }
-  return TgxCoderResult::SUCCESS;
+
+      if (reachedThreshold)
+      {
+        repeatingPixel = nextPixel;
+        break;
+      }
+
+      // fix if repeating pixel not long enough for stream
+      int adjustPixel{ count + repeatingPixelCount };
+      if (adjustPixel > MAX_PIXEL_PER_MARKER)
+      {
+        adjustPixel = MAX_PIXEL_PER_MARKER;
+      }
+
+      while (count < adjustPixel)
+      {
+        ++sourceIndex;
+        ++xIndex;
+        pixelBuffer[count++] = nextPixel;
+      }
+      repeatingPixelCount = 0;
+    }
+
+    if (count > 0)
+    {
+      const int pixelSize{ indexedColor ? count : count * 2 };
+      if (!output.reserve(1 + pixelSize, target))
+      {
+        return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+      }
+      if (target)
+      {
+        *target++ = TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS | (count - 1);
+        if (indexedColor)
+        {
+          for (int i{ 0 }; i < count; ++i)
+          {
+            target[i] = static_cast<uint8_t>(~FILLED_INDEXED_COLOR_ALPHA & pixelBuffer[i]);
+          }
+        }
+        else
+        {
+          memcpy(target, pixelBuffer, pixelSize);
+        }
+      }
+    }
+
+    while (repeatingPixelCount > 0)
+    {
+      const int pixelThisBatch{ repeatingPixelCount > MAX_PIXEL_PER_MARKER ? MAX_PIXEL_PER_MARKER : repeatingPixelCount };
+      repeatingPixelCount -= pixelThisBatch;
+
+      // adjust indexes
+      xIndex += pixelThisBatch;
+      sourceIndex += pixelThisBatch;
+
+      // add to data
+      if (!output.reserve(indexedColor ? 2 : 3, target))
+      {
+        return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+      }
+      if (target)
+      {
+        *target++ = TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS | (pixelThisBatch - 1);
+        if (indexedColor)
+        {
+          *target = static_cast<uint8_t>(~FILLED_INDEXED_COLOR_ALPHA & repeatingPixel);
+        }
+        else
+        {
+          memcpy(target, &repeatingPixel, sizeof(repeatingPixel));
+        }
+      }
+    }
+  }
+  // line end
+  if (!output.reserve(1, target))
+  {
+    return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+  }
+  if (target)
+  {
+    *target = TgxStreamMarker::TGX_MARKER_NEWLINE;
+  }
+  return TgxCoderResult::SUCCESS;
+}
+
+template<typename Output>
+static TgxCoderResult encodeTgxPadding(const TgxCoderInstruction& instruction, Output& output)
+{
+  const uint32_t reminder{ output.size % instruction.paddingAlignment };
+  if (reminder == 0)
+  {
+    return TgxCoderResult::SUCCESS;
+  }
+  const uint32_t requiredPadding{ instruction.paddingAlignment - reminder };
+  uint8_t* target;
+  if (!output.reserve(requiredPadding, target))
+  {
+    return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+  }
+  if (target)
+  {
+    memset(target, TgxStreamMarker::TGX_MARKER_NEWLINE, requiredPadding);
+  }
+  return TgxCoderResult::SUCCESS;
+}
+
+template<typename PixelReader>
+static TgxCoderResult encodePixelsToTgx(const PixelReader& pixelAt, const int rawWidth, const int rawX, const int rawY, TgxCoderTgxInfo* tgxData,
+  const TgxCoderInstruction* instruction)
+{
+  const int lineJump{ rawWidth - tgxData->tgxWidth };
+  if (lineJump < 0)
+  {
+    return TgxCoderResult::RAW_WIDTH_TOO_SMALL;
+  }
+
+  TgxBufferOutput output{ .data{ tgxData->data }, .capacity{ tgxData->dataSize }, .size{ 0 } };
+  for (int yIndex{ 0 }; yIndex < tgxData->tgxHeight; ++yIndex)
+  {
+    const TgxCoderResult result{ encodeTgxLine(pixelAt, rawX + rawWidth * (rawY + yIndex), yIndex, lineJump, *tgxData, *instruction, output) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      return result;
+    }
+  }
+  const TgxCoderResult result{ encodeTgxPadding(*instruction, output) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
+
+  tgxData->dataSize = output.size;
+  return tgxData->data ? TgxCoderResult::SUCCESS : TgxCoderResult::FILLED_ENCODING_SIZE;
+}
+
+TgxCoderResult encodeRawToTgx(const TgxCoderRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction)
+{
+  if (!(rawData && tgxData && instruction))
+  {
+    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
+  }
+
+  const uint16_t* data{ rawData->data };
+  return encodePixelsToTgx([data](const int index) { return data[index]; }, rawData->rawWidth, rawData->rawX, rawData->rawY, tgxData, instruction);
+}
+
+TgxCoderResult encodeIndexedRawToTgx(const TgxCoderIndexedRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction)
+{
+  if (!(rawData && rawData->data && rawData->mask && tgxData && instruction))
+  {
+    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
+  }
+  if (tgxData->colorType != TgxColorType::INDEXED)
+  {
+    return TgxCoderResult::NOT_INDEXED_COLOR;
+  }
+
+  // presents the pixels in the form the indexed 16 bit canvas uses, so the encoder decisions stay the same
+  const uint8_t* data{ rawData->data };
+  const uint8_t* mask{ rawData->mask };
+  const uint16_t transparentPixel{ instruction->transparentPixelRawColor };
+  return encodePixelsToTgx([data, mask, transparentPixel](const int index)
+    {
+      return (mask[index >> 3] >> (index & 7)) & 1 ? static_cast<uint16_t>(FILLED_INDEXED_COLOR_ALPHA + data[index]) : transparentPixel;
+    }, rawData->rawWidth, rawData->rawX, rawData->rawY, tgxData, instruction);
+}
+
+/* SIZE PREDICTION */
+
+// returns the index of the first pixel from start on that is not the given pixel, or end
+static int findRunEnd(const uint16_t* line, int start, const int end, const uint16_t pixel)
+{
+  // most runs are short, so the first pixel is checked before the vector loop
+  if (start >= end || line[start] != pixel)
+  {
+    return start;
+  }
+  ++start;
+#ifdef TGX_CODER_SSE2
+  const __m128i pattern{ _mm_set1_epi16(static_cast<short>(pixel)) };
+  for (; start + 8 <= end; start += 8)
+  {
+    const int equalMask{ _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(line + start)), pattern)) };
+    if (equalMask != 0xffff)
+    {
+      return start + (std::countr_one(static_cast<unsigned int>(equalMask)) >> 1);
+    }
+  }
+#endif
+  while (start < end && line[start] == pixel)
+  {
+    ++start;
+  }
+  return start;
+}
+
+#ifdef TGX_CODER_SSE2
+// counts the leading pixels of the eight that are neither transparent nor equal to their right neighbour, requires nine readable pixels
+static int countSinglePixels(const uint16_t* pixels, const uint16_t transparentPixel)
+{
+  const __m128i current{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)) };
+  const __m128i next{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 1)) };
+  const __m128i stopMask{ _mm_or_si128(_mm_cmpeq_epi16(current, next), _mm_cmpeq_epi16(current, _mm_set1_epi16(static_cast<short>(transparentPixel)))) };
+  return std::countr_zero(static_cast<unsigned int>(_mm_movemask_epi8(stopMask)) | 0x10000u) >> 1;
+}
+#endif
+
+// repeating pixel count the encoder decides on for a run of the pixel starting at xIndex with runLength pixels in this line
+// mirrors the lookahead of the encoder, including the reset after every full marker and the lines it checks after a run that reaches the line end
+static int predictRepeatingPixelCount(const TgxCoderRawInfo& rawData, const TgxCoderTgxInfo& tgxData, const int threshold, const int yIndex,
+  const int xIndex, const int runLength, const uint16_t pixel)
+{
+  const int fullMarkerCount{ runLength / MAX_PIXEL_PER_MARKER };
+  int repeatingPixelCount{ fullMarkerCount * MAX_PIXEL_PER_MARKER };
+  int tempRepeatingPixelCount{ runLength % MAX_PIXEL_PER_MARKER };
+  if (xIndex + runLength >= tgxData.tgxWidth)
+  {
+    for (int tempYIndex{ yIndex + 1 }; tempYIndex < tgxData.tgxHeight; ++tempYIndex)
+    {
+      const uint16_t* line{ rawData.data + rawData.rawX + static_cast<size_t>(rawData.rawWidth) * (rawData.rawY + tempYIndex) };
+      if (threshold >= MAX_PIXEL_PER_MARKER)
+      {
+        // the threshold is never reached before the reset, so only the end of the run stops the lookahead
+        const int matchedPixelCount{ findRunEnd(line, 0, tgxData.tgxWidth, pixel) };
+        const int combinedPixelCount{ tempRepeatingPixelCount + matchedPixelCount };
+        repeatingPixelCount += combinedPixelCount / MAX_PIXEL_PER_MARKER * MAX_PIXEL_PER_MARKER;
+        tempRepeatingPixelCount = combinedPixelCount % MAX_PIXEL_PER_MARKER;
+        if (matchedPixelCount < tgxData.tgxWidth)
+        {
+          break;
+        }
+        continue;
+      }
+
+      // short, since the threshold stops the lookahead in at most two markers
+      int tempXIndex{ 0 };
+      bool thresholdReached{ false };
+      while (tempXIndex < tgxData.tgxWidth && line[tempXIndex] == pixel)
+      {
+        ++tempRepeatingPixelCount;
+        ++tempXIndex;
+        if (tempRepeatingPixelCount >= MAX_PIXEL_PER_MARKER)
+        {
+          repeatingPixelCount += MAX_PIXEL_PER_MARKER;
+          tempRepeatingPixelCount = 0;
+        }
+        if (tempRepeatingPixelCount >= threshold)
+        {
+          thresholdReached = true;
+          break;
+        }
+      }
+      if (thresholdReached || tempXIndex < tgxData.tgxWidth)
+      {
+        break;
+      }
+    }
+  }
+  if (repeatingPixelCount == 0 || tempRepeatingPixelCount >= threshold)
+  {
+    repeatingPixelCount += tempRepeatingPixelCount;
+  }
+  return repeatingPixelCount;
+}
+
+static int getMarkerCount(const int pixelCount)
+{
+  return (pixelCount + MAX_PIXEL_PER_MARKER - 1) / MAX_PIXEL_PER_MARKER;
+}
+
+TgxCoderResult predictRawToTgxSize(const TgxCoderRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction)
+{
+  if (!(rawData && tgxData && instruction))
+  {
+    return TgxCoderResult::MISSING_REQUIRED_STRUCTS;
+  }
+  if (rawData->rawWidth < tgxData->tgxWidth)
+  {
+    return TgxCoderResult::RAW_WIDTH_TOO_SMALL;
+  }
+  const bool indexedColor{ tgxData->colorType == TgxColorType::INDEXED };
+  const uint32_t pixelSize{ indexedColor ? 1u : 2u };
+  const int threshold{ instruction->pixelRepeatThreshold };
+  const int width{ tgxData->tgxWidth };
+
+  // walks the runs of every line with the decisions of the encoder, but only sums the marker sizes
+  uint64_t resultSize{ 0 };
+  for (int yIndex{ 0 }; yIndex < tgxData->tgxHeight; ++yIndex)
+  {
+    const uint16_t* line{ rawData->data + rawData->rawX + static_cast<size_t>(rawData->rawWidth) * (rawData->rawY + yIndex) };
+    int xIndex{ 0 };
+    while (xIndex < width)
+    {
+      const int transparentEnd{ findRunEnd(line, xIndex, width, instruction->transparentPixelRawColor) };
+      if (!indexedColor || transparentEnd < width) // indexed lines end without the trailing transparency
+      {
+        resultSize += getMarkerCount(transparentEnd - xIndex);
+      }
+      xIndex = transparentEnd;
+
+      int count{ 0 };
+      int repeatingPixelCount{ 0 };
+      while (xIndex < width && count < MAX_PIXEL_PER_MARKER)
+      {
+#ifdef TGX_CODER_SSE2
+        // pixels with a run of one that does not reach the line end always extend the stream if the threshold is above one
+        if (threshold > 1 && xIndex + 9 <= width)
+        {
+          const int singlePixelCount{ std::min(countSinglePixels(line + xIndex, instruction->transparentPixelRawColor), MAX_PIXEL_PER_MARKER - count) };
+          if (singlePixelCount > 0)
+          {
+            count += singlePixelCount;
+            xIndex += singlePixelCount;
+            continue;
+          }
+        }
+#endif
+        const uint16_t pixel{ line[xIndex] };
+        if (pixel == instruction->transparentPixelRawColor)
+        {
+          break;
+        }
+        const int runLength{ findRunEnd(line, xIndex + 1, width, pixel) - xIndex };
+        const int candidateCount{ runLength < MAX_PIXEL_PER_MARKER && xIndex + runLength < width
+          ? runLength : predictRepeatingPixelCount(*rawData, *tgxData, threshold, yIndex, xIndex, runLength, pixel) };
+        if (candidateCount >= threshold)
+        {
+          repeatingPixelCount = std::min(candidateCount, width - xIndex);
+          break;
+        }
+        const int streamedPixelCount{ std::min(count + std::min(candidateCount, width - xIndex), MAX_PIXEL_PER_MARKER) - count };
+        count += streamedPixelCount;
+        xIndex += streamedPixelCount;
+      }
+
+      if (count > 0)
+      {
+        resultSize += 1 + count * pixelSize;
+      }
+      resultSize += static_cast<uint64_t>(getMarkerCount(repeatingPixelCount)) * (1 + pixelSize);
+      xIndex += repeatingPixelCount;
+    }
+    ++resultSize; // newline
+  }
+
+  const uint32_t reminder{ static_cast<uint32_t>(resultSize % instruction->paddingAlignment) };
+  if (reminder > 0)
+  {
+    resultSize += instruction->paddingAlignment - reminder;
+  }
+  if (resultSize > UINT32_MAX)
+  {
+    return TgxCoderResult::INVALID_TGX_DATA_SIZE;
+  }
+  tgxData->dataSize = static_cast<uint32_t>(resultSize);
+  return TgxCoderResult::FILLED_ENCODING_SIZE;
+}
+
+const char* getTgxResultDescription(const TgxCoderResult result)
+{
+  switch (result)
+  {
+  case TgxCoderResult::SUCCESS:
+    return "Coder completed successfully.";
+  case TgxCoderResult::FILLED_ENCODING_SIZE:
+    return "Dry run of encoder completed successfully. Encoding data size was filled into given struct.";
+
+  case TgxCoderResult::WIDTH_TOO_BIG:
+    return "Decoder encountered line with bigger width than said by meta data.";
+  case TgxCoderResult::HEIGHT_TOO_BIG:
+    return "Decoder encountered bigger height than said by meta data.";
+  case TgxCoderResult::UNKNOWN_MARKER:
+    return "Decoder encountered an unknown marker in the encoded data.";
+  case TgxCoderResult::INVALID_TGX_DATA_SIZE:
+    return "Decoder attempted to run beyond the given encoded data. Data likely invalid or incomplete.";
+  case TgxCoderResult::TGX_HAS_NOT_ENOUGH_PIXELS:
+    return "Decoder produced an image with less pixels than required by the dimensions requested by the meta data.";
+  case TgxCoderResult::RAW_WIDTH_TOO_SMALL:
+    return "Coder was given a raw image width that is not compatible with the other meta data.";
+  case TgxCoderResult::MISSING_REQUIRED_STRUCTS:
+    return "Coder was not given the structs required for de- or encoding.";
+  case TgxCoderResult::NOT_INDEXED_COLOR:
+    return "Palette decoder was given TGX data that does not use indexed color.";
+  case TgxCoderResult::INVALID_PALETTE_COUNT:
+    return "Palette decoder was given no palettes.";
+  case TgxCoderResult::RAW_PIXEL_COUNT_MISMATCH:
+    return "Stream encoder was given a different number of pixels than required by the TGX dimensions.";
+
+  default:
+    return "Encountered unknown decoder analysis result. This should not happen.";
+  }
+}
+
+
+/* TEXT DISASSEMBLER */
+
+// text is collected in a buffer that every thread reuses and written to the stream in large blocks
+class TgxTextOutput
+{
+private:
+  static constexpr size_t BUFFER_SIZE{ 256 * 1024 };
+  static constexpr size_t MAX_ENTRY_SIZE{ 512 }; // a marker with 32 pixels of 16 bit values needs less than 300 chars
+
+  std::ostream& outStream;
+  std::vector<char>& buffer;
+  char* current;
+  char* flushLimit;
+
+  static std::vector<char>& getThreadBuffer()
+  {
+    thread_local std::vector<char> threadBuffer(BUFFER_SIZE);
+    return threadBuffer;
+  }
+
+public:
+  explicit TgxTextOutput(std::ostream& outStream) : outStream{ outStream }, buffer{ getThreadBuffer() },
+    current{ buffer.data() }, flushLimit{ buffer.data() + BUFFER_SIZE - MAX_ENTRY_SIZE } {}
+
+  TgxTextOutput(const TgxTextOutput&) = delete;
+  TgxTextOutput& operator=(const TgxTextOutput&) = delete;
+
+  ~TgxTextOutput()
+  {
+    flush();
+  }
+
+  // needs to be called before every entry, so one entry never overflows the buffer
+  void reserveEntry()
+  {
+    if (current > flushLimit)
+    {
+      flush();
+    }
+  }
+
+  void flush()
+  {
+    outStream.write(buffer.data(), current - buffer.data());
+    current = buffer.data();
+  }
+
+  void append(const std::string_view text)
+  {
+    current = std::copy(text.begin(), text.end(), current);
+  }
+
+  void appendChar(const char character)
+  {
+    *current++ = character;
+  }
+
+  void appendNumber(const uint32_t number)
+  {
+    current = std::to_chars(current, current + 10, number).ptr;
+  }
+
+  // fixed width hex with prefix, like "{:#06x}" for 16 bit and "{:#04x}" for 8 bit
+  template<typename T>
+  void appendHex(const T value)
+  {
+    static constexpr char HEX_DIGITS[]{ "0123456789abcdef" };
+    *current++ = '0';
+    *current++ = 'x';
+    for (int shift{ sizeof(T) * 8 - 4 }; shift >= 0; shift -= 4)
+    {
+      *current++ = HEX_DIGITS[(value >> shift) & 0xf];
+    }
+  }
+};
+
+static uint16_t readTgxTextPixel(const TgxCoderTgxInfo& tgxData, const uint32_t sourceIndex)
+{
+  if (tgxData.colorType == TgxColorType::INDEXED)
+  {
+    return tgxData.data[sourceIndex];
+  }
+  uint16_t pixel;
+  memcpy(&pixel, tgxData.data + sourceIndex, sizeof(uint16_t));
+  return pixel;
+}
+
+static void appendTgxTextPixel(TgxTextOutput& output, const bool indexedColor, const uint16_t pixel)
+{
+  if (indexedColor)
+  {
+    output.appendHex(static_cast<uint8_t>(pixel));
+  }
+  else
+  {
+    output.appendHex(pixel);
+  }
+}
+
+// one line per marker with all pixel values
+static TgxCoderResult decodeTgxToMarkerText(const TgxCoderTgxInfo& tgxData, TgxTextOutput& output)
+{
+  const bool indexedColor{ tgxData.colorType == TgxColorType::INDEXED };
+  const uint32_t pixelSize{ indexedColor ? 1u : 2u };
+
+  uint32_t sourceIndex{ 0 };
+  while (sourceIndex < tgxData.dataSize)
+  {
+    const TgxStreamMarker marker{ static_cast<TgxStreamMarker>(tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_MARKER) };
+    const int pixelNumber{ (tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_NUMBER) + 1 }; // 0 means one pixel, like an index
+    ++sourceIndex;
+
+    output.reserveEntry();
+    switch (marker)
+    {
+    case TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS:
+      output.append("STREAM_PIXEL ");
+      output.appendNumber(pixelNumber);
+      for (int i{ 0 }; i < pixelNumber; ++i)
+      {
+        output.appendChar(' ');
+        appendTgxTextPixel(output, indexedColor, readTgxTextPixel(tgxData, sourceIndex));
+        sourceIndex += pixelSize;
+      }
+      break;
+    case TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS:
+      output.append("REPEAT_PIXEL ");
+      output.appendNumber(pixelNumber);
+      output.appendChar(' ');
+      appendTgxTextPixel(output, indexedColor, readTgxTextPixel(tgxData, sourceIndex));
+      sourceIndex += pixelSize;
+      break;
+    case TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS:
+      output.append("TRANSPARENT_PIXEL ");
+      output.appendNumber(pixelNumber);
+      break;
+    case TgxStreamMarker::TGX_MARKER_NEWLINE:
+      output.append("NEWLINE ");
+      output.appendNumber(pixelNumber);
+      break;
+    default:
+      return TgxCoderResult::UNKNOWN_MARKER;
+    }
+    output.appendChar('\n');
+  }
+  return TgxCoderResult::SUCCESS;
+}
+
+// one line per row, the runs are summarized as "T<count>" for transparent pixels, "S<count>" for pixel streams and
+// "R<count>:<color>" for repeating pixels, followed by the encoded bytes of the row
+// rows that end without newline marker are flagged, the newline markers after the last row are summed up as padding
+static TgxCoderResult decodeTgxToRowText(const TgxCoderTgxInfo& tgxData, TgxTextOutput& output)
+{
+  const bool indexedColor{ tgxData.colorType == TgxColorType::INDEXED };
+  const uint32_t pixelSize{ indexedColor ? 1u : 2u };
+
+  int currentWidth{ 0 };
+  int currentRow{ 0 };
+  bool rowStarted{ false };
+  uint32_t rowBytes{ 0 };
+  uint32_t paddingCount{ 0 };
+  const auto startRow{ [&]()
+    {
+      if (!rowStarted)
+      {
+        output.append("ROW ");
+        output.appendNumber(currentRow);
+        output.appendChar(':');
+        rowStarted = true;
+      }
+    }
+  };
+  const auto finishRow{ [&](const bool newlineMarker)
+    {
+      output.reserveEntry();
+      startRow();
+      if (!newlineMarker)
+      {
+        output.append(" NO_NEWLINE");
+      }
+      output.append(" (");
+      output.appendNumber(rowBytes);
+      output.append(" bytes)\n");
+      currentWidth = 0;
+      ++currentRow;
+      rowStarted = false;
+      rowBytes = 0;
+    }
+  };
+
+  uint32_t sourceIndex{ 0 };
+  while (sourceIndex < tgxData.dataSize)
+  {
+    const TgxStreamMarker marker{ static_cast<TgxStreamMarker>(tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_MARKER) };
+    const int pixelNumber{ (tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_NUMBER) + 1 };
+    ++sourceIndex;
+
+    if (marker == TgxStreamMarker::TGX_MARKER_NEWLINE)
+    {
+      if (currentWidth <= 0 && currentRow == tgxData.tgxHeight)
+      {
+        ++paddingCount;
+        continue;
+      }
+      ++rowBytes;
+      finishRow(true);
+      continue;
+    }
+    if (currentWidth == tgxData.tgxWidth)
+    {
+      finishRow(false);
+    }
+
+    output.reserveEntry();
+    startRow();
+    uint32_t markerBytes{ 1 };
+    switch (marker)
+    {
+    case TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS:
+      output.append(" S");
+      output.appendNumber(pixelNumber);
+      markerBytes += pixelNumber * pixelSize;
+      break;
+    case TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS:
+      output.append(" R");
+      output.appendNumber(pixelNumber);
+      output.appendChar(':');
+      appendTgxTextPixel(output, indexedColor, readTgxTextPixel(tgxData, sourceIndex));
+      markerBytes += pixelSize;
+      break;
+    case TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS:
+      output.append(" T");
+      output.appendNumber(pixelNumber);
+      break;
+    default:
+      return TgxCoderResult::UNKNOWN_MARKER;
+    }
+    sourceIndex += markerBytes - 1;
+    rowBytes += markerBytes;
+    currentWidth += pixelNumber;
+  }
+  if (currentWidth > 0)
+  {
+    finishRow(false);
+  }
+  if (paddingCount > 0)
+  {
+    output.reserveEntry();
+    output.append("PADDING ");
+    output.appendNumber(paddingCount);
+    output.appendChar('\n');
+  }
+  return TgxCoderResult::SUCCESS;
+}
+
+TgxCoderResult decodeTgxToText(const TgxCoderTgxInfo& tgxData, std::ostream& outStream, const TgxTextMode textMode)
+{
+  const TgxCoderResult result{ analyzeTgxToRaw(&tgxData, nullptr) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
+
+  TgxTextOutput output{ outStream };
+  switch (textMode)
+  {
+  case TgxTextMode::NONE:
+    return TgxCoderResult::SUCCESS;
+  case TgxTextMode::ROWS:
+    return decodeTgxToRowText(tgxData, output);
+  default:
+    return decodeTgxToMarkerText(tgxData, output);
+  }
+}
+
+TgxTextMode tgxTextModeFromStr(const std::string& str)
+{
+  if (str == "rows")
+  {
+    return TgxTextMode::ROWS;
+  }
+  if (str == "markers" || str == "true" || str == "1")
+  {
+    return TgxTextMode::MARKERS;
+  }
+  if (str == "false" || str == "0")
+  {
+    return TgxTextMode::NONE;
+  }
+  throw std::invalid_argument("Unable to convert string to TGX text mode.");
+}
+
+
+/* DETAILED ANALYSIS */
+
+// compares the ratios of encoded to raw bytes without a division
+static bool isWorseRow(const uint32_t encodedBytes, const uint32_t rawBytes, const uint32_t otherEncodedBytes, const uint32_t otherRawBytes)
+{
+  return static_cast<uint64_t>(encodedBytes) * otherRawBytes > static_cast<uint64_t>(otherEncodedBytes) * rawBytes;
+}
+
+TgxCoderResult analyzeTgxDetailed(const TgxCoderTgxInfo& tgxData, TgxDetailedAnalysis& analysis)
+{
+  const TgxCoderResult result{ analyzeTgxToRaw(&tgxData, nullptr) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
+  const uint32_t pixelSize{ tgxData.colorType == TgxColorType::INDEXED ? 1u : 2u };
+  const uint32_t rowRawBytes{ static_cast<uint32_t>(tgxData.tgxWidth) * pixelSize };
+
+  analysis = {};
+  analysis.imageCount = 1;
+  analysis.rawBytes = static_cast<uint64_t>(rowRawBytes) * tgxData.tgxHeight;
+  analysis.encodedBytes = tgxData.dataSize;
+
+  int currentWidth{ 0 };
+  int currentRow{ 0 };
+  uint32_t rowBytes{ 0 };
+  const auto finishRow{ [&]()
+    {
+      if (rowRawBytes > 0 && (analysis.worstRow < 0 || isWorseRow(rowBytes, rowRawBytes, analysis.worstRowEncodedBytes, analysis.worstRowRawBytes)))
+      {
+        analysis.worstRow = currentRow;
+        analysis.worstRowEncodedBytes = rowBytes;
+        analysis.worstRowRawBytes = rowRawBytes;
+      }
+      currentWidth = 0;
+      ++currentRow;
+      rowBytes = 0;
+    }
+  };
+
+  // the structure was validated by the analysis above, so this only follows the same rules
+  uint32_t sourceIndex{ 0 };
+  while (sourceIndex < tgxData.dataSize)
+  {
+    const TgxStreamMarker marker{ static_cast<TgxStreamMarker>(tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_MARKER) };
+    const int pixelNumber{ (tgxData.data[sourceIndex] & TgxStreamMarker::TGX_PIXEL_NUMBER) + 1 };
+    ++sourceIndex;
+
+    if (marker == TgxStreamMarker::TGX_MARKER_NEWLINE)
+    {
+      if (currentWidth <= 0 && currentRow == tgxData.tgxHeight)
+      {
+        ++analysis.paddingBytes;
+        continue;
+      }
+      ++analysis.newlineBytes;
+      ++rowBytes;
+      finishRow();
+      continue;
+    }
+    if (currentWidth == tgxData.tgxWidth)
+    {
+      finishRow(); // line without newline marker
+    }
+
+    uint32_t markerBytes{ 1 };
+    switch (marker)
+    {
+    case TgxStreamMarker::TGX_MARKER_STREAM_OF_PIXELS:
+      markerBytes += pixelNumber * pixelSize;
+      analysis.pixelStreamBytes += markerBytes;
+      ++analysis.pixelStreamHistogram[pixelNumber - 1];
+      break;
+    case TgxStreamMarker::TGX_MARKER_REPEATING_PIXELS:
+      markerBytes += pixelSize;
+      analysis.repeatingPixelsBytes += markerBytes;
+      ++analysis.repeatingPixelsHistogram[pixelNumber - 1];
+      break;
+    case TgxStreamMarker::TGX_MARKER_TRANSPARENT_PIXELS:
+      analysis.transparentBytes += markerBytes;
+      ++analysis.transparentHistogram[pixelNumber - 1];
+      break;
+    default:
+      return TgxCoderResult::UNKNOWN_MARKER;
+    }
+    sourceIndex += markerBytes - 1;
+    rowBytes += markerBytes;
+    currentWidth += pixelNumber;
+  }
+  if (currentWidth > 0)
+  {
+    finishRow(); // last line without newline marker
+  }
+  return TgxCoderResult::SUCCESS;
+}
+
+void addTgxDetailedAnalysis(TgxDetailedAnalysis& target, const TgxDetailedAnalysis& source)
+{
+  target.imageCount += source.imageCount;
+  target.rawBytes += source.rawBytes;
+  target.encodedBytes += source.encodedBytes;
+  target.pixelStreamBytes += source.pixelStreamBytes;
+  target.transparentBytes += source.transparentBytes;
+  target.repeatingPixelsBytes += source.repeatingPixelsBytes;
+  target.newlineBytes += source.newlineBytes;
+  target.paddingBytes += source.paddingBytes;
+  for (int i{ 0 }; i < TGX_MARKER_HISTOGRAM_SIZE; ++i)
+  {
+    target.pixelStreamHistogram[i] += source.pixelStreamHistogram[i];
+    target.transparentHistogram[i] += source.transparentHistogram[i];
+    target.repeatingPixelsHistogram[i] += source.repeatingPixelsHistogram[i];
+  }
+  if (source.worstRow >= 0 && (target.worstRow < 0
+    || isWorseRow(source.worstRowEncodedBytes, source.worstRowRawBytes, target.worstRowEncodedBytes, target.worstRowRawBytes)))
+  {
+    target.worstRowSource = source.worstRowSource;
+    target.worstRow = source.worstRow;
+    target.worstRowEncodedBytes = source.worstRowEncodedBytes;
+    target.worstRowRawBytes = source.worstRowRawBytes;
+  }
+}
+
+
+/* STREAM ENCODER */
+
+// the lookahead stops in a following line once the threshold is reached, but a threshold of a full marker resets before that
+// the count can also reset on the first pixel of the next line, so the lookahead reads up to threshold + 1 pixels after a line
+static int getTgxEncoderLookaheadLines(const TgxCoderTgxInfo& tgxData, const TgxCoderInstruction& instruction)
+{
+  if (tgxData.tgxWidth <= 0 || tgxData.tgxHeight <= 0)
+  {
+    return 0;
+  }
+  if (instruction.pixelRepeatThreshold >= MAX_PIXEL_PER_MARKER)
+  {
+    return tgxData.tgxHeight - 1;
+  }
+  const int lookaheadPixels{ std::max(instruction.pixelRepeatThreshold, 0) + 1 };
+  return std::min((lookaheadPixels + tgxData.tgxWidth - 1) / tgxData.tgxWidth, tgxData.tgxHeight - 1);
+}
+
+TgxStreamEncoder::TgxStreamEncoder(const TgxCoderTgxInfo& tgxInfo, const TgxCoderInstruction& instruction)
+  : tgxInfo{ tgxInfo }, instruction{ instruction }, lookaheadLines{ getTgxEncoderLookaheadLines(tgxInfo, instruction) }, pendingPixels{},
+  nextLine{ 0 }, receivedPixelCount{ 0 }, encodedSize{ 0 }
+{
+  this->tgxInfo.data = nullptr;
+}
+
+int TgxStreamEncoder::getLookaheadLines() const
+{
+  return lookaheadLines;
+}
+
+uint32_t TgxStreamEncoder::getEncodedSize() const
+{
+  return encodedSize;
+}
+
+template<typename Output>
+TgxCoderResult TgxStreamEncoder::encodeLines(const int lineCount, Output& output)
+{
+  const uint16_t* data{ pendingPixels.data() };
+  for (int line{ 0 }; line < lineCount; ++line)
+  {
+    const TgxCoderResult result{ encodeTgxLine([data](const int index) { return data[index]; }, line * tgxInfo.tgxWidth, nextLine + line, 0,
+      tgxInfo, instruction, output) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      return result;
+    }
+  }
+  nextLine += lineCount;
+  pendingPixels.erase(pendingPixels.begin(), pendingPixels.begin() + static_cast<size_t>(lineCount) * tgxInfo.tgxWidth);
+  return TgxCoderResult::SUCCESS;
+}
+
+template<typename Output>
+TgxCoderResult TgxStreamEncoder::pushPixels(std::span<const uint16_t> pixels, Output& output)
+{
+  const size_t requiredPixelCount{ static_cast<size_t>(std::max(tgxInfo.tgxWidth, 0)) * std::max(tgxInfo.tgxHeight, 0) };
+  if (pixels.size() > requiredPixelCount - receivedPixelCount)
+  {
+    return TgxCoderResult::RAW_PIXEL_COUNT_MISMATCH;
+  }
+  receivedPixelCount += pixels.size();
+  pendingPixels.insert(pendingPixels.end(), pixels.begin(), pixels.end());
+  if (tgxInfo.tgxWidth <= 0)
+  {
+    return TgxCoderResult::SUCCESS; // lines without pixels are encoded by finish
+  }
+
+  // a line can be encoded once its lookahead lines are complete or the lookahead would reach beyond the image
+  const int completeLines{ static_cast<int>(pendingPixels.size() / tgxInfo.tgxWidth) };
+  const int linesWithLookahead{ std::max(completeLines - lookaheadLines, 0) };
+  const int linesBeforeEnd{ nextLine + completeLines == tgxInfo.tgxHeight ? completeLines : 0 };
+  return encodeLines(std::max(linesWithLookahead, linesBeforeEnd), output);
+}
+
+template<typename Output>
+TgxCoderResult TgxStreamEncoder::finishPixels(Output& output)
+{
+  const size_t requiredPixelCount{ static_cast<size_t>(std::max(tgxInfo.tgxWidth, 0)) * std::max(tgxInfo.tgxHeight, 0) };
+  if (receivedPixelCount != requiredPixelCount)
+  {
+    return TgxCoderResult::RAW_PIXEL_COUNT_MISMATCH;
+  }
+  const TgxCoderResult result{ encodeLines(std::max(tgxInfo.tgxHeight, 0) - nextLine, output) };
+  if (result != TgxCoderResult::SUCCESS)
+  {
+    return result;
+  }
+  return encodeTgxPadding(instruction, output);
+}
+
+TgxCoderResult TgxStreamEncoder::push(std::span<const uint16_t> pixels, std::vector<uint8_t>& out)
+{
+  TgxVectorOutput output{ .data{ out }, .size{ encodedSize } };
+  return pushPixels(pixels, output);
+}
+
+TgxCoderResult TgxStreamEncoder::push(std::span<const uint16_t> pixels, TgxStreamOutput& out)
+{
+  TgxGrowingOutput output{ .output{ out }, .size{ encodedSize } };
+  return pushPixels(pixels, output);
+}
+
+TgxCoderResult TgxStreamEncoder::finish(std::vector<uint8_t>& out)
+{
+  TgxVectorOutput output{ .data{ out }, .size{ encodedSize } };
+  return finishPixels(output);
+}
+
+TgxCoderResult TgxStreamEncoder::finish(TgxStreamOutput& out)
+{
+  TgxGrowingOutput output{ .output{ out }, .size{ encodedSize } };
+  return finishPixels(output);
 }
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
 #include <format>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
 
 enum class TgxCoderResult : int32_t
 {
@@ -14,6 +19,9 @@ enum class TgxCoderResult : int32_t
   INVALID_TGX_DATA_SIZE,
   TGX_HAS_NOT_ENOUGH_PIXELS,
   RAW_WIDTH_TOO_SMALL,
+  NOT_INDEXED_COLOR,
+  INVALID_PALETTE_COUNT,
+  RAW_PIXEL_COUNT_MISMATCH,
 };
 
 enum class TgxColorType : int32_t
@@ -31,6 +39,29 @@ struct TgxCoderRawInfo
   int rawY;
 };
 
+// raw targets for decoding an indexed TGX through several palettes, all canvases share the same geometry
+struct TgxCoderPaletteRawInfo
+{
+  uint16_t* const* data; // one canvas per palette, same assumptions as TgxCoderRawInfo
+  const uint16_t* const* palettes; // 256 colors per palette
+  int paletteCount;
+  int rawWidth;
+  int rawHeight; // unused in coder, but might be handy
+  int rawX;
+  int rawY;
+};
+
+// canvas for indexed TGX with one byte per pixel, transparency is kept in a separate bit mask
+struct TgxCoderIndexedRawInfo
+{
+  uint8_t* data; // palette index per pixel, same assumptions as TgxCoderRawInfo
+  uint8_t* mask; // one bit per pixel of the canvas in data order, least significant bit first, set for opaque pixels
+  int rawWidth;
+  int rawHeight; // unused in coder, but might be handy
+  int rawX;
+  int rawY;
+};
+
 struct TgxCoderTgxInfo
 {
   TgxColorType colorType;
@@ -62,6 +93,38 @@ struct TgxAnalysis
   int paddingNewlineMarkerCount{ 0 };
 };
 
+// text output of the TGX validation, markers prints every marker with its pixels, rows one line per row with run summaries
+enum class TgxTextMode : int
+{
+  NONE,
+  MARKERS,
+  ROWS,
+};
+
+inline constexpr int TGX_MARKER_HISTOGRAM_SIZE{ 32 }; // a marker covers one to 32 pixels
+
+// statistics of encoded TGX that can be summed up over the images of a GM1 or a whole folder
+struct TgxDetailedAnalysis
+{
+  uint64_t imageCount{ 0 };
+  uint64_t rawBytes{ 0 }; // canvas size with the pixel size of the color type
+  uint64_t encodedBytes{ 0 };
+  uint64_t pixelStreamBytes{ 0 }; // markers and their pixels
+  uint64_t transparentBytes{ 0 };
+  uint64_t repeatingPixelsBytes{ 0 }; // markers and their pixel
+  uint64_t newlineBytes{ 0 };
+  uint64_t paddingBytes{ 0 };
+  std::array<uint64_t, TGX_MARKER_HISTOGRAM_SIZE> pixelStreamHistogram{}; // marker count per pixel count minus one
+  std::array<uint64_t, TGX_MARKER_HISTOGRAM_SIZE> transparentHistogram{};
+  std::array<uint64_t, TGX_MARKER_HISTOGRAM_SIZE> repeatingPixelsHistogram{};
+
+  // row with the most encoded bytes per raw byte, the source is set by the code that sums up the analyses, like an image index
+  std::string worstRowSource{};
+  int worstRow{ -1 };
+  uint32_t worstRowEncodedBytes{ 0 };
+  uint32_t worstRowRawBytes{ 0 };
+};
+
 template<>
 struct std::formatter<TgxCoderRawInfo> : public std::formatter<std::string>
 {
@@ -151,11 +214,68 @@ struct std::formatter<TgxAnalysis> : public std::formatter<std::string>
   }
 };
 
+template<>
+struct std::formatter<TgxDetailedAnalysis> : public std::formatter<std::string>
+{
+  template<typename FormatContext>
+  auto format(const TgxDetailedAnalysis& args, FormatContext& ctx) const
+  {
+    const auto ratio{ [](const uint64_t encoded, const uint64_t raw) { return raw > 0 ? static_cast<double>(encoded) / raw : 0.0; } };
+    auto out{ format_to(ctx.out(),
+      "Image Count: {}\n"
+      "Raw Bytes: {}\n"
+      "Encoded Bytes: {}\n"
+      "Compression Ratio: {:.4f}\n"
+      "Pixel Stream Bytes: {}\n"
+      "Transparent Bytes: {}\n"
+      "Repeating Pixels Bytes: {}\n"
+      "Newline Bytes: {}\n"
+      "Padding Bytes: {}\n",
+      args.imageCount,
+      args.rawBytes,
+      args.encodedBytes,
+      ratio(args.encodedBytes, args.rawBytes),
+      args.pixelStreamBytes,
+      args.transparentBytes,
+      args.repeatingPixelsBytes,
+      args.newlineBytes,
+      args.paddingBytes) };
+
+    // only pixel counts that occur, as "count:markers"
+    const auto formatHistogram{ [&out](const std::string_view name, const std::array<uint64_t, TGX_MARKER_HISTOGRAM_SIZE>& histogram)
+      {
+        out = format_to(out, "{} Histogram:", name);
+        for (int i{ 0 }; i < TGX_MARKER_HISTOGRAM_SIZE; ++i)
+        {
+          if (histogram[i] > 0)
+          {
+            out = format_to(out, " {}:{}", i + 1, histogram[i]);
+          }
+        }
+        out = format_to(out, "\n");
+      }
+    };
+    formatHistogram("Pixel Stream", args.pixelStreamHistogram);
+    formatHistogram("Transparent", args.transparentHistogram);
+    formatHistogram("Repeating Pixels", args.repeatingPixelsHistogram);
+
+    if (args.worstRow < 0)
+    {
+      return format_to(out, "Worst Row: none");
+    }
+    return format_to(out, "Worst Row: {}{}{} ({} bytes for {} raw bytes, ratio {:.4f})",
+      args.worstRowSource, args.worstRowSource.empty() ? "" : " row ", args.worstRow, args.worstRowEncodedBytes, args.worstRowRawBytes,
+      ratio(args.worstRowEncodedBytes, args.worstRowRawBytes));
+  }
+};
+
 // defined for transformation
 constexpr uint16_t GAME_TRANSPARENT_COLOR{ 0b1111100000011111 }; // used by game for some cases (repeating pixels seem excluded?)
 constexpr uint16_t TGX_FILE_TRANSPARENT{ 0 }; // for placing transparency and identification of it
 constexpr int TGX_FILE_PIXEL_REPEAT_THRESHOLD{ 3 }; // requires testing with other files
 constexpr int TGX_FILE_PADDING_ALIGNMENT{ 4 }; // requires testing with other files
+constexpr int TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN{ 1 }; // range of thresholds tried when tuning per image
+constexpr int TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MAX{ 31 }; // the lookahead of higher thresholds runs over the whole rest of the image
 inline constexpr TgxCoderInstruction TGX_FILE_DEFAULT_INSTRUCTION{
   .transparentPixelTgxColor{ GAME_TRANSPARENT_COLOR },
   .transparentPixelRawColor{ TGX_FILE_TRANSPARENT },
@@ -166,14 +286,88 @@ inline constexpr TgxCoderInstruction TGX_FILE_DEFAULT_INSTRUCTION{
 extern "C" __declspec(dllexport) TgxCoderResult analyzeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxAnalysis* tgxAnalysis);
 extern "C" __declspec(dllexport) TgxCoderResult decodeTgxToRaw(const TgxCoderTgxInfo* tgxData, TgxCoderRawInfo* rawData, TgxAnalysis* tgxAnalysis);
 
+// decodes an INDEXED TGX in one pass and writes the colors the indices have in every given palette into the canvas of that palette
+// transparent pixels are skipped like in decodeTgxToRaw
+extern "C" __declspec(dllexport) TgxCoderResult decodeIndexedTgxToPaletteRaw(const TgxCoderTgxInfo* tgxData, const TgxCoderPaletteRawInfo* rawData);
+
+// decodes an INDEXED TGX into an 8 bit canvas, only sets the mask bits of opaque pixels and leaves transparent pixels untouched
+extern "C" __declspec(dllexport) TgxCoderResult decodeIndexedTgxToIndexedRaw(const TgxCoderTgxInfo* tgxData, TgxCoderIndexedRawInfo* rawData);
+
 // fills the dataSize in TgxCoderTgxInfo if data ptr is nullptr and return different result, else it will fill the buffer, but stop if dataSize indicates that the buffer is too small
 // resulting in a broken result; if the buffer size indicated by dataSize is big enough, the dataSize will be set to the actual size
 extern "C" __declspec(dllexport) TgxCoderResult encodeRawToTgx(const TgxCoderRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction);
 
+// same as encodeRawToTgx for an 8 bit canvas with a transparency mask, the TGX needs to be INDEXED
+// the transparent raw color of the instruction should not be of the form 0xff00 | index, like with the 16 bit canvas
+extern "C" __declspec(dllexport) TgxCoderResult encodeIndexedRawToTgx(const TgxCoderIndexedRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction);
+
+// fills the dataSize in TgxCoderTgxInfo with the exact size encodeRawToTgx would produce and returns FILLED_ENCODING_SIZE
+// only scans the runs of equal pixels and sums the marker sizes, so it is faster than a dry run of the encoder
+extern "C" __declspec(dllexport) TgxCoderResult predictRawToTgxSize(const TgxCoderRawInfo* rawData, TgxCoderTgxInfo* tgxData, const TgxCoderInstruction* instruction);
+
 // get a string description of the result, never returns nullptr
 extern "C" __declspec(dllexport) const char* getTgxResultDescription(const TgxCoderResult result);
 
 
-// analysis function that decodes the raw TGX data to a readable text stream
-// only intended for analysis
-TgxCoderResult decodeTgxToText(const TgxCoderTgxInfo& tgxData, std::ostream& outStream);
+// analysis function that decodes the raw TGX data to a readable text stream, either one line per marker or one line per row
+// only intended for analysis, the text is formatted in a reused buffer and written in large blocks
+TgxCoderResult decodeTgxToText(const TgxCoderTgxInfo& tgxData, std::ostream& outStream, TgxTextMode textMode = TgxTextMode::MARKERS);
+
+// accepts "rows", "markers" and the bool values, where true means markers, throws std::invalid_argument otherwise
+TgxTextMode tgxTextModeFromStr(const std::string& str);
+
+// validates the TGX and replaces the analysis with the statistics of this single image
+TgxCoderResult analyzeTgxDetailed(const TgxCoderTgxInfo& tgxData, TgxDetailedAnalysis& analysis);
+
+// sums the source into the target, the worst row is taken over with its source if it is worse
+void addTgxDetailedAnalysis(TgxDetailedAnalysis& target, const TgxDetailedAnalysis& source);
+
+
+// memory owned by the caller that the stream encoder writes to, size counts the bytes written so far
+// if the next bytes do not fit, grow is called with the required capacity and has to update data and capacity
+// this lets the caller encode straight into its final memory, for example behind a resource header
+struct TgxStreamOutput
+{
+  uint8_t* data;
+  uint32_t capacity;
+  uint32_t size;
+  std::function<void(TgxStreamOutput& output, uint32_t requiredCapacity)> grow;
+};
+
+// encoder that receives the raw canvas in chunks of pixels and emits the TGX incrementally, chunks do not need to end at a line end
+// it only keeps the lines the repeating pixel lookahead needs, so the memory does not depend on the image height
+// the result is the same as with encodeRawToTgx for a canvas that has the width of the TGX
+class TgxStreamEncoder
+{
+private:
+  TgxCoderTgxInfo tgxInfo; // data is unused
+  TgxCoderInstruction instruction;
+  int lookaheadLines;
+  std::vector<uint16_t> pendingPixels; // starts with the first pixel of the next line to encode
+  int nextLine;
+  size_t receivedPixelCount;
+  uint32_t encodedSize;
+
+  template<typename Output>
+  TgxCoderResult pushPixels(std::span<const uint16_t> pixels, Output& output);
+  template<typename Output>
+  TgxCoderResult finishPixels(Output& output);
+  template<typename Output>
+  TgxCoderResult encodeLines(int lineCount, Output& output);
+public:
+  TgxStreamEncoder(const TgxCoderTgxInfo& tgxInfo, const TgxCoderInstruction& instruction);
+
+  // number of lines after a line the encoder might read before it can encode that line
+  // a pixel repeat threshold of 32 or above lets the lookahead run over the whole rest of the image
+  int getLookaheadLines() const;
+
+  // appends the bytes of every line that can be encoded with the pixels received so far to out
+  TgxCoderResult push(std::span<const uint16_t> pixels, std::vector<uint8_t>& out);
+  TgxCoderResult push(std::span<const uint16_t> pixels, TgxStreamOutput& out);
+
+  // encodes the remaining lines and the padding, fails if not all pixels were pushed
+  TgxCoderResult finish(std::vector<uint8_t>& out);
+  TgxCoderResult finish(TgxStreamOutput& out);
+
+  uint32_t getEncodedSize() const;
+};
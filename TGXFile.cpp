@@ -1,17 +1,26 @@
 #include "TGXFile.h"
 
+#include "CanvasHash.h"
 #include "Console.h"
+#include "MappedFile.h"
 #include "ResourceMetaFormat.h"
+#include "TaskPool.h"
+#include "Timings.h"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
+#include <functional>
 #include <span>
+#include <optional>
 
 namespace TGXFile
 {
-  void validateTgxResource(const TgxResource& resource, bool tgxAsText)
+  bool validateTgxResource(const TgxResource& resource, TgxTextMode tgxTextMode, TgxDetailedAnalysis* detailedAnalysis)
   {
     Log(LogLevel::INFO, "Try validating given resource.");
-    
+    Timings::PhaseTimer validationTimer{ Timings::Phase::VALIDATION, resource.dataSize };
+
     const TgxCoderTgxInfo tgxInfo{
       .colorType{ TgxColorType::DEFAULT },
       .data{ resource.imageData },
@@ -28,30 +37,40 @@ namespace TGXFile
       Out("{}\n", std::string_view{ getTgxResultDescription(result) });
       Out("### TGX seems invalid. ###\n");
       Log(LogLevel::ERROR, "Validation completed. TGX is invalid.");
-      return;
+      return false;
     }
 
-    Out("### Structure meta data ###\n{}\n\n### TGX seems valid ###\n", tgxAnalysis);
+    TgxDetailedAnalysis tgxDetailedAnalysis{};
+    analyzeTgxDetailed(tgxInfo, tgxDetailedAnalysis); // same validation as above
+    Out("### Structure meta data ###\n{}\n\n### Detailed analysis ###\n{}\n\n### TGX seems valid ###\n", tgxAnalysis, tgxDetailedAnalysis);
+    if (detailedAnalysis)
+    {
+      *detailedAnalysis = std::move(tgxDetailedAnalysis);
+    }
     Log(LogLevel::INFO, "Validation completed successfully.");
-    if (!tgxAsText)
+    validationTimer.stop();
+    if (tgxTextMode == TgxTextMode::NONE)
     {
-      return;
+      return true;
     }
     Log(LogLevel::INFO, "Printing TGX as text to stdout.");
     Out("\n");
-    const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, STD_OUT) };
+    const TgxCoderResult toTextResult{ decodeTgxToText(tgxInfo, getOutStream(), tgxTextMode) };
     if (toTextResult != TgxCoderResult::SUCCESS)
     {
       Out("{}\n", std::string_view{ getTgxResultDescription(toTextResult) });
       Log(LogLevel::ERROR, "Failed to print TGX as text.");
-      return;
+      return true; // the resource itself was valid
     }
     Log(LogLevel::INFO, "Completed to print TGX as text.");
+    return true;
   }
 
   UniqueTgxResourcePointer loadTgxResource(const std::filesystem::path& file)
   {
     Log(LogLevel::INFO, "Try loading TGX file.");
+    Timings::setCurrentType(Timings::TGX_FILE_TYPE);
+    Timings::PhaseTimer statTimer{ Timings::Phase::FILE_STAT };
     if (!std::filesystem::is_regular_file(file))
     {
       Log(LogLevel::ERROR, "Provided TGX file is not a regular file.");
@@ -69,7 +88,9 @@ namespace TGXFile
       return {};
     }
     const uint32_t size{ static_cast<uint32_t>(fileSize) };
+    statTimer.stop();
 
+    Timings::PhaseTimer loadTimer{ Timings::Phase::LOAD, size };
     std::ifstream in;
     in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     in.open(file, std::ios::in | std::ios::binary);
@@ -82,6 +103,7 @@ namespace TGXFile
     resource->dataSize = size - sizeof(TgxHeader);
     resource->header = reinterpret_cast<TgxHeader*>(reinterpret_cast<uint8_t*>(resource.get()) + sizeof(TgxResource));
     resource->imageData = reinterpret_cast<uint8_t*>(resource->header) + sizeof(TgxHeader);
+    loadTimer.stop();
 
     // no further loading check, since TGX files do not rely on internal data
 
@@ -96,8 +118,12 @@ namespace TGXFile
     std::filesystem::create_directories(file.parent_path());
     Log(LogLevel::DEBUG, "Created directories.");
 
+    // removed instead of truncated, so that hard linked copies of the old file stay untouched
+    std::filesystem::remove(file);
+
     // inner block, to wrap file action
     {
+      const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, resource.base.resourceSize };
       std::ofstream out;
       out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
       out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
@@ -119,7 +145,7 @@ namespace TGXFile
     }
   }
 
-  static ResourceMetaFormat::ResourceMetaFileReader readResourceMetaFile(const std::filesystem::path& folder, std::string_view resourceName)
+  static std::ifstream openResourceMetaFile(const std::filesystem::path& folder, std::string_view resourceName)
   {
     try
     {
@@ -129,8 +155,20 @@ namespace TGXFile
       std::ifstream in;
       in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
       in.open(file, std::ios::in); // text handling
+      return in;
+    }
+    catch (...)
+    {
+      Log(LogLevel::ERROR, "Failed to open resource meta file.");
+      throw;
+    }
+  }
 
-      return ResourceMetaFormat::ResourceMetaFileReader::parseFrom(in);
+  static std::optional<ResourceMetaFormat::ResourceMetaObjectReader> readNextResourceMetaObject(ResourceMetaFormat::ResourceMetaFileStreamReader& reader)
+  {
+    try
+    {
+      return reader.next();
     }
     catch (...)
     {
@@ -139,15 +177,80 @@ namespace TGXFile
     }
   }
 
+  // pixels per block that are read or mapped at once while packing raw data
+  static constexpr size_t RAW_DATA_BLOCK_PIXEL_COUNT{ 256 * 1024 };
+
   static bool isVersionSupported(int version, std::span<const int> supportedVersions)
   {
     const auto it{ std::find(supportedVersions.begin(), supportedVersions.end(), version) };
     return it != supportedVersions.end();
   }
 
+  // sets the resource fields for the given encoded size, also after the memory was moved by a resize
+  static void setTgxResourceDataSize(TgxResource& resource, const uint32_t dataSize)
+  {
+    resource.base.type = SHCResourceType::SHC_RESOURCE_TGX;
+    resource.base.resourceSize = sizeof(TgxHeader) + dataSize;
+    resource.base.colorFormat = PixeColorFormat::ARGB_1555;
+    resource.dataSize = dataSize;
+    resource.header = reinterpret_cast<TgxHeader*>(reinterpret_cast<uint8_t*>(&resource) + sizeof(TgxResource));
+    resource.imageData = reinterpret_cast<uint8_t*>(resource.header) + sizeof(TgxHeader);
+  }
+
+  static UniqueTgxResourcePointer createTgxResource(const int32_t width, const int32_t height, const uint32_t dataSize)
+  {
+    UniqueTgxResourcePointer resource{ createWithAdditionalMemory<TgxResource>(sizeof(TgxHeader) + static_cast<size_t>(dataSize)) };
+    setTgxResourceDataSize(*resource, dataSize);
+    resource->header->width = width;
+    resource->header->height = height;
+    return resource;
+  }
+
+  static void resizeTgxResource(UniqueTgxResourcePointer& resource, const uint32_t dataSize)
+  {
+    resizeAdditionalMemory(resource, sizeof(TgxHeader) + static_cast<size_t>(dataSize));
+    setTgxResourceDataSize(*resource, dataSize);
+  }
+
+  // reads the encoded data kept during extract into a new resource
+  // returns an empty pointer if it is missing or does not fit the dimensions, so the canvas is encoded instead
+  static UniqueTgxResourcePointer loadOriginalTgxData(const std::filesystem::path& file, const int32_t width, const int32_t height)
+  {
+    std::error_code errorCode{};
+    const std::uintmax_t fileSize{ std::filesystem::file_size(file, errorCode) };
+    if (errorCode || fileSize > MAX_FILE_SIZE - sizeof(TgxHeader))
+    {
+      Log(LogLevel::WARNING, "Original data file is missing or too large. Encoding raw data.");
+      return {};
+    }
+
+    UniqueTgxResourcePointer resource{ createTgxResource(width, height, static_cast<uint32_t>(fileSize)) };
+    std::ifstream in;
+    in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    in.open(file, std::ios::in | std::ios::binary);
+    in.read(reinterpret_cast<char*>(resource->imageData), resource->dataSize);
+
+    const TgxCoderTgxInfo tgxInfo{
+      .colorType{ TgxColorType::DEFAULT },
+      .data{ resource->imageData },
+      .dataSize{ resource->dataSize },
+      .tgxWidth{ width },
+      .tgxHeight{ height }
+    };
+    const TgxCoderResult result{ analyzeTgxToRaw(&tgxInfo, nullptr) };
+    if (result != TgxCoderResult::SUCCESS)
+    {
+      Log(LogLevel::WARNING, "Original data does not fit the TGX dimensions: {} Encoding raw data.", std::string_view{ getTgxResultDescription(result) });
+      return {};
+    }
+    Log(LogLevel::DEBUG, "Canvas did not change since extract. Reusing original data.");
+    return resource;
+  }
+
   UniqueTgxResourcePointer loadTgxResourceFromRaw(const std::filesystem::path& folder, const TgxCoderInstruction& instructions)
   {
     Log(LogLevel::INFO, "Try loading TGX resource from raw data.");
+    Timings::setCurrentType(Timings::TGX_FILE_TYPE);
     if (!std::filesystem::is_directory(folder))
     {
       Log(LogLevel::ERROR, "Provided raw data folder path is not a directory.");
@@ -157,20 +260,20 @@ namespace TGXFile
     const std::string resourceName{ folder.filename().string() };
     Log(LogLevel::DEBUG, "Using folder name '{}' as resource name.", resourceName);
 
-    Log(LogLevel::DEBUG, "Loading resource meta file.");
-    ResourceMetaFormat::ResourceMetaFileReader resourceMetaFile{ readResourceMetaFile(folder, resourceName) };
-    Log(LogLevel::DEBUG, "Loaded resource meta file.");
+    Log(LogLevel::DEBUG, "Opening resource meta file.");
+    Timings::PhaseTimer metaParseTimer{ Timings::Phase::META_PARSE };
+    std::ifstream metaIn{ openResourceMetaFile(folder, resourceName) };
+    ResourceMetaFormat::ResourceMetaFileStreamReader resourceMetaReader{ ResourceMetaFormat::ResourceMetaFileStreamReader::startFrom(metaIn) };
+    Log(LogLevel::DEBUG, "Opened resource meta file.");
 
-    auto& resourceMetaObjects{ resourceMetaFile.getObjects() };
-    if (resourceMetaObjects.size() != 2)
+    Log(LogLevel::DEBUG, "Read TgxResource object from meta file.");
+    const std::optional<ResourceMetaFormat::ResourceMetaObjectReader> tgxResourceMetaObject{ readNextResourceMetaObject(resourceMetaReader) };
+    if (!tgxResourceMetaObject)
     {
       Log(LogLevel::ERROR, "Resource meta file has not expected number of objects.");
       return {};
     }
-
-
-    Log(LogLevel::DEBUG, "Read TgxResource object from meta file.");
-    const ResourceMetaFormat::ResourceMetaObjectReader&  tgxResourceMeta{ resourceMetaObjects.at(0) };
+    const ResourceMetaFormat::ResourceMetaObjectReader& tgxResourceMeta{ *tgxResourceMetaObject };
     if (tgxResourceMeta.getIdentifier() != TgxResourceMeta::RESOURCE_IDENTIFIER)
     {
       Log(LogLevel::ERROR, "Resource meta file does not have a {} object after the header.", TgxResourceMeta::RESOURCE_IDENTIFIER);
@@ -184,13 +287,61 @@ namespace TGXFile
     // version currently ignored, since only one available
 
     const auto& tgxResourceEntries{ tgxResourceMeta.getMapEntries() };
-    if (tgxResourceEntries.size() != 3)
+    PixelConversion::RawPixelFormat rawPixelFormat{ PixelConversion::RawPixelFormat::ARGB_1555 };
+    size_t expectedEntries{ 3 };
+    auto it{ tgxResourceEntries.find(TgxResourceMeta::RAW_DATA_FORMAT_KEY) };
+    if (it != tgxResourceEntries.end())
+    {
+      rawPixelFormat = PixelConversion::rawPixelFormatFromStr(it->second);
+      ++expectedEntries;
+    }
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::INDEXED_8)
+    {
+      Log(LogLevel::ERROR, "{} object uses a data format that is only supported for animations.", TgxResourceMeta::RESOURCE_IDENTIFIER);
+      return {};
+    }
+    RawCompression::Compression dataCompression{ RawCompression::Compression::NONE };
+    it = tgxResourceEntries.find(TgxResourceMeta::RAW_DATA_COMPRESSION_KEY);
+    if (it != tgxResourceEntries.end())
+    {
+      dataCompression = RawCompression::compressionFromStr(it->second);
+      ++expectedEntries;
+    }
+    TgxCoderInstruction packInstructions{ instructions };
+    it = tgxResourceEntries.find(TgxResourceMeta::PIXEL_REPEAT_THRESHOLD_KEY);
+    if (it != tgxResourceEntries.end())
+    {
+      packInstructions.pixelRepeatThreshold = intFromStr<int>(it->second);
+      Log(LogLevel::DEBUG, "Using pixel repeat threshold {} tuned during extract.", packInstructions.pixelRepeatThreshold);
+      ++expectedEntries;
+    }
+    std::optional<std::string> relativeOriginalDataPath;
+    it = tgxResourceEntries.find(TgxResourceMeta::ORIGINAL_DATA_PATH_KEY);
+    if (it != tgxResourceEntries.end())
+    {
+      relativeOriginalDataPath = it->second;
+      ++expectedEntries;
+    }
+    std::optional<uint64_t> canvasHash;
+    it = tgxResourceEntries.find(TgxResourceMeta::CANVAS_HASH_KEY);
+    if (it != tgxResourceEntries.end())
+    {
+      canvasHash = uintFromStr<uint64_t>(it->second);
+      ++expectedEntries;
+    }
+    if (relativeOriginalDataPath.has_value() != canvasHash.has_value())
+    {
+      Log(LogLevel::ERROR, "{} object needs '{}' and '{}' together.", TgxResourceMeta::RESOURCE_IDENTIFIER, TgxResourceMeta::ORIGINAL_DATA_PATH_KEY,
+        TgxResourceMeta::CANVAS_HASH_KEY);
+      return {};
+    }
+    if (tgxResourceEntries.size() != expectedEntries)
     {
       Log(LogLevel::ERROR, "{} object has not expected number of entries.", TgxResourceMeta::RESOURCE_IDENTIFIER);
       return {};
     }
 
-    auto it{ tgxResourceEntries.find(TgxResourceMeta::RAW_DATA_PATH_KEY) };
+    it = tgxResourceEntries.find(TgxResourceMeta::RAW_DATA_PATH_KEY);
     if (it == tgxResourceEntries.end())
     {
       Log(LogLevel::ERROR, "{} object has not expected entry '{}'.", TgxResourceMeta::RESOURCE_IDENTIFIER, TgxResourceMeta::RAW_DATA_PATH_KEY);
@@ -216,7 +367,13 @@ namespace TGXFile
 
 
     Log(LogLevel::DEBUG, "Read TgxHeader object from meta file.");
-    const ResourceMetaFormat::ResourceMetaObjectReader& tgxHeaderMeta{ resourceMetaObjects.at(1) };
+    const std::optional<ResourceMetaFormat::ResourceMetaObjectReader> tgxHeaderMetaObject{ readNextResourceMetaObject(resourceMetaReader) };
+    if (!tgxHeaderMetaObject || readNextResourceMetaObject(resourceMetaReader))
+    {
+      Log(LogLevel::ERROR, "Resource meta file has not expected number of objects.");
+      return {};
+    }
+    const ResourceMetaFormat::ResourceMetaObjectReader& tgxHeaderMeta{ *tgxHeaderMetaObject };
     if (tgxHeaderMeta.getIdentifier() != TgxHeaderMeta::RESOURCE_IDENTIFIER)
     {
       Log(LogLevel::ERROR, "Resource meta file does not have a {} object at last position.", TgxHeaderMeta::RESOURCE_IDENTIFIER);
@@ -239,14 +396,18 @@ namespace TGXFile
     const int32_t height{ intFromStr<int32_t>(tgxHeaderEntries.at(1)) };
 
     const std::filesystem::path fullDataPath{ folder / relativeDataPath };
+    metaParseTimer.stop();
 
     Log(LogLevel::DEBUG, "Validating certain values.");
-    if (static_cast<size_t>(width) * height * sizeof(uint16_t) != rawDataSize)
+    Timings::PhaseTimer statTimer{ Timings::Phase::FILE_STAT };
+    const size_t rawDataPixelSize{ static_cast<size_t>(width) * height };
+    if (rawDataPixelSize * PixelConversion::getRawPixelFormatByteSize(rawPixelFormat) != rawDataSize)
     {
       Log(LogLevel::ERROR, "Dimensions in header do not match raw data size in meta file.");
       return {};
     }
-    if (std::filesystem::file_size(fullDataPath) != rawDataSize)
+    // the compressed data checks its size while reading
+    if (dataCompression == RawCompression::Compression::NONE && std::filesystem::file_size(fullDataPath) != rawDataSize)
     {
       Log(LogLevel::ERROR, "Size of raw data file do not match raw data size in meta file.");
       return {};
@@ -256,64 +417,198 @@ namespace TGXFile
       Log(LogLevel::WARNING, "Transparent pixel in meta file does not match transparent pixel in coder instructions." 
         "This is valid, but might produce unexpected results. Set the coder options in the CLI if this is not wanted.");
     }
+    statTimer.stop();
 
-    auto rawData{ std::make_unique_for_overwrite<uint16_t[]>(static_cast<size_t>(width) * height) };
-    Log(LogLevel::DEBUG, "Loading raw data.");
-    try {
-      std::ifstream in;
-      in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-      in.open(fullDataPath, std::ios::in | std::ios::binary);
-      in.read(reinterpret_cast<char*>(rawData.get()), rawDataSize);
-    }
-    catch (...)
+    // the raw data is passed in blocks of argb1555 pixels while it is read, so the memory does not depend on the canvas size
+    // native uncompressed data is passed from a read only mapping of the file, without a copy
+    // the consumer returns false to skip the remaining blocks
+    std::unique_ptr<uint16_t[]> convertedPixels;
+    size_t convertedPixelCount{ 0 };
+    const size_t pixelByteSize{ PixelConversion::getRawPixelFormatByteSize(rawPixelFormat) };
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888)
     {
-      Log(LogLevel::ERROR, "Failed to load raw data.");
-      throw;
+      const Timings::PhaseTimer allocationTimer{ Timings::Phase::CANVAS_ALLOCATION };
+      const size_t blockPixelCount{ dataCompression == RawCompression::Compression::NONE
+        ? RAW_DATA_BLOCK_PIXEL_COUNT : RawCompression::BLOCK_SIZE / pixelByteSize };
+      convertedPixelCount = std::min(blockPixelCount, rawDataPixelSize);
+      convertedPixels = std::make_unique_for_overwrite<uint16_t[]>(convertedPixelCount);
     }
-    Log(LogLevel::DEBUG, "Loaded raw data.");
-
-    const TgxCoderRawInfo rawInfo{
-      .data{ rawData.get() },
-      .rawWidth{ width },
-      .rawHeight{ height },
-      .rawX{ 0 },
-      .rawY{ 0 }
-    };
-    TgxCoderTgxInfo tgxInfo{
-      .colorType{ TgxColorType::DEFAULT },
-      .data{ nullptr },
-      .dataSize{ 0 },
-      .tgxWidth{ width },
-      .tgxHeight{ height }
+    const auto readRawPixels{ [&](const std::function<bool(std::span<const uint16_t>)>& pixelConsumer)
+      {
+        bool continueReading{ true };
+        // only reading, mapping and decompressing is timed as load, the load timer is stopped while a block is passed on,
+        // since the conversion and the consumers time their own phases
+        std::optional<Timings::PhaseTimer> loadTimer{ std::in_place, Timings::Phase::LOAD };
+        const auto passLoadedBlock{ [&](const uint64_t loadedBytes, const auto& passBlock)
+          {
+            loadTimer->addBytes(loadedBytes);
+            loadTimer.reset();
+            passBlock();
+            loadTimer.emplace(Timings::Phase::LOAD);
+          }
+        };
+        const auto passRgbaPixels{ [&](const std::span<const uint32_t> pixels)
+          {
+            if (pixels.size() > convertedPixelCount)
+            {
+              throw std::exception{ "Raw data block is larger than the conversion buffer." };
+            }
+            passLoadedBlock(pixels.size_bytes(), [&]()
+              {
+                {
+                  const Timings::PhaseTimer conversionTimer{ Timings::Phase::PIXEL_CONVERSION, pixels.size_bytes() };
+                  PixelConversion::rgba8888ToArgb1555(pixels, { convertedPixels.get(), pixels.size() });
+                }
+                continueReading = pixelConsumer({ convertedPixels.get(), pixels.size() });
+              });
+          }
+        };
+        const auto passRawPixels{ [&](const std::span<const uint16_t> pixels)
+          {
+            passLoadedBlock(pixels.size_bytes(), [&]() { continueReading = pixelConsumer(pixels); });
+          }
+        };
+
+        if (dataCompression != RawCompression::Compression::NONE)
+        {
+          std::ifstream in;
+          in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+          in.open(fullDataPath, std::ios::in | std::ios::binary);
+          RawCompression::readCompressedBlocks(in, rawDataSize, [&](const std::span<const uint8_t> block)
+            {
+              if (block.size() % pixelByteSize != 0)
+              {
+                throw std::exception{ "Compressed raw data blocks do not contain whole pixels." };
+              }
+              if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888)
+              {
+                passRgbaPixels({ reinterpret_cast<const uint32_t*>(block.data()), block.size() / pixelByteSize });
+              }
+              else
+              {
+                passRawPixels({ reinterpret_cast<const uint16_t*>(block.data()), block.size() / pixelByteSize });
+              }
+              return continueReading;
+            });
+        }
+        else if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888)
+        {
+          std::ifstream in;
+          in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+          in.open(fullDataPath, std::ios::in | std::ios::binary);
+          const size_t blockPixelCount{ std::min(RAW_DATA_BLOCK_PIXEL_COUNT, rawDataPixelSize) };
+          const auto rgbaBlock{ std::make_unique_for_overwrite<uint32_t[]>(blockPixelCount) };
+          for (size_t pixelIndex{ 0 }; pixelIndex < rawDataPixelSize && continueReading; pixelIndex += blockPixelCount)
+          {
+            const size_t pixelCount{ std::min(blockPixelCount, rawDataPixelSize - pixelIndex) };
+            in.read(reinterpret_cast<char*>(rgbaBlock.get()), pixelCount * pixelByteSize);
+            passRgbaPixels({ rgbaBlock.get(), pixelCount });
+          }
+        }
+        else
+        {
+          const MappedFile mappedRawData{ fullDataPath };
+          const uint16_t* rawPixels{ reinterpret_cast<const uint16_t*>(mappedRawData.get().data()) };
+          for (size_t pixelIndex{ 0 }; pixelIndex < rawDataPixelSize && continueReading; pixelIndex += RAW_DATA_BLOCK_PIXEL_COUNT)
+          {
+            passRawPixels({ rawPixels + pixelIndex, std::min(RAW_DATA_BLOCK_PIXEL_COUNT, rawDataPixelSize - pixelIndex) });
+          }
+        }
+      }
     };
 
-    Log(LogLevel::DEBUG, "Determine encoded size.");
-    const TgxCoderResult dataSizeCheckResult{ encodeRawToTgx(&rawInfo, &tgxInfo, &instructions) };
-    if (dataSizeCheckResult != TgxCoderResult::FILLED_ENCODING_SIZE)
+    // an unchanged canvas reuses the encoded data kept during extract, which also keeps it byte identical to the original
+    UniqueTgxResourcePointer resource{};
+    if (canvasHash)
     {
-      Log(LogLevel::ERROR, "{}", std::string_view{ getTgxResultDescription(dataSizeCheckResult) });
-      return {};
+      const std::filesystem::path fullOriginalDataPath{ folder / *relativeOriginalDataPath };
+      CanvasHash::Hasher hasher{};
+      try
+      {
+        readRawPixels([&hasher](const std::span<const uint16_t> pixels)
+          {
+            const Timings::PhaseTimer hashTimer{ Timings::Phase::CANVAS_HASH, pixels.size_bytes() };
+            hasher.addPixels(pixels);
+            return true;
+          });
+        if (hasher.getHash() == *canvasHash)
+        {
+          resource = loadOriginalTgxData(fullOriginalDataPath, width, height);
+        }
+        else
+        {
+          Log(LogLevel::DEBUG, "Canvas changed since extract. Encoding raw data.");
+        }
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Failed to check raw data against original data.");
+        throw;
+      }
     }
 
-    Log(LogLevel::DEBUG, "Create TGX resource.");
-    const uint32_t resourceSize{ sizeof(TgxHeader) + tgxInfo.dataSize };
-    UniqueTgxResourcePointer resource{ createWithAdditionalMemory<TgxResource>(resourceSize) };
-    resource->base.type = SHCResourceType::SHC_RESOURCE_TGX;
-    resource->base.resourceSize = resourceSize;
-    resource->base.colorFormat = PixeColorFormat::ARGB_1555;
-    resource->dataSize = tgxInfo.dataSize;
-    resource->header = reinterpret_cast<TgxHeader*>(reinterpret_cast<uint8_t*>(resource.get()) + sizeof(TgxResource));
-    resource->imageData = reinterpret_cast<uint8_t*>(resource->header) + sizeof(TgxHeader);
-    resource->header->width = width;
-    resource->header->height = height;
-
-    Log(LogLevel::DEBUG, "Encode into TGX resource.");
-    tgxInfo.data = resource->imageData;
-    const TgxCoderResult encodingResult{ encodeRawToTgx(&rawInfo, &tgxInfo, &instructions) };
-    if (encodingResult != TgxCoderResult::SUCCESS)
+    if (!resource)
     {
-      Log(LogLevel::ERROR, "{}", std::string_view{ getTgxResultDescription(encodingResult) });
-      return {};
+      const TgxCoderTgxInfo tgxInfo{
+        .colorType{ TgxColorType::DEFAULT },
+        .data{ nullptr },
+        .dataSize{ 0 },
+        .tgxWidth{ width },
+        .tgxHeight{ height }
+      };
+      TgxStreamEncoder encoder{ tgxInfo, packInstructions };
+      TgxCoderResult encodeResult{ TgxCoderResult::SUCCESS };
+
+      // the TGX is encoded straight behind the resource header, the memory grows with the encoded size and is shrunk to it at the end
+      // so only the input side is bounded, the output needs the encoded size plus the growth slack
+      resource = createTgxResource(width, height, static_cast<uint32_t>(std::min(rawDataPixelSize, RAW_DATA_BLOCK_PIXEL_COUNT)));
+      TgxStreamOutput output{
+        .data{ resource->imageData },
+        .capacity{ resource->dataSize },
+        .size{ 0 },
+        .grow{ [&resource](TgxStreamOutput& grownOutput, const uint32_t requiredCapacity)
+          {
+            constexpr uint64_t maxCapacity{ MAX_FILE_SIZE - sizeof(TgxHeader) };
+            if (requiredCapacity > maxCapacity)
+            {
+              throw std::exception{ "Encoded TGX data is too big to be handled by this implementation." };
+            }
+            const uint32_t capacity{ static_cast<uint32_t>(std::clamp<uint64_t>(grownOutput.capacity + grownOutput.capacity / 2ull,
+              requiredCapacity, maxCapacity)) };
+            resizeTgxResource(resource, capacity);
+            grownOutput.data = resource->imageData;
+            grownOutput.capacity = capacity;
+          }
+        }
+      };
+
+      Log(LogLevel::DEBUG, "Loading and encoding raw data.");
+      try
+      {
+        readRawPixels([&](const std::span<const uint16_t> pixels)
+          {
+            const Timings::PhaseTimer encodeTimer{ Timings::Phase::IMAGE_ENCODE, pixels.size_bytes() };
+            encodeResult = encoder.push(pixels, output);
+            return encodeResult == TgxCoderResult::SUCCESS;
+          });
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Failed to load raw data.");
+        throw;
+      }
+      if (encodeResult == TgxCoderResult::SUCCESS)
+      {
+        const Timings::PhaseTimer encodeTimer{ Timings::Phase::IMAGE_ENCODE };
+        encodeResult = encoder.finish(output);
+      }
+      if (encodeResult != TgxCoderResult::SUCCESS)
+      {
+        Log(LogLevel::ERROR, "{}", std::string_view{ getTgxResultDescription(encodeResult) });
+        return {};
+      }
+      resizeTgxResource(resource, output.size);
+      Log(LogLevel::DEBUG, "Loaded and encoded raw data.");
     }
 
     Log(LogLevel::INFO, "Loaded TGX resource from raw data.");
@@ -327,15 +622,61 @@ namespace TGXFile
     return rawData;
   }
 
-  void saveTgxResourceAsRaw(const std::filesystem::path& folder, const TgxResource& resource, const TgxCoderInstruction& instructions)
+  // predicts the encoded size for every threshold of the search range in parallel and returns the one with the smallest TGX
+  // ties keep the threshold of the instructions, or else the lowest one
+  static int findSmallestPixelRepeatThreshold(const TgxCoderRawInfo& rawInfo, const int32_t width, const int32_t height,
+    const TgxCoderInstruction& instructions)
+  {
+    constexpr int thresholdCount{ TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MAX - TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN + 1 };
+    std::array<uint32_t, thresholdCount> encodedSizes{};
+    TaskPool::runParallel(thresholdCount, [&](const size_t index)
+      {
+        TgxCoderInstruction candidate{ instructions };
+        candidate.pixelRepeatThreshold = TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN + static_cast<int>(index);
+        TgxCoderTgxInfo tgxInfo{
+          .colorType{ TgxColorType::DEFAULT },
+          .data{ nullptr },
+          .dataSize{ 0 },
+          .tgxWidth{ width },
+          .tgxHeight{ height }
+        };
+        const TgxCoderResult result{ predictRawToTgxSize(&rawInfo, &tgxInfo, &candidate) };
+        encodedSizes[index] = result == TgxCoderResult::FILLED_ENCODING_SIZE ? tgxInfo.dataSize : UINT32_MAX;
+      });
+
+    // starts with the threshold of the instructions if it is part of the range, so it wins ties
+    const int instructionIndex{ instructions.pixelRepeatThreshold - TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN };
+    int bestIndex{ instructionIndex >= 0 && instructionIndex < thresholdCount ? instructionIndex : 0 };
+    for (int index{ 0 }; index < thresholdCount; ++index)
+    {
+      if (encodedSizes[index] < encodedSizes[bestIndex])
+      {
+        bestIndex = index;
+      }
+    }
+    if (encodedSizes[bestIndex] == UINT32_MAX)
+    {
+      throw std::exception{ "Encoder failed for every pixel repeat threshold." };
+    }
+    Log(LogLevel::DEBUG, "Pixel repeat threshold {} results in the smallest TGX with {} bytes.", TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN + bestIndex,
+      encodedSizes[bestIndex]);
+    return TGX_PIXEL_REPEAT_THRESHOLD_SEARCH_MIN + bestIndex;
+  }
+
+  void saveTgxResourceAsRaw(const std::filesystem::path& folder, const TgxResource& resource, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions)
   {
     Log(LogLevel::INFO, "Try saving TGX resource as raw data.");
 
     std::filesystem::create_directories(folder);
     Log(LogLevel::DEBUG, "Created directory.");
 
+    Timings::PhaseTimer allocationTimer{ Timings::Phase::CANVAS_ALLOCATION,
+      static_cast<uint64_t>(resource.header->width) * resource.header->height * sizeof(uint16_t) };
     auto rawData{ createMemoryForRaw(resource.header->width, resource.header->height, instructions.transparentPixelRawColor) };
+    allocationTimer.stop();
 
+    Timings::PhaseTimer decodeTimer{ Timings::Phase::IMAGE_DECODE, resource.dataSize };
     const TgxCoderTgxInfo tgxInfo{
       .colorType{ TgxColorType::DEFAULT },
       .data{ resource.imageData },
@@ -355,15 +696,51 @@ namespace TGXFile
     {
       throw std::exception{ getTgxResultDescription(result) };
     }
+    decodeTimer.stop();
     Log(LogLevel::DEBUG, "Decoded TGX to raw data.");
 
+    std::optional<int> tunedPixelRepeatThreshold;
+    if (extractOptions.tunePixelRepeatThreshold)
+    {
+      const Timings::PhaseTimer encodeTimer{ Timings::Phase::IMAGE_ENCODE,
+        static_cast<uint64_t>(resource.header->width) * resource.header->height * sizeof(uint16_t) };
+      tunedPixelRepeatThreshold = findSmallestPixelRepeatThreshold(rawInfo, resource.header->width, resource.header->height, instructions);
+    }
+
+    std::optional<uint64_t> canvasHash;
+    if (extractOptions.keepOriginalEncoding)
+    {
+      const Timings::PhaseTimer hashTimer{ Timings::Phase::CANVAS_HASH,
+        static_cast<uint64_t>(resource.header->width) * resource.header->height * sizeof(uint16_t) };
+      canvasHash = CanvasHash::hashCanvasRegion(rawData.get(), resource.header->width, 0, 0, resource.header->width, resource.header->height);
+    }
+
     const std::string resourceName{ folder.filename().string() };
     Log(LogLevel::DEBUG, "Using folder name '{}' as resource name.", resourceName);
 
     std::filesystem::path relativeDataPath{ resourceName };
     relativeDataPath.replace_extension(RAW_DATA_FILE_EXTENSION);
 
-    const size_t rawDataSize{ static_cast<size_t>(resource.header->width) * resource.header->height * sizeof(uint16_t) };
+    std::filesystem::path relativeOriginalDataPath{ resourceName };
+    relativeOriginalDataPath.replace_extension(ORIGINAL_DATA_FILE_EXTENSION);
+
+    const size_t rawDataPixelSize{ static_cast<size_t>(resource.header->width) * resource.header->height };
+    PixelConversion::RawPixelFormat rawPixelFormat{ extractOptions.rawPixelFormat };
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::INDEXED_8)
+    {
+      Log(LogLevel::WARNING, "Only animations have an indexed canvas. Raw data is kept as argb1555.");
+      rawPixelFormat = PixelConversion::RawPixelFormat::ARGB_1555;
+    }
+    const size_t rawDataSize{ rawDataPixelSize * PixelConversion::getRawPixelFormatByteSize(rawPixelFormat) };
+
+    std::unique_ptr<uint32_t[]> rgbaData;
+    if (rawPixelFormat == PixelConversion::RawPixelFormat::RGBA_8888)
+    {
+      const Timings::PhaseTimer conversionTimer{ Timings::Phase::PIXEL_CONVERSION, rawDataSize };
+      rgbaData = std::make_unique_for_overwrite<uint32_t[]>(rawDataPixelSize);
+      PixelConversion::argb1555ToRgba8888({ rawData.get(), rawDataPixelSize }, { rgbaData.get(), rawDataPixelSize });
+      Log(LogLevel::DEBUG, "Converted raw data to {}.", PixelConversion::getRawPixelFormatName(rawPixelFormat));
+    }
 
     Log(LogLevel::DEBUG, "Creating resource meta file.");
     {
@@ -371,27 +748,50 @@ namespace TGXFile
       file.replace_extension(ResourceMetaFormat::FILE::EXTENSION);
 
       try {
+        Timings::PhaseTimer metaWriteTimer{ Timings::Phase::META_WRITE };
         std::ofstream out;
         out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
         out.open(file, std::ios::out | std::ios::trunc); // text handling
 
-        ResourceMetaFormat::ResourceMetaFileWriter::startFile(out, ResourceMetaFormat::VERSION::CURRENT)
-          .startHeader()
+        auto metaWriter{ ResourceMetaFormat::ResourceMetaFileWriter::startFile(out, ResourceMetaFormat::VERSION::CURRENT) };
+        auto& tgxResourceWriter{ metaWriter.startHeader()
           .endObject()
 
           .startObject(TgxResourceMeta::RESOURCE_IDENTIFIER, TgxResourceMeta::CURRENT_VERSION)
           .writeMapEntry(TgxResourceMeta::RAW_DATA_PATH_KEY, relativeDataPath.string())
-          .writeMapEntry(TgxResourceMeta::RAW_DATA_SIZE_KEY, std::to_string(rawDataSize))
-          .writeMapEntry(TgxResourceMeta::RAW_DATA_TRANSPARENT_PIXEL_KEY, std::format("{:#06x}", instructions.transparentPixelRawColor),
-            "Color used for transparent pixel during extract. Not automatically used during packing.")
-          .endObject()
+          .writeMapEntry(TgxResourceMeta::RAW_DATA_SIZE_KEY, rawDataSize)
+          .writeMapEntry(TgxResourceMeta::RAW_DATA_TRANSPARENT_PIXEL_KEY, instructions.transparentPixelRawColor, ResourceMetaFormat::INTEGER_FORMAT::HEX_WORD,
+            "Color used for transparent pixel during extract. Not automatically used during packing.") };
+        if (rgbaData)
+        {
+          tgxResourceWriter.writeMapEntry(TgxResourceMeta::RAW_DATA_FORMAT_KEY, PixelConversion::getRawPixelFormatName(rawPixelFormat),
+            "Converted back to argb1555 during packing.");
+        }
+        if (extractOptions.dataCompression != RawCompression::Compression::NONE)
+        {
+          tgxResourceWriter.writeMapEntry(TgxResourceMeta::RAW_DATA_COMPRESSION_KEY, RawCompression::getCompressionName(extractOptions.dataCompression),
+            "The data size is the size before compression.");
+        }
+        if (tunedPixelRepeatThreshold)
+        {
+          tgxResourceWriter.writeMapEntry(TgxResourceMeta::PIXEL_REPEAT_THRESHOLD_KEY, *tunedPixelRepeatThreshold,
+            "Threshold with the smallest TGX found during extract. Used instead of the coder option during packing.");
+        }
+        if (canvasHash)
+        {
+          tgxResourceWriter.writeMapEntry(TgxResourceMeta::ORIGINAL_DATA_PATH_KEY, relativeOriginalDataPath.string(),
+            "Encoded data of the extracted TGX. Copied during packing while the canvas matches the hash.")
+            .writeMapEntry(TgxResourceMeta::CANVAS_HASH_KEY, *canvasHash, ResourceMetaFormat::INTEGER_FORMAT::HEX_QWORD);
+        }
+        tgxResourceWriter.endObject()
 
           .startObject(TgxHeaderMeta::RESOURCE_IDENTIFIER, TgxHeaderMeta::CURRENT_VERSION)
-          .writeListEntry(std::to_string(resource.header->width), TgxHeaderMeta::COMMENT_WIDTH)
-          .writeListEntry(std::to_string(resource.header->height), TgxHeaderMeta::COMMENT_HEIGHT)
+          .writeListEntry(resource.header->width, TgxHeaderMeta::COMMENT_WIDTH)
+          .writeListEntry(resource.header->height, TgxHeaderMeta::COMMENT_HEIGHT)
           .endObject()
 
           .endFile();
+        metaWriteTimer.addBytes(static_cast<uint64_t>(out.tellp()));
       }
       catch (...) {
         Log(LogLevel::ERROR, "Encountered error while writing TGX resource meta file. File is likely corrupted.");
@@ -405,10 +805,19 @@ namespace TGXFile
       const std::filesystem::path file{ folder / relativeDataPath };
       try
       {
+        const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, rawDataSize };
         std::ofstream out;
         out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
         out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
-        out.write(reinterpret_cast<const char*>(rawData.get()), rawDataSize);
+        const uint8_t* data{ rgbaData ? reinterpret_cast<const uint8_t*>(rgbaData.get()) : reinterpret_cast<const uint8_t*>(rawData.get()) };
+        if (extractOptions.dataCompression == RawCompression::Compression::NONE)
+        {
+          out.write(reinterpret_cast<const char*>(data), rawDataSize);
+        }
+        else
+        {
+          RawCompression::writeCompressed(out, { data, rawDataSize });
+        }
       }
       catch (...)
       {
@@ -418,6 +827,50 @@ namespace TGXFile
     }
     Log(LogLevel::DEBUG, "Created resource data file.");
 
+    if (canvasHash)
+    {
+      Log(LogLevel::DEBUG, "Creating original data file.");
+      const std::filesystem::path file{ folder / relativeOriginalDataPath };
+      try
+      {
+        const Timings::PhaseTimer writeTimer{ Timings::Phase::DATA_WRITE, resource.dataSize };
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(file, std::ios::out | std::ios::trunc | std::ios::binary);
+        out.write(reinterpret_cast<const char*>(resource.imageData), resource.dataSize);
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Encountered error while writing TGX original data file. File is likely corrupted.");
+        throw;
+      }
+      Log(LogLevel::DEBUG, "Created original data file.");
+    }
+
+    if (extractOptions.pngFormat != PngFile::PngFormat::NONE && rawDataSize > 0)
+    {
+      Log(LogLevel::DEBUG, "Creating PNG file.");
+      std::filesystem::path file{ folder / resourceName };
+      file.replace_extension(PngFile::FILE_EXTENSION);
+      try
+      {
+        const Timings::PhaseTimer pngTimer{ Timings::Phase::PNG_WRITE, rawDataSize };
+        PngFile::savePng(file, PngFile::PngSource{
+          .data{ rawData.get() },
+          .width{ resource.header->width },
+          .height{ resource.header->height },
+          .transparentPixel{ instructions.transparentPixelRawColor },
+          .palette{ nullptr }
+        }, extractOptions.pngFormat);
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "Encountered error while writing TGX PNG file. File is likely corrupted.");
+        throw;
+      }
+      Log(LogLevel::DEBUG, "Created PNG file.");
+    }
+
     Log(LogLevel::INFO, "Saved TGX resource as raw data.");
   }
 }
@@ -4,6 +4,7 @@
 
 #include "Utility.h"
 #include "TgxCoder.h"
+#include "ExtractOptions.h"
 
 #include <memory>
 #include <filesystem>
@@ -17,6 +18,7 @@ namespace TGXFile
   inline constexpr std::uintmax_t MAX_FILE_SIZE{ std::numeric_limits<uint32_t>::max() }; // setting limit
 
   inline constexpr std::string_view RAW_DATA_FILE_EXTENSION{ ".data" };
+  inline constexpr std::string_view ORIGINAL_DATA_FILE_EXTENSION{ ".encoded" };
 
   namespace TgxResourceMeta
   {
@@ -27,6 +29,11 @@ namespace TGXFile
     inline constexpr std::string_view RAW_DATA_PATH_KEY{ "data path" };
     inline constexpr std::string_view RAW_DATA_SIZE_KEY{ "data size" };
     inline constexpr std::string_view RAW_DATA_TRANSPARENT_PIXEL_KEY{ "transparent pixel" };
+    inline constexpr std::string_view RAW_DATA_FORMAT_KEY{ "data format" }; // optional, only written if not argb1555
+    inline constexpr std::string_view RAW_DATA_COMPRESSION_KEY{ "data compression" }; // optional, only written if compressed
+    inline constexpr std::string_view PIXEL_REPEAT_THRESHOLD_KEY{ "pixel repeat threshold" }; // optional, only written if tuned during extract
+    inline constexpr std::string_view ORIGINAL_DATA_PATH_KEY{ "original data path" }; // optional, only written if the original encoding is kept
+    inline constexpr std::string_view CANVAS_HASH_KEY{ "canvas hash" }; // optional, written together with the original data path
   }
 
   namespace TgxHeaderMeta
@@ -39,11 +46,14 @@ namespace TGXFile
     inline constexpr std::string_view COMMENT_HEIGHT{ "height" };
   }
 
-  void validateTgxResource(const TgxResource& resource, bool tgxAsText);
+  // returns true if the resource is valid
+  // the detailed analysis is optional and filled if the TGX is valid
+  bool validateTgxResource(const TgxResource& resource, TgxTextMode tgxTextMode, TgxDetailedAnalysis* detailedAnalysis = nullptr);
 
   UniqueTgxResourcePointer loadTgxResource(const std::filesystem::path& file);
   void saveTgxResource(const std::filesystem::path& file, const TgxResource& resource);
 
   UniqueTgxResourcePointer loadTgxResourceFromRaw(const std::filesystem::path& folder, const TgxCoderInstruction& instructions);
-  void saveTgxResourceAsRaw(const std::filesystem::path& folder, const TgxResource& resource, const TgxCoderInstruction& instructions);
+  void saveTgxResourceAsRaw(const std::filesystem::path& folder, const TgxResource& resource, const TgxCoderInstruction& instructions,
+    const ExtractOptions& extractOptions);
 }
@@ -0,0 +1,199 @@
+#include "TaskPool.h"
+
+#include "Console.h"
+#include "Timings.h"
+
+#include <algorithm>
+#include <exception>
+
+static thread_local bool isPoolWorker{ false };
+
+TaskPool::TaskPool(unsigned int threadCount)
+  : queuedTaskCount{ 0 }, pendingTaskCount{ 0 }, nextQueueIndex{ 0 }, stopping{ false }
+{
+  if (threadCount == 0)
+  {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  queues.reserve(threadCount);
+  for (unsigned int i{ 0 }; i < threadCount; ++i)
+  {
+    queues.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  workers.reserve(threadCount);
+  for (unsigned int i{ 0 }; i < threadCount; ++i)
+  {
+    workers.emplace_back(&TaskPool::workerLoop, this, i);
+  }
+  Log(LogLevel::DEBUG, "TaskPool: Started {} worker threads.", threadCount);
+}
+
+TaskPool::~TaskPool()
+{
+  waitForAll();
+  {
+    const std::lock_guard lock{ stateMutex };
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (std::thread& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+unsigned int TaskPool::getThreadCount() const
+{
+  return static_cast<unsigned int>(workers.size());
+}
+
+bool TaskPool::tryPopOwnTask(size_t workerIndex, std::function<void()>& outTask)
+{
+  WorkerQueue& queue{ *queues[workerIndex] };
+  const std::lock_guard lock{ queue.mutex };
+  if (queue.tasks.empty())
+  {
+    return false;
+  }
+  outTask = std::move(queue.tasks.front());
+  queue.tasks.pop_front();
+  return true;
+}
+
+bool TaskPool::tryStealTask(size_t workerIndex, std::function<void()>& outTask)
+{
+  for (size_t i{ 1 }; i < queues.size(); ++i)
+  {
+    WorkerQueue& queue{ *queues[(workerIndex + i) % queues.size()] };
+    const std::lock_guard lock{ queue.mutex };
+    if (queue.tasks.empty())
+    {
+      continue;
+    }
+    outTask = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+void TaskPool::workerLoop(size_t workerIndex)
+{
+  isPoolWorker = true;
+  while (true)
+  {
+    std::function<void()> task;
+    if (tryPopOwnTask(workerIndex, task) || tryStealTask(workerIndex, task))
+    {
+      --queuedTaskCount;
+      try
+      {
+        task();
+      }
+      catch (const std::exception& e)
+      {
+        Log(LogLevel::ERROR, "TaskPool: Task failed with exception: {}", e.what());
+      }
+      catch (...)
+      {
+        Log(LogLevel::ERROR, "TaskPool: Task failed with unknown exception.");
+      }
+
+      const std::lock_guard lock{ stateMutex };
+      --pendingTaskCount;
+      if (pendingTaskCount == 0)
+      {
+        allTasksDone.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock lock{ stateMutex };
+    workAvailable.wait(lock, [this]() { return stopping || queuedTaskCount > 0; });
+    if (stopping && queuedTaskCount == 0)
+    {
+      return;
+    }
+  }
+}
+
+void TaskPool::submit(std::function<void()>&& task)
+{
+  {
+    // queued under the state lock, so that waiting workers can not miss the task
+    const std::lock_guard lock{ stateMutex };
+    WorkerQueue& queue{ *queues[nextQueueIndex] };
+    nextQueueIndex = (nextQueueIndex + 1) % queues.size();
+    ++pendingTaskCount;
+    ++queuedTaskCount;
+    {
+      const std::lock_guard queueLock{ queue.mutex };
+      queue.tasks.emplace_back(std::move(task));
+    }
+  }
+  workAvailable.notify_one();
+}
+
+void TaskPool::submitBatch(std::vector<std::function<void()>>&& tasks)
+{
+  for (std::function<void()>& task : tasks)
+  {
+    submit(std::move(task));
+  }
+  tasks.clear();
+}
+
+void TaskPool::waitForAll()
+{
+  std::unique_lock lock{ stateMutex };
+  allTasksDone.wait(lock, [this]() { return pendingTaskCount == 0; });
+}
+
+void TaskPool::runParallel(const size_t count, const std::function<void(size_t)>& task)
+{
+  std::atomic<size_t> next{ 0 };
+  std::atomic<bool> failed{ false };
+  std::exception_ptr error{};
+  const auto work{ [&]()
+    {
+      for (size_t index{ next++ }; index < count && !failed; index = next++)
+      {
+        try
+        {
+          task(index);
+        }
+        catch (...)
+        {
+          if (!failed.exchange(true))
+          {
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+  };
+  const size_t threadCount{ std::min<size_t>(getParallelThreadCount(), count) };
+  {
+    // the team records its phases into the file scope of the calling thread
+    Timings::FileScope* const ownerScope{ Timings::currentFileScope };
+    std::vector<std::jthread> threads{};
+    for (size_t i{ 1 }; i < threadCount; ++i)
+    {
+      threads.emplace_back([&work, ownerScope]()
+        {
+          const Timings::HelperScope helperScope{ ownerScope };
+          work();
+        });
+    }
+    work();
+  }
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+unsigned int TaskPool::getParallelThreadCount()
+{
+  return isPoolWorker ? 1 : std::max(1u, std::thread::hardware_concurrency());
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+/*
+  Simple work stealing thread pool.
+  - Every worker has its own queue and takes tasks from the front of it.
+  - If the own queue is empty, the worker steals from the back of the other queues.
+  - Tasks are distributed round-robin, so tasks submitted first are also started first.
+  Tasks should handle their own errors. Escaping exceptions are logged and dropped.
+
+  runParallel splits the work of a single file operation over a temporary team of threads.
+  Inside a pool task it stays on the calling thread, since the pool already keeps every hardware thread busy.
+*/
+class TaskPool
+{
+private:
+  struct WorkerQueue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex stateMutex;
+  std::condition_variable workAvailable;
+  std::condition_variable allTasksDone;
+  std::atomic<size_t> queuedTaskCount;
+  size_t pendingTaskCount; // queued and running, guarded by stateMutex
+  size_t nextQueueIndex; // guarded by stateMutex
+  bool stopping; // guarded by stateMutex
+
+  bool tryPopOwnTask(size_t workerIndex, std::function<void()>& outTask);
+  bool tryStealTask(size_t workerIndex, std::function<void()>& outTask);
+  void workerLoop(size_t workerIndex);
+public:
+  // a thread count of 0 uses the hardware concurrency
+  explicit TaskPool(unsigned int threadCount = 0);
+  ~TaskPool(); // finishes all queued tasks before returning
+
+  unsigned int getThreadCount() const;
+
+  void submit(std::function<void()>&& task);
+  void submitBatch(std::vector<std::function<void()>>&& tasks);
+  void waitForAll();
+
+  // runs the task for every index below count, the calling thread helps
+  // the first exception is rethrown once all threads are done, indices after it might be skipped
+  static void runParallel(size_t count, const std::function<void(size_t)>& task);
+
+  // number of threads runParallel would use on the calling thread
+  static unsigned int getParallelThreadCount();
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+};
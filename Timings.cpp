@@ -0,0 +1,276 @@
+#include "Timings.h"
+
+#include <fstream>
+#include <format>
+#include <print>
+
+namespace Timings
+{
+  std::string_view getPhaseName(const Phase phase)
+  {
+    switch (phase)
+    {
+    case Phase::FILE_STAT:
+      return "file_stat";
+    case Phase::LOAD:
+      return "load";
+    case Phase::HEADER_VALIDATION:
+      return "header_validation";
+    case Phase::VALIDATION:
+      return "validation";
+    case Phase::CANVAS_ALLOCATION:
+      return "canvas_allocation";
+    case Phase::IMAGE_DECODE:
+      return "image_decode";
+    case Phase::IMAGE_ENCODE:
+      return "image_encode";
+    case Phase::META_WRITE:
+      return "meta_write";
+    case Phase::META_PARSE:
+      return "meta_parse";
+    case Phase::DATA_WRITE:
+      return "data_write";
+    case Phase::PALETTE_WRITE:
+      return "palette_write";
+    case Phase::PNG_WRITE:
+      return "png_write";
+    case Phase::PIXEL_CONVERSION:
+      return "pixel_conversion";
+    case Phase::CANVAS_HASH:
+      return "canvas_hash";
+
+    default:
+      return "unknown";
+    }
+  }
+
+  static void addPhases(PhaseStatsArray& target, const PhaseStatsArray& source)
+  {
+    for (size_t i{ 0 }; i < target.size(); ++i)
+    {
+      target[i].calls += source[i].calls;
+      target[i].nanoseconds += source[i].nanoseconds;
+      target[i].bytes += source[i].bytes;
+    }
+  }
+
+  void TimingRecorder::addFile(const std::string& file, const std::string_view type, const std::chrono::nanoseconds wallTime,
+    const PhaseStatsArray& phases)
+  {
+    const std::lock_guard lock{ mutex };
+    FileRecord& record{ files.try_emplace(file, FileRecord{ .type{ type }, .wallNanoseconds{ 0 }, .phases{} }).first->second };
+    if (type != UNKNOWN_TYPE)
+    {
+      record.type = type;
+    }
+    record.wallNanoseconds += wallTime.count();
+    addPhases(record.phases, phases);
+  }
+
+  static std::string escapeJsonString(const std::string_view str)
+  {
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str)
+    {
+      switch (c)
+      {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\r':
+        result += "\\r";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          result += std::format("\\u{:04x}", static_cast<int>(c));
+        }
+        else
+        {
+          result += c;
+        }
+        break;
+      }
+    }
+    return result;
+  }
+
+  static void writeJsonPhases(std::ostream& out, const PhaseStatsArray& phases, const std::string_view indent)
+  {
+    std::print(out, "{{");
+    bool first{ true };
+    for (size_t i{ 0 }; i < phases.size(); ++i)
+    {
+      const PhaseStats& stats{ phases[i] };
+      if (stats.calls == 0)
+      {
+        continue;
+      }
+      std::print(out, "{}\n{}  \"{}\": {{ \"calls\": {}, \"ns\": {}, \"bytes\": {} }}", first ? "" : ",", indent,
+        getPhaseName(static_cast<Phase>(i)), stats.calls, stats.nanoseconds, stats.bytes);
+      first = false;
+    }
+    std::print(out, "{}}}", first ? "" : std::format("\n{}", indent));
+  }
+
+  void TimingRecorder::writeJson(const std::filesystem::path& file) const
+  {
+    struct TypeRecord
+    {
+      uint64_t files;
+      uint64_t wallNanoseconds;
+      PhaseStatsArray phases;
+    };
+
+    const std::lock_guard lock{ mutex };
+
+    std::map<std::string, TypeRecord, std::less<>> types;
+    TypeRecord total{};
+    for (const auto& [fileName, record] : files)
+    {
+      TypeRecord& typeRecord{ types[record.type] };
+      for (TypeRecord* target : { &typeRecord, &total })
+      {
+        ++target->files;
+        target->wallNanoseconds += record.wallNanoseconds;
+        addPhases(target->phases, record.phases);
+      }
+    }
+
+    if (file.has_parent_path())
+    {
+      std::filesystem::create_directories(file.parent_path());
+    }
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    out.open(file, std::ios::out | std::ios::trunc); // text handling
+
+    std::print(out, "{{\n  \"files\": [");
+    bool first{ true };
+    for (const auto& [fileName, record] : files)
+    {
+      std::print(out, "{}\n    {{\n      \"file\": \"{}\",\n      \"type\": \"{}\",\n      \"wall_ns\": {},\n      \"phases\": ",
+        first ? "" : ",", escapeJsonString(fileName), escapeJsonString(record.type), record.wallNanoseconds);
+      writeJsonPhases(out, record.phases, "      ");
+      std::print(out, "\n    }}");
+      first = false;
+    }
+    std::print(out, "{}],\n  \"types\": {{", first ? "" : "\n  ");
+
+    first = true;
+    for (const auto& [typeName, record] : types)
+    {
+      std::print(out, "{}\n    \"{}\": {{\n      \"files\": {},\n      \"wall_ns\": {},\n      \"phases\": ",
+        first ? "" : ",", escapeJsonString(typeName), record.files, record.wallNanoseconds);
+      writeJsonPhases(out, record.phases, "      ");
+      std::print(out, "\n    }}");
+      first = false;
+    }
+    std::print(out, "{}}},\n  \"total\": {{\n    \"files\": {},\n    \"wall_ns\": {},\n    \"phases\": ",
+      first ? "" : "\n  ", total.files, total.wallNanoseconds);
+    writeJsonPhases(out, total.phases, "    ");
+    std::print(out, "\n  }}\n}}\n");
+  }
+
+  FileScope::FileScope(const std::filesystem::path& file) : recorder{ activeRecorder }, previous{ nullptr }, file{}, type{ UNKNOWN_TYPE },
+    phases{}, start{}
+  {
+    if (!recorder)
+    {
+      return;
+    }
+    this->file = file.string();
+    previous = currentFileScope;
+    currentFileScope = this;
+    start = std::chrono::steady_clock::now();
+  }
+
+  FileScope::~FileScope()
+  {
+    if (!recorder)
+    {
+      return;
+    }
+    currentFileScope = previous;
+    try
+    {
+      recorder->addFile(file, type, std::chrono::steady_clock::now() - start, phases);
+    }
+    catch (...)
+    {
+      // timings are optional and must not end the operation
+    }
+  }
+
+  void FileScope::setType(const std::string_view newType)
+  {
+    const std::lock_guard lock{ mutex };
+    type = newType;
+  }
+
+  void FileScope::record(const Phase phase, const std::chrono::nanoseconds time, const uint64_t bytes)
+  {
+    const std::lock_guard lock{ mutex };
+    PhaseStats& stats{ phases[static_cast<size_t>(phase)] };
+    ++stats.calls;
+    stats.nanoseconds += time.count();
+    stats.bytes += bytes;
+  }
+
+  HelperScope::HelperScope(FileScope* ownerScope) : previous{ currentFileScope }
+  {
+    currentFileScope = ownerScope;
+  }
+
+  HelperScope::~HelperScope()
+  {
+    currentFileScope = previous;
+  }
+
+  void setCurrentType(const std::string_view type)
+  {
+    if (currentFileScope)
+    {
+      currentFileScope->setType(type);
+    }
+  }
+
+  PhaseTimer::PhaseTimer(const Phase phase, const uint64_t bytes) : scope{ currentFileScope }, phase{ phase }, bytes{ bytes }, start{}
+  {
+    if (scope)
+    {
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  PhaseTimer::~PhaseTimer()
+  {
+    stop();
+  }
+
+  void PhaseTimer::addBytes(const uint64_t additionalBytes)
+  {
+    bytes += additionalBytes;
+  }
+
+  void PhaseTimer::stop()
+  {
+    if (!scope)
+    {
+      return;
+    }
+    scope->record(phase, std::chrono::steady_clock::now() - start, bytes);
+    scope = nullptr;
+  }
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/*
+  Optional timing of the phases of the file operations, activated by the timings option of the CLI.
+  The file functions measure their phases with a PhaseTimer. The measurements are collected by the FileScope
+  of the current thread and handed to the active recorder once the file is done.
+  Helper threads of a file join its scope with a HelperScope, TaskPool::runParallel does this for its team.
+  Their phases add the time of every thread, so the phases of a file can sum up to more than its wall time.
+  Without an active recorder or file scope, a PhaseTimer only checks a thread local pointer.
+  The recorder aggregates the phases per file and per type and writes them as JSON.
+*/
+
+namespace Timings
+{
+  enum class Phase : int
+  {
+    FILE_STAT,
+    LOAD,
+    HEADER_VALIDATION,
+    VALIDATION,
+    CANVAS_ALLOCATION,
+    IMAGE_DECODE,
+    IMAGE_ENCODE,
+    META_WRITE,
+    META_PARSE,
+    DATA_WRITE,
+    PALETTE_WRITE,
+    PNG_WRITE,
+    PIXEL_CONVERSION,
+    CANVAS_HASH,
+    COUNT
+  };
+
+  std::string_view getPhaseName(Phase phase);
+
+  // type used until the file functions know the type, and the type of standalone TGX files
+  // GM1 files use the name of their Gm1Type
+  inline constexpr std::string_view UNKNOWN_TYPE{ "UNKNOWN" };
+  inline constexpr std::string_view TGX_FILE_TYPE{ "TGX_FILE" };
+
+  struct PhaseStats
+  {
+    uint64_t calls;
+    uint64_t nanoseconds;
+    uint64_t bytes;
+  };
+
+  using PhaseStatsArray = std::array<PhaseStats, static_cast<size_t>(Phase::COUNT)>;
+
+  // collects the finished files of all threads
+  class TimingRecorder
+  {
+  private:
+    struct FileRecord
+    {
+      std::string type;
+      uint64_t wallNanoseconds;
+      PhaseStatsArray phases;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, FileRecord> files; // a file handled more than once is aggregated into one record
+  public:
+    void addFile(const std::string& file, std::string_view type, std::chrono::nanoseconds wallTime, const PhaseStatsArray& phases);
+
+    // throws if the file can not be written
+    void writeJson(const std::filesystem::path& file) const;
+  };
+
+  // set by the CLI before any work starts and reset after it is done, nullptr disables the timings
+  inline TimingRecorder* activeRecorder{ nullptr };
+
+  // measures the wall time of one file operation on the current thread and collects its phases
+  // nested scopes hide the outer one until they are destroyed
+  class FileScope
+  {
+  private:
+    TimingRecorder* recorder;
+    FileScope* previous;
+    std::string file;
+    std::mutex mutex; // guards type and phases, since helper threads record into the same scope
+    std::string type;
+    PhaseStatsArray phases;
+    std::chrono::steady_clock::time_point start;
+  public:
+    explicit FileScope(const std::filesystem::path& file);
+    ~FileScope();
+
+    FileScope(const FileScope&) = delete;
+    FileScope& operator=(const FileScope&) = delete;
+
+    void setType(std::string_view newType);
+    void record(Phase phase, std::chrono::nanoseconds time, uint64_t bytes);
+  };
+
+  inline thread_local FileScope* currentFileScope{ nullptr };
+
+  // makes the scope of the thread that started the helper the current scope of the helper thread until destroyed
+  // the owner scope has to outlive the helper scope, nullptr leaves the helper without a scope
+  class HelperScope
+  {
+  private:
+    FileScope* previous;
+  public:
+    explicit HelperScope(FileScope* ownerScope);
+    ~HelperScope();
+
+    HelperScope(const HelperScope&) = delete;
+    HelperScope& operator=(const HelperScope&) = delete;
+  };
+
+  // sets the type of the file handled by the current thread, does nothing without a file scope
+  void setCurrentType(std::string_view type);
+
+  // measures from construction until stop or destruction
+  class PhaseTimer
+  {
+  private:
+    FileScope* scope;
+    Phase phase;
+    uint64_t bytes;
+    std::chrono::steady_clock::time_point start;
+  public:
+    explicit PhaseTimer(Phase phase, uint64_t bytes = 0);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void addBytes(uint64_t additionalBytes);
+    void stop();
+  };
+}
@@ -21,6 +21,40 @@ void trimLeadingAndTrailingWhitespaceInPlace(std::string& str)
 
 /* Value from string helper */
 
+int consumeIntegerPrefix(std::string_view& str, int base, bool& outNegative)
+{
+  while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front())))
+  {
+    str.remove_prefix(1);
+  }
+  outNegative = false;
+  if (!str.empty() && (str.front() == '-' || str.front() == '+'))
+  {
+    outNegative = str.front() == '-';
+    str.remove_prefix(1);
+  }
+  const bool hasHexPrefix{ str.size() > 1 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X') };
+  if ((base == 0 || base == 16) && hasHexPrefix)
+  {
+    str.remove_prefix(2);
+    return 16;
+  }
+  if (base == 0)
+  {
+    return str.size() > 1 && str[0] == '0' ? 8 : 10;
+  }
+  return base;
+}
+
+void throwIntegerConversionError(std::errc errorCode)
+{
+  if (errorCode == std::errc::result_out_of_range)
+  {
+    throw std::out_of_range("Value is out of range.");
+  }
+  throw std::invalid_argument("Number does not fill given string.");
+}
+
 bool boolFromStr(const std::string& str)
 {
   if (str == "true" || str == "1")
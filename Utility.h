@@ -1,15 +1,36 @@
 #pragma once
 
 #include <stdint.h>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <string>
+#include <string_view>
 #include <stdexcept>
+#include <limits>
+#include <charconv>
+#include <system_error>
 
 /* Smart ptr of object with additional memory */
 
+// objects with the default alignment use malloc, so their additional memory can be resized in place by realloc
+
 template<typename T>
 struct ObjectWithAdditionalMemoryDeleter
 {
+  static void deallocate(void* p)
+  {
+    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+      ::operator delete(p, std::align_val_t{ alignof(T) });
+    }
+    else
+    {
+      std::free(p);
+    }
+  }
+
   void operator()(T* p) const
   {
     try
@@ -18,24 +39,10 @@ struct ObjectWithAdditionalMemoryDeleter
     }
     catch (...)
     {
-      if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
-      {
-        ::operator delete(p, std::align_val_t{ alignof(T) });
-      }
-      else
-      {
-        ::operator delete(p);
-      }
+      deallocate(p);
       throw;
     }
-    if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
-    {
-      ::operator delete(p, std::align_val_t{ alignof(T) });
-    }
-    else
-    {
-      ::operator delete(p);
-    }
+    deallocate(p);
   };
 };
 
@@ -49,7 +56,11 @@ std::unique_ptr<T, ObjectWithAdditionalMemoryDeleter<T>> createWithAdditionalMem
   }
   else
   {
-    data = ::operator new(sizeof(T) + additionalBytes);
+    data = std::malloc(sizeof(T) + additionalBytes);
+    if (!data)
+    {
+      throw std::bad_alloc{};
+    }
   }
   try
   {
@@ -57,11 +68,26 @@ std::unique_ptr<T, ObjectWithAdditionalMemoryDeleter<T>> createWithAdditionalMem
   }
   catch (...)
   {
-    ::operator delete(data);
+    ObjectWithAdditionalMemoryDeleter<T>::deallocate(data);
     throw;
   }
 }
 
+// grows or shrinks the additional memory, keeping the object and the additional bytes up to the smaller size
+// the object is moved bytewise, so pointers into its own memory have to be set again afterwards
+template<typename T>
+void resizeAdditionalMemory(std::unique_ptr<T, ObjectWithAdditionalMemoryDeleter<T>>& object, size_t additionalBytes)
+{
+  static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+  void* data{ std::realloc(object.get(), sizeof(T) + additionalBytes) };
+  if (!data)
+  {
+    throw std::bad_alloc{};
+  }
+  static_cast<void>(object.release());
+  object.reset(static_cast<T*>(data));
+}
+
 /* String helpers */
 
 void trimLeadingWhitespaceInPlace(std::string& str);
@@ -70,38 +96,102 @@ void trimLeadingAndTrailingWhitespaceInPlace(std::string& str);
 
 /* Value from String helper */
 
+// Consumes leading whitespace, the sign and the base prefix like "strtoll" would do.
+// Returns the base to use for the remaining digits. Base 0 auto-detects "0x" as hex and a leading "0" as octal.
+int consumeIntegerPrefix(std::string_view& str, int base, bool& outNegative);
+
+// throws the exception fitting to the error code of a failed conversion
+[[noreturn]] void throwIntegerConversionError(std::errc errorCode);
+
+// non-throwing versions, return std::errc{} on success and only touch the out value in this case
+
 template<typename Int = int, int base = 0, // auto-detect base by default
   Int min = std::numeric_limits<Int>::min(), Int max = std::numeric_limits<Int>::max()>
-Int intFromStr(const std::string& str)
+std::errc tryIntFromStr(std::string_view str, Int& outValue)
 {
-  size_t countOfUsedChars{ 0 };
-  const long long result{ std::stoll(str, &countOfUsedChars, base) };
-  if (countOfUsedChars != str.size())
+  bool negative{ false };
+  const int usedBase{ consumeIntegerPrefix(str, base, negative) };
+  unsigned long long magnitude{ 0 };
+  const char* const strEnd{ str.data() + str.size() };
+  const auto [end, errorCode] { std::from_chars(str.data(), strEnd, magnitude, usedBase) };
+  if (errorCode != std::errc{})
+  {
+    return errorCode;
+  }
+  if (end != strEnd)
+  {
+    return std::errc::invalid_argument;
+  }
+  constexpr unsigned long long maxMagnitudePositive{ static_cast<unsigned long long>(std::numeric_limits<long long>::max()) };
+  if (magnitude > maxMagnitudePositive + (negative ? 1 : 0))
   {
-    throw std::invalid_argument("Number does not fill given string.");
+    return std::errc::result_out_of_range;
   }
+  // negate in unsigned space, so that the minimum value is handled
+  const long long result{ negative ? static_cast<long long>(0ull - magnitude) : static_cast<long long>(magnitude) };
   if (result > max || result < min)
   {
-    throw std::out_of_range("Value is out of range.");
+    return std::errc::result_out_of_range;
   }
-  return static_cast<Int>(result);
+  outValue = static_cast<Int>(result);
+  return std::errc{};
 }
 
 template<typename UInt = unsigned int, int base = 0, // auto-detect base by default
   UInt min = std::numeric_limits<UInt>::min(), UInt max = std::numeric_limits<UInt>::max()>
-UInt uintFromStr(const std::string& str)
+std::errc tryUintFromStr(std::string_view str, UInt& outValue)
 {
-  size_t countOfUsedChars{ 0 };
-  const unsigned long long result{ std::stoull(str, &countOfUsedChars, base) };
-  if (countOfUsedChars != str.size())
+  bool negative{ false };
+  const int usedBase{ consumeIntegerPrefix(str, base, negative) };
+  unsigned long long result{ 0 };
+  const char* const strEnd{ str.data() + str.size() };
+  const auto [end, errorCode] { std::from_chars(str.data(), strEnd, result, usedBase) };
+  if (errorCode != std::errc{})
   {
-    throw std::invalid_argument("Number does not fill given string.");
+    return errorCode;
+  }
+  if (end != strEnd)
+  {
+    return std::errc::invalid_argument;
+  }
+  if (negative && result != 0)
+  {
+    return std::errc::result_out_of_range; // unlike "stoull", negative values do not wrap around
   }
   if (result > max || result < min)
   {
-    throw std::out_of_range("Value is out of range.");
+    return std::errc::result_out_of_range;
+  }
+  outValue = static_cast<UInt>(result);
+  return std::errc{};
+}
+
+// throwing versions
+
+template<typename Int = int, int base = 0, // auto-detect base by default
+  Int min = std::numeric_limits<Int>::min(), Int max = std::numeric_limits<Int>::max()>
+Int intFromStr(std::string_view str)
+{
+  Int result{};
+  const std::errc errorCode{ tryIntFromStr<Int, base, min, max>(str, result) };
+  if (errorCode != std::errc{})
+  {
+    throwIntegerConversionError(errorCode);
+  }
+  return result;
+}
+
+template<typename UInt = unsigned int, int base = 0, // auto-detect base by default
+  UInt min = std::numeric_limits<UInt>::min(), UInt max = std::numeric_limits<UInt>::max()>
+UInt uintFromStr(std::string_view str)
+{
+  UInt result{};
+  const std::errc errorCode{ tryUintFromStr<UInt, base, min, max>(str, result) };
+  if (errorCode != std::errc{})
+  {
+    throwIntegerConversionError(errorCode);
   }
-  return static_cast<UInt>(result);
+  return result;
 }
 
 bool boolFromStr(const std::string& str);